@@ -56,9 +56,10 @@ int main(int argc, char *argv[]) {
 
   // read parameters (No Looper class used for omega, since it is no attribute of the class)
   
-  pt::ptree root;
-  pt::read_json(parameter_file, root);
-  
+  // the input file is parsed once and shared by all threads
+  Configuration configuration(parameter_file);
+  const pt::ptree &root = configuration.get_root();
+
   double start;              // starting value
   double end;                // end value
   int number_of_steps;       // number of steps
@@ -118,7 +119,7 @@ int main(int argc, char *argv[]) {
   {
 
     // define needed quantities
-    auto polarizability = std::make_shared<Polarizability>(parameter_file);
+    auto polarizability = std::make_shared<Polarizability>(configuration);
     double omega_a = polarizability->get_omega_a();
     double alpha_zero = polarizability->get_alpha_zero();
     // Parallelize the for-loop of the given looper
@@ -136,9 +137,10 @@ int main(int argc, char *argv[]) {
 	    cx_mat::fixed<3, 3> inv_alpha;
 	    cx_mat::fixed<3, 3> inv_alpha_dag;
 
-	    // calculate alpha
-	    polarizability->calculate_tensor(steps[i], alphaI, IM);
-	    polarizability->calculate_tensor(steps[i], alphaR, RE);
+	    // calculate alpha, both parts are derived from one evaluation
+	    EvaluationContext context(steps[i]);
+	    polarizability->calculate_tensor(context, alphaI, IM);
+	    polarizability->calculate_tensor(context, alphaR, RE);
 
 	    inv_alpha     = inv(alphaR + I * alphaI);
 	    inv_alpha_dag = inv(alphaR - I * alphaI);
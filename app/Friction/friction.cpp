@@ -1,22 +1,21 @@
 #include <iostream>
 #include <omp.h>
+#include <sstream>
 
 // program options
 #include <boost/program_options.hpp>
 namespace po = boost::program_options;
 
-// json parser
-#include <boost/property_tree/json_parser.hpp>
-#include <boost/property_tree/ptree.hpp>
-namespace pt = boost::property_tree;
-
 #include "ProgressBar.hpp"
 #include "Quaca.h"
+#include "ResultWriter.hpp"
 
 // parameters that are parsed from the command line
 std::string parameter_file;
 std::string output_file;
 int num_threads = 1;
+bool diagnostics = false;
+std::string on_failure;
 
 // reads the input file and number of threads from the command line
 // uses boost program options
@@ -28,7 +27,12 @@ void read_command_line(int argc, char *argv[]) {
     desc.add_options()("help,h", "Help screen")(
         "file", po::value<std::string>(&(parameter_file)), "Input File")(
         "threads", po::value<int>(&(num_threads))->default_value(1),
-        "Number of parallel threads");
+        "Number of parallel threads")(
+        "diagnostics", po::bool_switch(&(diagnostics)),
+        "Write integration diagnostics as additional columns")(
+        "on-failure",
+        po::value<std::string>(&(on_failure))->default_value("abort"),
+        "Handling of failed integrations (abort or escalate)");
 
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -54,12 +58,27 @@ int main(int argc, char *argv[]) {
   // get command line options
   read_command_line(argc, argv);
 
-  // define looper
-  auto looper = LooperFactory::create(parameter_file);
+  // failed integrations either abort the program or are escalated, where
+  // the number of failures is written as an additional column
+  set_integration_failure_policy(failure_option(on_failure));
+  bool failures = get_integration_failure_policy() == ESCALATE;
+
+  // the input file is parsed once and shared by all threads
+  Configuration configuration(parameter_file);
+
+  // cached reflection coefficients are built once and handed to all models
+  // constructed from the configuration, such that all threads share the cache
+  std::shared_ptr<ReflectionCoefficientsCached> reflection_cache;
+  if (configuration.get_root().get_child_optional(
+          "ReflectionCoefficients.cached")) {
+    reflection_cache = std::dynamic_pointer_cast<ReflectionCoefficientsCached>(
+        ReflectionCoefficientsFactory::create(configuration));
+    configuration =
+        configuration.with_reflection_coefficients(reflection_cache);
+  }
 
-  // array to store all the computed values of the loop
-  std::vector<double> friction_data;
-  friction_data.resize(looper->get_steps_total());
+  // define looper
+  auto looper = LooperFactory::create(configuration);
 
   // define progressbar
   ProgressBar progbar(looper->get_steps_total(), 70);
@@ -73,8 +92,6 @@ int main(int argc, char *argv[]) {
   }
 
   // Create a parallel region given threads given by the --threads flag
-  // we have to create the parallel region already here to ensure,
-  // that any thread creates their own instance of quantum_friction
   std::cout << "Starting parallel region with " << num_threads
             << " threads." << std::endl;
   if (num_threads > omp_get_max_threads()) {
@@ -84,57 +101,102 @@ int main(int argc, char *argv[]) {
     std::cout << "Aborting calculation" << std::endl;
     exit(0);
   }
-#pragma omp parallel num_threads(num_threads)
-  {
-
-    // Create a root
-    pt::ptree root;
 
-    // Load the json file in this ptree
-    pt::read_json(parameter_file, root);
+  // Loopers over the velocity, the distance or the temperature pass their
+  // parameter to the evaluation and leave the friction object unchanged,
+  // hence all threads share a single one together with its caches
+  std::shared_ptr<Friction> shared_friction;
+  if (!looper->changes_friction()) {
+    shared_friction = std::make_shared<Friction>(configuration);
+  }
 
-    double relerr_omega = root.get<double>("Friction.relerr_omega");
+  // the results are appended to the output file as they are finished and
+  // sorted by their step once the loop is done
+  ResultWriter writer(output_file, looper->get_steps_total());
 
-    // define needed quantities
-    auto polarizability = std::make_shared<Polarizability>(parameter_file);
-    auto powerspectrum = std::make_shared<PowerSpectrum>(
-        polarizability->get_greens_tensor(), polarizability);
-    auto quant_friction =
-        std::make_shared<Friction>(polarizability->get_greens_tensor(),
-                                   polarizability, powerspectrum, relerr_omega);
+#pragma omp parallel num_threads(num_threads)
+  {
+    std::shared_ptr<Friction> quant_friction = shared_friction;
+    if (!quant_friction) {
+      // loopers over the particle change the polarizability, hence every
+      // thread has its own instance
+      quant_friction = std::make_shared<Friction>(configuration);
+    }
 
-    // Parallelize the for-loop of the given looper
+    // Parallelize the for-loop of the given looper, every thread calculates
+    // whole batches of consecutive steps
 #pragma omp critical
     progbar.display();
 
 #pragma omp for schedule(dynamic)
-    for (int i = 0; i < looper->get_steps_total(); i++) {
-      friction_data[i] = looper->calculate_value(i, quant_friction);
-#pragma omp critical
-      {
-          // define output file
-          std::ofstream file;
-          file.open(output_file);
-
-          // write results in output file
-          for(int j = 0; j < looper->get_steps_total(); j++) {
-            double step = looper->get_step(j);
-            file << step << "," << friction_data[j] << "\n";
-          }
-          // close file
-          file.close();
+    for (int b = 0; b < looper->get_batches_total(); b++) {
+      vec friction;
+      IntegrationDiagnostics batch_diagnostics;
+      if (diagnostics || failures) {
+        IntegrationDiagnosticsScope scope(batch_diagnostics);
+        friction = looper->calculate_batch(b, quant_friction);
+      } else {
+        friction = looper->calculate_batch(b, quant_friction);
       }
 
+      for (uword j = 0; j < friction.n_elem; j++) {
+        int i = looper->get_batch_first(b) + j;
+
+        // the diagnostics of a batch are attributed to its first step
+        IntegrationDiagnostics step_diagnostics;
+        if (j == 0) {
+          step_diagnostics = batch_diagnostics;
+        }
+
+        // the line of output is handed to the writer thread, which appends
+        // it to the output file
+        std::ostringstream line;
+        line << looper->get_step(i) << "," << friction(j);
+        // the diagnostics are appended as number of integrand evaluations,
+        // number of subintervals and the absolute and relative error
+        // estimate of the omega integration
+        if (diagnostics) {
+          line << "," << step_diagnostics.evaluations << ","
+               << step_diagnostics.intervals << "," << step_diagnostics.abserr
+               << "," << step_diagnostics.relerr();
+        }
+        // number of integrations that missed their accuracy even after the
+        // escalation
+        if (failures) {
+          line << "," << step_diagnostics.failures;
+        }
+        writer.push(i, line.str());
+
 #pragma omp critical
-      ++progbar;
+        ++progbar;
+      }
 #pragma omp critical
       progbar.display();
     }
   }
 
 
+  // write the sorted output file
+  writer.close();
+
   // close progress bar
   progbar.done();
 
+  if (reflection_cache) {
+    std::cout << "Reflection coefficient cache: "
+              << reflection_cache->get_hits() << " hits, "
+              << reflection_cache->get_misses() << " misses (hit rate "
+              << reflection_cache->get_hit_rate() << ")" << std::endl;
+  }
+
+  // loopers over the particle share the integrals of the Green's tensor
+  auto particle_looper = std::dynamic_pointer_cast<LooperParticle>(looper);
+  if (particle_looper) {
+    auto record = particle_looper->get_greens_record();
+    std::cout << "Green's tensor record: " << record->get_hits() << " hits, "
+              << record->get_misses() << " misses (hit rate "
+              << record->get_hit_rate() << ")" << std::endl;
+  }
+
   return 0;
 }
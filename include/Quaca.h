@@ -1,16 +1,29 @@
 #ifndef QUACA_H
 #define QUACA_H
 
+#include "../src/Calculations/CharacteristicFrequency.h"
 #include "../src/Calculations/Integrations.h"
+#include "../src/Calculations/IntegrationsVector.h"
+#include "../src/Calculations/IntegrationsCubature.h"
+#include "../src/Calculations/IntegrationsLaguerre.h"
+
+#include "../src/Configuration/Configuration.h"
 
 #include "../src/GreensTensor/GreensTensor.h"
 #include "../src/GreensTensor/GreensTensorFactory.h"
 #include "../src/GreensTensor/GreensTensorPlate.h"
 #include "../src/GreensTensor/GreensTensorPlateVacuum.h"
+#include "../src/GreensTensor/GreensTensorRecord.h"
 #include "../src/GreensTensor/GreensTensorVacuum.h"
 
 #include "../src/Looper/Looper.h"
+#include "../src/Looper/LooperAlphaZero.h"
+#include "../src/Looper/LooperBatch.h"
+#include "../src/Looper/LooperBeta.h"
 #include "../src/Looper/LooperFactory.h"
+#include "../src/Looper/LooperGamma.h"
+#include "../src/Looper/LooperOmegaA.h"
+#include "../src/Looper/LooperParticle.h"
 #include "../src/Looper/LooperV.h"
 #include "../src/Looper/LooperZa.h"
 
@@ -23,6 +36,7 @@
 #include "../src/Permittivity/PermittivityFactory.h"
 #include "../src/Permittivity/PermittivityLorentz.h"
 
+#include "../src/Polarizability/EvaluationContext.h"
 #include "../src/Polarizability/Polarizability.h"
 
 #include "../src/PowerSpectrum/PowerSpectrum.h"
@@ -30,8 +44,10 @@
 #include "../src/Friction/Friction.h"
 
 #include "../src/ReflectionCoefficients/ReflectionCoefficients.h"
+#include "../src/ReflectionCoefficients/ReflectionCoefficientsCached.h"
 #include "../src/ReflectionCoefficients/ReflectionCoefficientsFactory.h"
 #include "../src/ReflectionCoefficients/ReflectionCoefficientsLocBulk.h"
 #include "../src/ReflectionCoefficients/ReflectionCoefficientsLocSlab.h"
+#include "../src/ReflectionCoefficients/ReflectionCoefficientsTabulated.h"
 
 #endif //QUACA_H
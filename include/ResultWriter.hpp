@@ -0,0 +1,158 @@
+#ifndef RESULTWRITER_HPP
+#define RESULTWRITER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+//! Streaming writer of the results of a loop
+/*!
+ * The threads of a loop hand every finished line of output to push, which
+ * stores it in a lock-free queue and returns immediately. A writer thread
+ * appends the lines to the output file in the order in which they are
+ * finished and flushes the file regularly, such that the threads never wait
+ * for the disk and an interrupted calculation keeps all finished steps. On
+ * close the lines are written sorted by their step to a temporary file, which
+ * then replaces the output file.
+ */
+class ResultWriter {
+private:
+  // a finished line of output and the step it belongs to
+  struct Record {
+    size_t index;
+    std::string line;
+  };
+
+  // The queue has one slot per step. A thread claims the next free slot by an
+  // atomic increment of tail and publishes the record by setting the flag of
+  // the slot, the writer thread consumes the slots in the order of their
+  // claims.
+  std::vector<Record> slots;
+  std::unique_ptr<std::atomic<bool>[]> ready;
+  std::atomic<size_t> tail{0};
+  std::atomic<bool> closing{false};
+
+  std::string output_file;
+  std::ofstream file;
+  std::chrono::milliseconds flush_interval;
+  std::thread writer;
+
+  // appends all published records, returns when closing is set and every
+  // record is written, and finally writes the sorted file
+  void run() {
+    size_t head = 0;
+    auto last_flush = std::chrono::steady_clock::now();
+    // lines written since the last flush, which are flushed once the flush
+    // interval has elapsed, even if no further line arrives
+    bool unflushed = false;
+    while (true) {
+      // records pushed before close are published before closing is set
+      bool closed = closing.load(std::memory_order_acquire);
+
+      bool written = false;
+      while (head < slots.size() &&
+             ready[head].load(std::memory_order_acquire)) {
+        file << slots[head].line << "\n";
+        head++;
+        written = true;
+        unflushed = true;
+      }
+
+      auto now = std::chrono::steady_clock::now();
+      if (unflushed && now - last_flush >= flush_interval) {
+        file.flush();
+        last_flush = now;
+        unflushed = false;
+      }
+
+      if (closed) {
+        break;
+      }
+      if (!written) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    }
+    file.close();
+
+    // write the sorted file next to the output file and move it into place,
+    // such that the output file is never truncated
+    std::vector<const Record *> sorted;
+    for (size_t i = 0; i < head; i++) {
+      sorted.push_back(&slots[i]);
+    }
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Record *a, const Record *b) {
+                return a->index < b->index;
+              });
+
+    std::string sorted_file = output_file + ".tmp";
+    std::ofstream out(sorted_file);
+    for (const Record *record : sorted) {
+      out << record->line << "\n";
+    }
+    out.close();
+    if (!out || std::rename(sorted_file.c_str(), output_file.c_str()) != 0) {
+      std::cerr << "Error: Could not write the sorted output file ("
+                << output_file << ")!" << std::endl;
+    }
+  }
+
+public:
+  // starts the writer thread for a loop with the given number of steps, the
+  // output file is flushed at most once per flush interval
+  ResultWriter(const std::string &output_file, size_t steps,
+               std::chrono::milliseconds flush_interval =
+                   std::chrono::milliseconds(1000))
+      : slots(steps), ready(new std::atomic<bool>[steps]),
+        output_file(output_file), flush_interval(flush_interval) {
+    for (size_t i = 0; i < steps; i++) {
+      ready[i].store(false, std::memory_order_relaxed);
+    }
+
+    file.open(output_file);
+    if (!file.is_open()) {
+      std::cerr << "Error: Could not open output file (" << output_file
+                << ")!" << std::endl;
+      exit(0);
+    }
+    writer = std::thread(&ResultWriter::run, this);
+  }
+
+  ResultWriter(const ResultWriter &) = delete;
+  ResultWriter &operator=(const ResultWriter &) = delete;
+
+  ~ResultWriter() { close(); }
+
+  // hands the line of output of the step with the given index to the writer
+  // thread, can be called by all threads at the same time
+  void push(size_t index, std::string line) {
+    size_t slot = tail.fetch_add(1, std::memory_order_relaxed);
+    if (slot >= slots.size()) {
+      std::cerr << "Error: More results than steps (" << slots.size()
+                << ")!" << std::endl;
+      exit(0);
+    }
+    slots[slot] = {index, std::move(line)};
+    ready[slot].store(true, std::memory_order_release);
+  }
+
+  // writes the remaining lines and the sorted output file, must be called
+  // after all calls of push have returned
+  void close() {
+    if (writer.joinable()) {
+      closing.store(true, std::memory_order_release);
+      writer.join();
+    }
+  }
+};
+
+#endif // RESULTWRITER_HPP
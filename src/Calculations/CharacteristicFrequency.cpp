@@ -0,0 +1,18 @@
+#include "CharacteristicFrequency.h"
+
+void append_breakpoints(const std::vector<CharacteristicFrequency> &frequencies,
+                        double omega_min, double omega_max,
+                        std::vector<double> &points) {
+  for (const CharacteristicFrequency &frequency : frequencies) {
+    std::vector<double> candidates = {frequency.omega};
+    if (frequency.width > 0) {
+      candidates = {frequency.omega - frequency.width,
+                    frequency.omega + frequency.width};
+    }
+    for (double omega : candidates) {
+      if (omega > omega_min && omega < omega_max) {
+        points.push_back(omega);
+      }
+    }
+  }
+}
@@ -0,0 +1,25 @@
+#ifndef CHARACTERISTICFREQUENCY_H
+#define CHARACTERISTICFREQUENCY_H
+
+#include <vector>
+
+//! A characteristic frequency of an integrand over omega
+/*!
+ * A characteristic frequency marks a feature of a response function, e.g. a
+ * resonance at omega with the half-width width. Integrations over omega are
+ * split at omega - width and omega + width, such that the feature is resolved
+ * by a piece of its own instead of by adaptive bisection. A feature without
+ * width, e.g. a kink, is split at omega only.
+ */
+struct CharacteristicFrequency {
+  double omega; // center of the feature
+  double width; // half-width of the feature
+};
+
+// appends the breakpoints of the characteristic frequencies, which lie
+// strictly between omega_min and omega_max, to points
+void append_breakpoints(const std::vector<CharacteristicFrequency> &frequencies,
+                        double omega_min, double omega_max,
+                        std::vector<double> &points);
+
+#endif // CHARACTERISTICFREQUENCY_H
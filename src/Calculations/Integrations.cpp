@@ -1,101 +1,479 @@
 #include "Integrations.h"
 
+#include <atomic>
+#include <limits>
+#include <utility>
+#include <vector>
+
 #include <gsl/gsl_errno.h>
 #include <gsl/gsl_integration.h>
 
-// wrapper to cquad routine
-double cquad(const std::function<double(double)> &f, double a, double b,
-             double relerr, double epsabs) {
+namespace {
 
-  // cast given lambda to static (!) gsl_function
-  gsl_function_pp<decltype(f)> Fp(f);
-  auto *F = static_cast<gsl_function *>(&Fp);
+// number of GSL workspaces allocated by the calling thread
+thread_local size_t workspace_allocations = 0;
 
-  double res;
-  /* Initialize the workspace. */
-  gsl_integration_cquad_workspace *ws =
-      gsl_integration_cquad_workspace_alloc(100);
-  if (ws == nullptr) {
-    printf("call to gsl_integration_cquad_workspace_alloc failed.\n");
-    abort();
+// number of integration routines the calling thread is currently inside
+thread_local size_t integration_depth = 0;
+
+// diagnostics scopes of the calling thread together with the integration depth
+// at which they were opened
+thread_local std::vector<std::pair<IntegrationDiagnostics *, size_t>>
+    diagnostics_scopes;
+
+// allocation and deallocation of the different GSL workspace types
+gsl_integration_cquad_workspace *workspace_alloc_cquad(size_t size) {
+  return gsl_integration_cquad_workspace_alloc(size);
+}
+void workspace_free(gsl_integration_cquad_workspace *ws) {
+  gsl_integration_cquad_workspace_free(ws);
+}
+gsl_integration_workspace *workspace_alloc_qag(size_t size) {
+  return gsl_integration_workspace_alloc(size);
+}
+void workspace_free(gsl_integration_workspace *ws) {
+  gsl_integration_workspace_free(ws);
+}
+
+//! A per-thread pool of GSL workspaces of one type
+/*!
+ * The integration routines are nested (e.g. the kappa integral is performed
+ * inside the phi integrand of GreensTensorPlate::integrate_k), hence one
+ * thread needs one workspace per nesting level. The pool keeps a stack of
+ * workspaces, hands out the one belonging to the current nesting level and
+ * only allocates if a level is entered for the first time or a larger
+ * workspace is requested. All workspaces are released at thread exit.
+ */
+template <typename Workspace> class WorkspacePool {
+private:
+  // workspaces together with the size they were allocated with
+  std::vector<std::pair<Workspace *, size_t>> workspaces;
+  // current nesting level
+  size_t depth = 0;
+  // function allocating a workspace of the given size
+  Workspace *(*alloc)(size_t);
+
+public:
+  explicit WorkspacePool(Workspace *(*alloc)(size_t)) : alloc(alloc) {}
+
+  WorkspacePool(const WorkspacePool &) = delete;
+  WorkspacePool &operator=(const WorkspacePool &) = delete;
+
+  ~WorkspacePool() {
+    for (auto &ws : workspaces) {
+      workspace_free(ws.first);
+    }
   }
 
-  /* Call the integrator. */
-  /* set nevals and abserr pointer to nullptr, we are only interested in result
-   */
-  int success = gsl_integration_cquad(F, a, b, epsabs, relerr, ws, &res,
-                                      nullptr, nullptr);
-  if (success != 0) {
-    printf("cquad error: %s\n", gsl_strerror(success));
-    abort();
+  // returns a workspace of at least the given size for the current level
+  Workspace *acquire(size_t size) {
+    if (depth == workspaces.size()) {
+      workspaces.emplace_back(nullptr, 0);
+    }
+    auto &ws = workspaces[depth];
+    if (ws.second < size) {
+      if (ws.first != nullptr) {
+        workspace_free(ws.first);
+      }
+      ws.first = alloc(size);
+      if (ws.first == nullptr) {
+        printf("call to the allocation of a gsl workspace failed.\n");
+        abort();
+      }
+      ws.second = size;
+      ++workspace_allocations;
+    }
+    ++depth;
+    return ws.first;
   }
 
-  /* Free the workspace. */
-  gsl_integration_cquad_workspace_free(ws);
+  // hands the workspace of the current level back to the pool
+  void release() { --depth; }
+};
 
-  return res;
+// returns the pool of the calling thread, which is destroyed at thread exit
+WorkspacePool<gsl_integration_cquad_workspace> &cquad_pool() {
+  thread_local WorkspacePool<gsl_integration_cquad_workspace> pool(
+      &workspace_alloc_cquad);
+  return pool;
+}
+WorkspacePool<gsl_integration_workspace> &qag_pool() {
+  thread_local WorkspacePool<gsl_integration_workspace> pool(
+      &workspace_alloc_qag);
+  return pool;
 }
 
-double qags(const std::function<double(double)> &f, double a, double b,
-            double relerr, double epsabs) {
+// Scoped access to a pooled workspace, such that the workspace is given back
+// even if the integrand throws
+template <typename Workspace> class WorkspaceLease {
+private:
+  WorkspacePool<Workspace> &pool;
+  Workspace *ws;
 
-  // cast given lambda to static (!) gsl_function
-  gsl_function_pp<decltype(f)> Fp(f);
-  auto *F = static_cast<gsl_function *>(&Fp);
+public:
+  WorkspaceLease(WorkspacePool<Workspace> &pool, size_t size)
+      : pool(pool), ws(pool.acquire(size)) {}
+  ~WorkspaceLease() { pool.release(); }
 
-  double res;
-  double abserr;
+  WorkspaceLease(const WorkspaceLease &) = delete;
+  WorkspaceLease &operator=(const WorkspaceLease &) = delete;
 
-  /* Initialize the workspace. */
-  gsl_integration_workspace *ws = gsl_integration_workspace_alloc(1000);
-  if (ws == nullptr) {
-    printf("call to gsl_integration_workspace_alloc failed.\n");
-    abort();
+  Workspace *get() const { return ws; }
+};
+
+} // namespace
+
+namespace {
+
+// policy applied to failed integrations, shared by all threads
+std::atomic<Failure_Options> failure_policy(ABORT);
+
+// gsl error handler that was active before it was switched off
+gsl_error_handler_t *gsl_handler = nullptr;
+
+// factors by which the workspace and the tolerances are increased when a
+// failed integration is repeated
+const size_t escalation_workspace = 10;
+const double escalation_tolerance = 10;
+
+//! Outcome of one call of a gsl integration routine
+struct Attempt {
+  int status;         // gsl status code
+  double result;      // estimate of the integral
+  double abserr;      // absolute error estimate
+  size_t evaluations; // number of integrand evaluations
+  size_t intervals;   // number of subintervals
+};
+
+// size of the cquad workspaces held by the pool
+const size_t cquad_size = 100;
+
+Attempt run_cquad(const gsl_function *F, double a, double b, double relerr,
+                  double epsabs, size_t size) {
+  Attempt attempt;
+  /* Get the workspace of this thread and nesting level. */
+  WorkspaceLease<gsl_integration_cquad_workspace> ws(cquad_pool(), cquad_size);
+  IntegrationNesting nesting;
+
+  /* cquad subdivides as long as the workspace has room, hence a larger
+   * workspace is allocated separately to keep the pooled ones unchanged */
+  gsl_integration_cquad_workspace *escalated = nullptr;
+  if (size > cquad_size) {
+    escalated = gsl_integration_cquad_workspace_alloc(size);
   }
 
   /* Call the integrator. */
-  /* set nevals and abserr pointer to nullptr, we are only interested in result
+  attempt.status = gsl_integration_cquad(
+      F, a, b, epsabs, relerr, escalated != nullptr ? escalated : ws.get(),
+      &attempt.result, &attempt.abserr, &attempt.evaluations);
+
+  if (escalated != nullptr) {
+    gsl_integration_cquad_workspace_free(escalated);
+  }
+
+  /* cquad does not expose its subdivision, hence only one interval is counted
    */
-  int success =
-      gsl_integration_qags(F, a, b, epsabs, relerr, 1000, ws, &res, &abserr);
-  if (success != 0) {
-    printf("qags error: %s\n", gsl_strerror(success));
+  attempt.intervals = 1;
+  return attempt;
+}
+
+Attempt run_qags(const gsl_function *F, double a, double b, double relerr,
+                 double epsabs, size_t limit) {
+  Attempt attempt;
+  /* Get the workspace of this thread and nesting level. */
+  WorkspaceLease<gsl_integration_workspace> ws(qag_pool(), limit);
+  IntegrationNesting nesting;
+
+  /* Call the integrator. */
+  attempt.status = gsl_integration_qags(F, a, b, epsabs, relerr, limit,
+                                        ws.get(), &attempt.result,
+                                        &attempt.abserr);
+
+  /* qags applies the 21-point Gauss-Kronrod rule to the initial interval and
+   * to both halves of every bisected interval */
+  attempt.intervals = ws.get()->size;
+  attempt.evaluations = 21 * (2 * attempt.intervals - 1);
+  return attempt;
+}
+
+Attempt run_qagiu(gsl_function *F, double a, double relerr, double epsabs,
+                  size_t limit) {
+  Attempt attempt;
+  /* Get the workspace of this thread and nesting level. */
+  WorkspaceLease<gsl_integration_workspace> ws(qag_pool(), limit);
+  IntegrationNesting nesting;
+
+  /* Call the integrator. */
+  attempt.status =
+      gsl_integration_qagiu(F, a, epsabs, relerr, limit, ws.get(),
+                            &attempt.result, &attempt.abserr);
+
+  /* qagiu applies the 15-point Gauss-Kronrod rule to the transformed
+   * integrand */
+  attempt.intervals = ws.get()->size;
+  attempt.evaluations = 15 * (2 * attempt.intervals - 1);
+  return attempt;
+}
+
+// Applies the failure policy to the first attempt of an integration. With
+// ESCALATE the integration is first repeated by retry with a larger workspace
+// and relaxed tolerances, then by fallback with an alternate rule. If all
+// attempts fail, the attempt with the smallest error estimate is returned and
+// failed is set.
+template <typename Retry, typename Fallback>
+Attempt escalate(const char *name, Attempt attempt, const Retry &retry,
+                 const Fallback &fallback, bool &failed) {
+  failed = false;
+  if (attempt.status == 0) {
+    return attempt;
+  }
+  if (failure_policy == ABORT) {
+    printf("%s error: %s\n", name, gsl_strerror(attempt.status));
     abort();
   }
 
-  /* Free the workspace. */
-  gsl_integration_workspace_free(ws);
+  // keep the best estimate and count the evaluations of all attempts
+  Attempt best = attempt;
+  size_t evaluations = attempt.evaluations;
+  auto consider = [&](const Attempt &next) -> bool {
+    evaluations += next.evaluations;
+    if (next.status == 0 || !std::isfinite(best.result) ||
+        (std::isfinite(next.result) && next.abserr < best.abserr)) {
+      best = next;
+    }
+    return next.status == 0;
+  };
 
-  return res;
+  if (!consider(retry()) && !consider(fallback())) {
+    failed = true;
+  }
+  best.evaluations = evaluations;
+  return best;
+}
+
+} // namespace
+
+// wrapper to cquad routine
+double cquad_gsl(const gsl_function *F, double a, double b, double relerr,
+                 double epsabs) {
+  bool failed;
+  Attempt attempt = escalate(
+      "cquad", run_cquad(F, a, b, relerr, epsabs, cquad_size),
+      [&]() {
+        return run_cquad(F, a, b, escalation_tolerance * relerr,
+                         escalation_tolerance * epsabs,
+                         escalation_workspace * cquad_size);
+      },
+      [&]() {
+        return run_qags(F, a, b, escalation_tolerance * relerr,
+                        escalation_tolerance * epsabs,
+                        escalation_workspace * 1000);
+      },
+      failed);
+
+  record_integration(attempt.evaluations, attempt.intervals, attempt.result,
+                     attempt.abserr, failed);
+
+  return attempt.result;
+}
+
+// wrapper to qags routine
+double qags_gsl(const gsl_function *F, double a, double b, double relerr,
+                double epsabs) {
+  bool failed;
+  Attempt attempt = escalate(
+      "qags", run_qags(F, a, b, relerr, epsabs, 1000),
+      [&]() {
+        return run_qags(F, a, b, escalation_tolerance * relerr,
+                        escalation_tolerance * epsabs,
+                        escalation_workspace * 1000);
+      },
+      [&]() {
+        return run_cquad(F, a, b, escalation_tolerance * relerr,
+                         escalation_tolerance * epsabs,
+                         escalation_workspace * cquad_size);
+      },
+      failed);
+
+  record_integration(attempt.evaluations, attempt.intervals, attempt.result,
+                     attempt.abserr, failed);
+
+  return attempt.result;
 }
 
 // wrapper to qagiu routine
+double qagiu_gsl(gsl_function *F, double a, double relerr, double epsabs) {
+  bool failed;
+  Attempt attempt = escalate(
+      "qagiu", run_qagiu(F, a, relerr, epsabs, 10000),
+      [&]() {
+        return run_qagiu(F, a, escalation_tolerance * relerr,
+                         escalation_tolerance * epsabs,
+                         escalation_workspace * 10000);
+      },
+      [&]() {
+        // the exp-sinh quadrature does not report a status, it failed if its
+        // error estimate misses the relaxed tolerance
+        Attempt fallback;
+        {
+          IntegrationNesting nesting;
+          auto f = [&](double x) -> double { return GSL_FN_EVAL(F, x); };
+          fallback.result = exp_sinh_estimate(
+              f, a, escalation_tolerance * relerr,
+              escalation_tolerance * epsabs, fallback.abserr,
+              fallback.evaluations);
+        }
+        fallback.intervals = 1;
+        fallback.status =
+            (std::isfinite(fallback.result) &&
+             fallback.abserr <=
+                 escalation_tolerance *
+                     std::max(epsabs, relerr * std::abs(fallback.result)))
+                ? GSL_SUCCESS
+                : GSL_ETOL;
+        return fallback;
+      },
+      failed);
+
+  record_integration(attempt.evaluations, attempt.intervals, attempt.result,
+                     attempt.abserr, failed);
+
+  return attempt.result;
+}
+
+// the std::function versions are kept for compatibility and forward to the
+// templated wrappers
+double cquad(const std::function<double(double)> &f, double a, double b,
+             double relerr, double epsabs) {
+  return cquad<std::function<double(double)>>(f, a, b, relerr, epsabs);
+}
+
+double qags(const std::function<double(double)> &f, double a, double b,
+            double relerr, double epsabs) {
+  return qags<std::function<double(double)>>(f, a, b, relerr, epsabs);
+}
+
 double qagiu(const std::function<double(double)> &f, double a, double relerr,
              double epsabs) {
+  return qagiu<std::function<double(double)>>(f, a, relerr, epsabs);
+}
 
-  // cast given lambda to static (!) gsl_function
-  gsl_function_pp<decltype(f)> Fp(f);
-  auto *F = static_cast<gsl_function *>(&Fp);
+void set_integration_failure_policy(Failure_Options policy) {
+#pragma omp critical(integration_failure_policy)
+  {
+    // the gsl error handler aborts by default, hence it has to be switched
+    // off to receive the status codes of failed integrations
+    if (policy == ESCALATE && failure_policy == ABORT) {
+      gsl_handler = gsl_set_error_handler_off();
+    } else if (policy == ABORT && failure_policy == ESCALATE) {
+      gsl_set_error_handler(gsl_handler);
+    }
+    failure_policy = policy;
+  }
+}
 
-  double res;
-  double abserr;
+Failure_Options get_integration_failure_policy() { return failure_policy; }
 
-  /* Initialize the workspace. */
-  gsl_integration_workspace *ws = gsl_integration_workspace_alloc(10000);
-  if (ws == nullptr) {
-    printf("call to gsl_integration_workspace_alloc failed.\n");
-    abort();
+Failure_Options failure_option(const std::string &name) {
+  if (name == "abort") {
+    return ABORT;
+  } else if (name == "escalate") {
+    return ESCALATE;
+  } else {
+    std::cerr << "Error: Unknown failure policy (" << name << ")!"
+              << std::endl;
+    exit(0);
   }
+}
 
-  /* Call the integrator. */
-  /* set nevals and abserr pointer to nullptr, we are only interested in result
-   */
-  int success =
-      gsl_integration_qagiu(F, a, epsabs, relerr, 10000, ws, &res, &abserr);
-  if (success != 0) {
-    printf("qagiu error: %s\n", gsl_strerror(success));
-    abort();
+Quadrature_Options quadrature_option(const std::string &name) {
+  if (name == "adaptive") {
+    return ADAPTIVE;
+  } else if (name == "double exponential") {
+    return DOUBLE_EXPONENTIAL;
+  } else {
+    std::cerr << "Error: Unknown quadrature (" << name << ")!" << std::endl;
+    exit(0);
+  }
+}
+
+size_t integration_workspace_allocations() { return workspace_allocations; }
+
+double IntegrationDiagnostics::relerr() const {
+  if (abserr == 0) {
+    return 0;
+  }
+  if (result == 0) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return abserr / std::abs(result);
+}
+
+void IntegrationDiagnostics::add(const IntegrationDiagnostics &other) {
+  calls += other.calls;
+  failures += other.failures;
+  evaluations += other.evaluations;
+  intervals += other.intervals;
+  result += other.result;
+  abserr += other.abserr;
+}
+
+IntegrationDiagnosticsScope::IntegrationDiagnosticsScope(
+    IntegrationDiagnostics &diagnostics) {
+  diagnostics_scopes.emplace_back(&diagnostics, integration_depth);
+}
+
+IntegrationDiagnosticsScope::~IntegrationDiagnosticsScope() {
+  diagnostics_scopes.pop_back();
+}
+
+IntegrationDiagnosticsLane::IntegrationDiagnosticsLane(
+    IntegrationDiagnostics &diagnostics) {
+  suspended.swap(diagnostics_scopes);
+  diagnostics_scopes.emplace_back(&diagnostics, integration_depth);
+}
+
+IntegrationDiagnosticsLane::~IntegrationDiagnosticsLane() {
+  diagnostics_scopes.swap(suspended);
+}
+
+IntegrationNesting::IntegrationNesting() { ++integration_depth; }
+
+IntegrationNesting::~IntegrationNesting() { --integration_depth; }
+
+bool integration_diagnostics_enabled() { return !diagnostics_scopes.empty(); }
+
+void record_integration(size_t evaluations, size_t intervals, double result,
+                        double abserr, bool failed) {
+  for (auto &scope : diagnostics_scopes) {
+    IntegrationDiagnostics &diagnostics = *scope.first;
+    diagnostics.calls += 1;
+    diagnostics.failures += failed ? 1 : 0;
+    diagnostics.evaluations += evaluations;
+    diagnostics.intervals += intervals;
+
+    // only the integrations called directly within the scope contribute to
+    // the result and its error
+    if (integration_depth == scope.second) {
+      diagnostics.result += result;
+      diagnostics.abserr += abserr;
+    }
   }
+}
+
+void record_diagnostics(const IntegrationDiagnostics &other) {
+  for (auto &scope : diagnostics_scopes) {
+    IntegrationDiagnostics &diagnostics = *scope.first;
+    diagnostics.calls += other.calls;
+    diagnostics.failures += other.failures;
+    diagnostics.evaluations += other.evaluations;
+    diagnostics.intervals += other.intervals;
 
-  return res;
+    // the outermost integrations of the lane are called directly within the
+    // scope if the calling thread is
+    if (integration_depth == scope.second) {
+      diagnostics.result += other.result;
+      diagnostics.abserr += other.abserr;
+    }
+  }
 }
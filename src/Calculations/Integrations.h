@@ -1,9 +1,15 @@
 #ifndef INTEGRATIONS_H
 #define INTEGRATIONS_H
+#include <algorithm>
 #include <armadillo>
 #include <cmath>
+#include <functional>
 #include <gsl/gsl_math.h>
 #include <iostream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
 
 template <typename F> class gsl_function_pp : public gsl_function {
 public:
@@ -19,7 +25,34 @@ private:
   }
 };
 
-// wrapper functions for integration routines of the gsl
+// wrapper functions for integration routines of the gsl acting on a given
+// gsl_function
+double cquad_gsl(const gsl_function *F, double a, double b, double relerr,
+                 double epsabs);
+double qags_gsl(const gsl_function *F, double a, double b, double relerr,
+                double epsabs);
+double qagiu_gsl(gsl_function *F, double a, double relerr, double epsabs);
+
+// wrapper functions for integration routines of the gsl for any callable. The
+// callable is bound directly into the gsl_function, such that the compiler can
+// inline the integrand into the function called by the gsl.
+template <typename F>
+double cquad(const F &f, double a, double b, double relerr, double epsabs) {
+  gsl_function_pp<F> Fp(f);
+  return cquad_gsl(&Fp, a, b, relerr, epsabs);
+}
+template <typename F>
+double qags(const F &f, double a, double b, double relerr, double epsabs) {
+  gsl_function_pp<F> Fp(f);
+  return qags_gsl(&Fp, a, b, relerr, epsabs);
+}
+template <typename F>
+double qagiu(const F &f, double a, double relerr, double epsabs) {
+  gsl_function_pp<F> Fp(f);
+  return qagiu_gsl(&Fp, a, relerr, epsabs);
+}
+
+// wrapper functions for integration routines of the gsl for std::function
 double cquad(const std::function<double(double)> &f, double a, double b,
              double relerr, double epsabs);
 double qags(const std::function<double(double)> &f, double a, double b,
@@ -27,4 +60,321 @@ double qags(const std::function<double(double)> &f, double a, double b,
 double qagiu(const std::function<double(double)> &f, double a, double relerr,
              double epsabs);
 
+//! Diagnostics of numerical integrations
+/*!
+ * Collects the cost and the accuracy of all integrations performed while an
+ * IntegrationDiagnosticsScope referring to it is alive. Evaluations and
+ * intervals are counted on all nesting levels, while the result and the error
+ * estimate are only accumulated for the outermost integrations, i.e. the ones
+ * called directly by the code that opened the scope.
+ */
+struct IntegrationDiagnostics {
+  size_t calls = 0;       // calls of integration routines
+  size_t failures = 0;    // calls that missed the demanded accuracy
+  size_t evaluations = 0; // evaluations of the integrands
+  size_t intervals = 0;   // subintervals used by the integration routines
+  double result = 0;      // sum of the outermost results
+  double abserr = 0;      // sum of the outermost absolute error estimates
+
+  // relative error estimate of the outermost integrations
+  double relerr() const;
+
+  // adds the diagnostics of another record to this one
+  void add(const IntegrationDiagnostics &other);
+};
+
+//! Enables the collection of integration diagnostics on the calling thread
+/*!
+ * Scopes can be nested, every integration is recorded in all scopes alive on
+ * the calling thread. Without a scope no diagnostics are collected.
+ */
+class IntegrationDiagnosticsScope {
+public:
+  explicit IntegrationDiagnosticsScope(IntegrationDiagnostics &diagnostics);
+  ~IntegrationDiagnosticsScope();
+
+  IntegrationDiagnosticsScope(const IntegrationDiagnosticsScope &) = delete;
+  IntegrationDiagnosticsScope &
+  operator=(const IntegrationDiagnosticsScope &) = delete;
+};
+
+//! Collects the diagnostics of work done on behalf of another thread
+/*!
+ * While a lane is alive, the integrations of the calling thread are only
+ * recorded in the diagnostics of the lane, as if they were called directly
+ * within its scope. Parallel loops open a lane for every iteration and hand
+ * the diagnostics of all iterations on with record_diagnostics afterwards,
+ * such that the diagnostics do not depend on the thread that runs an
+ * iteration.
+ */
+class IntegrationDiagnosticsLane {
+public:
+  explicit IntegrationDiagnosticsLane(IntegrationDiagnostics &diagnostics);
+  ~IntegrationDiagnosticsLane();
+
+  IntegrationDiagnosticsLane(const IntegrationDiagnosticsLane &) = delete;
+  IntegrationDiagnosticsLane &
+  operator=(const IntegrationDiagnosticsLane &) = delete;
+
+private:
+  // the diagnostics scopes of the calling thread suspended by the lane
+  std::vector<std::pair<IntegrationDiagnostics *, size_t>> suspended;
+};
+
+//! Marks the calling thread as being inside an integration routine
+/*!
+ * Integrations started while a nesting marker is alive are nested ones and do
+ * not contribute to the result and error estimate of the diagnostics.
+ */
+class IntegrationNesting {
+public:
+  IntegrationNesting();
+  ~IntegrationNesting();
+
+  IntegrationNesting(const IntegrationNesting &) = delete;
+  IntegrationNesting &operator=(const IntegrationNesting &) = delete;
+};
+
+// true if integration diagnostics are collected on the calling thread
+bool integration_diagnostics_enabled();
+
+// records a finished call of an integration routine in all diagnostics scopes
+// of the calling thread, failed marks calls that missed the demanded accuracy
+void record_integration(size_t evaluations, size_t intervals, double result,
+                        double abserr, bool failed = false);
+
+// records the diagnostics of a lane in all diagnostics scopes of the calling
+// thread, as if its integrations had been called by the calling thread
+void record_diagnostics(const IntegrationDiagnostics &diagnostics);
+
+// Enum variables for the handling of failed gsl integrations. With ABORT the
+// program is terminated. With ESCALATE the integration is repeated with a ten
+// times larger workspace and ten times relaxed tolerances, then with an
+// alternate rule (cquad and qags replace each other, qagiu is replaced by
+// exp_sinh). If this fails as well, the best estimate is returned and the
+// failure is recorded in the integration diagnostics.
+enum Failure_Options { ABORT, ESCALATE };
+
+// sets the failure policy of all threads, ABORT is the default
+void set_integration_failure_policy(Failure_Options policy);
+Failure_Options get_integration_failure_policy();
+
+// converts the name used on the command line ("abort" or "escalate") to the
+// corresponding option
+Failure_Options failure_option(const std::string &name);
+
+// Enum variables for the choice of the quadrature at a call site, either the
+// adaptive routines of the gsl or the double-exponential quadrature
+enum Quadrature_Options { ADAPTIVE, DOUBLE_EXPONENTIAL };
+
+// converts the name used in the input files ("adaptive" or "double
+// exponential") to the corresponding option
+Quadrature_Options quadrature_option(const std::string &name);
+
+// Double-exponential quadrature of g(t) over the real line, where g already
+// contains the transformation of the original integral and decays
+// double-exponentially for |t| -> infinity. The trapezoidal rule is applied
+// with the step size h = 1 and h is halved until two successive estimates
+// agree to the demanded accuracy, at most max_level times. The summation is
+// truncated where the terms become negligible or g is not finite, e.g. if the
+// transformed node reaches the boundary of the integration domain. The error
+// of the last halving is stored in abserr, which is raised to the last
+// retained term if the summation had to be truncated before the terms became
+// negligible. The number of evaluations is stored in nevals.
+template <typename G>
+double de_quadrature(const G &g, double relerr, double epsabs, double &abserr,
+                     size_t &nevals, int max_level = 8) {
+  // largest |t| for which the transformations are representable
+  const double t_max = 6.5;
+  const double eps = std::numeric_limits<double>::epsilon();
+
+  // level 0: find the range of t in which the terms are not negligible
+  double center = g(0.);
+  nevals = 1;
+  if (!std::isfinite(center)) {
+    center = 0;
+  }
+  double sum = center;
+  double t_range[2] = {0, 0};
+  // the last retained term of a side whose terms did not become negligible
+  double truncation = 0;
+  for (int side = 0; side < 2; side++) {
+    double sign = (side == 0) ? -1. : 1.;
+    double max_term = std::abs(center);
+    double last_term = std::abs(center);
+    bool negligible = false;
+    for (double t = 1.; t <= t_max; t += 1.) {
+      double term = g(sign * t);
+      ++nevals;
+      if (!std::isfinite(term)) {
+        break;
+      }
+      sum += term;
+      t_range[side] = t;
+      last_term = std::abs(term);
+      max_term = std::max(max_term, last_term);
+      if (max_term > 0 && last_term <= eps * max_term) {
+        negligible = true;
+        break;
+      }
+    }
+    if (!negligible && last_term > eps * max_term) {
+      truncation = std::max(truncation, last_term);
+    }
+  }
+
+  // add one more unit step on both sides to capture the decay between the
+  // last retained node and the first negligible one
+  double t_left = std::min(t_range[0] + 1., t_max);
+  double t_right = std::min(t_range[1] + 1., t_max);
+
+  // refine the step size and only evaluate the new nodes
+  double h = 1.;
+  double result = sum;
+  abserr = std::numeric_limits<double>::infinity();
+  for (int level = 1; level <= max_level; level++) {
+    h *= 0.5;
+    double sum_new = 0;
+    for (double t = h; t < t_right; t += 2 * h) {
+      double term = g(t);
+      ++nevals;
+      if (!std::isfinite(term)) {
+        break;
+      }
+      sum_new += term;
+    }
+    for (double t = h; t < t_left; t += 2 * h) {
+      double term = g(-t);
+      ++nevals;
+      if (!std::isfinite(term)) {
+        break;
+      }
+      sum_new += term;
+    }
+    double previous = result;
+    result = 0.5 * previous + h * sum_new;
+    abserr = std::abs(result - previous);
+    // the first halving only separates the coarse estimate from the range
+    // search, hence at least two halvings are performed
+    if (level > 1 && abserr <= std::max(epsabs, relerr * std::abs(result))) {
+      break;
+    }
+  }
+
+  abserr = std::max(abserr, truncation);
+  return result;
+}
+
+// Integrates with the double-exponential quadrature, whose estimate is
+// computed by estimate(relerr, epsabs, abserr, nevals, max_level), and records
+// the call. If the demanded accuracy is missed with the ESCALATE policy, the
+// quadrature is repeated with four more halvings of the step size and ten
+// times relaxed tolerances, like the larger workspace of the adaptive
+// routines. The best estimate is returned and a remaining miss is recorded as
+// a failure in the integration diagnostics. The quadrature never aborts.
+template <typename Estimate>
+double de_integration(const Estimate &estimate, double relerr, double epsabs) {
+  auto converged = [](double result, double abserr, double relerr,
+                      double epsabs) -> bool {
+    return std::isfinite(result) &&
+           abserr <= std::max(epsabs, relerr * std::abs(result));
+  };
+
+  double abserr;
+  size_t nevals;
+  double result;
+  {
+    IntegrationNesting nesting;
+    result = estimate(relerr, epsabs, abserr, nevals, 8);
+  }
+  bool failed = !converged(result, abserr, relerr, epsabs);
+
+  if (failed && get_integration_failure_policy() == ESCALATE) {
+    double retry_abserr;
+    size_t retry_nevals;
+    double retry;
+    {
+      IntegrationNesting nesting;
+      retry = estimate(10 * relerr, 10 * epsabs, retry_abserr, retry_nevals,
+                       12);
+    }
+    nevals += retry_nevals;
+    failed = !converged(retry, retry_abserr, 10 * relerr, 10 * epsabs);
+    if (!failed || !std::isfinite(result) ||
+        (std::isfinite(retry) && retry_abserr < abserr)) {
+      result = retry;
+      abserr = retry_abserr;
+    }
+  }
+
+  record_integration(nevals, 1, result, abserr, failed);
+  return result;
+}
+
+// Tanh-sinh quadrature of f over the finite interval [a, b]. The nodes
+// cluster double-exponentially at the end points, such that integrable
+// singularities and kinks at the end points are resolved without bisection.
+// The end points themselves are never evaluated. Since f is called with x,
+// a singularity at a non-zero end point is only resolved up to the spacing of
+// doubles around that end point.
+template <typename F>
+double tanh_sinh_estimate(const F &f, double a, double b, double relerr,
+                          double epsabs, double &abserr, size_t &nevals,
+                          int max_level = 8) {
+  auto g = [&](double t) -> double {
+    double u = M_PI_2 * std::sinh(std::abs(t));
+    // distance of the node to the nearer end point in units of (b - a),
+    // computed without cancellation
+    double s = 1. / (1. + std::exp(2. * u));
+    double x = (t < 0) ? a + (b - a) * s : b - (b - a) * s;
+    if (x == a || x == b || s == 0) {
+      return NAN;
+    }
+    return f(x) * (b - a) * M_PI * std::cosh(t) * s * (1. - s);
+  };
+  return de_quadrature(g, relerr, epsabs, abserr, nevals, max_level);
+}
+
+template <typename F>
+double tanh_sinh(const F &f, double a, double b, double relerr, double epsabs) {
+  auto estimate = [&](double relerr, double epsabs, double &abserr,
+                      size_t &nevals, int max_level) -> double {
+    return tanh_sinh_estimate(f, a, b, relerr, epsabs, abserr, nevals,
+                              max_level);
+  };
+  return de_integration(estimate, relerr, epsabs);
+}
+
+// Exp-sinh quadrature of f over the semi-infinite interval [a, infinity). The
+// nodes x = a + exp(pi / 2 sinh(t)) cluster at a and extend exponentially to
+// infinity, such that no transformation onto a finite interval is needed.
+template <typename F>
+double exp_sinh_estimate(const F &f, double a, double relerr, double epsabs,
+                         double &abserr, size_t &nevals, int max_level = 8) {
+  auto g = [&](double t) -> double {
+    double u = M_PI_2 * std::sinh(t);
+    double d = std::exp(u);
+    double x = a + d;
+    if (x == a || !std::isfinite(x)) {
+      return NAN;
+    }
+    return f(x) * d * M_PI_2 * std::cosh(t);
+  };
+  return de_quadrature(g, relerr, epsabs, abserr, nevals, max_level);
+}
+
+template <typename F>
+double exp_sinh(const F &f, double a, double relerr, double epsabs) {
+  auto estimate = [&](double relerr, double epsabs, double &abserr,
+                      size_t &nevals, int max_level) -> double {
+    return exp_sinh_estimate(f, a, relerr, epsabs, abserr, nevals, max_level);
+  };
+  return de_integration(estimate, relerr, epsabs);
+}
+
+// number of GSL workspaces the calling thread has allocated so far. The
+// workspaces are pooled per thread and nesting level, hence this number stays
+// constant once every nesting level has been visited.
+size_t integration_workspace_allocations();
+
 #endif // INTEGRATIONS_H
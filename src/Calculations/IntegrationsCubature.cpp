@@ -0,0 +1,72 @@
+#include "IntegrationsCubature.h"
+
+GenzMalikRule::GenzMalikRule(uword dim) : dim(dim) {
+  // distances of the nodes from the center
+  const double lambda_2 = std::sqrt(9. / 70.);
+  const double lambda_3 = std::sqrt(9. / 10.);
+  const double lambda_4 = std::sqrt(9. / 10.);
+  const double lambda_5 = std::sqrt(9. / 19.);
+  ratio = (lambda_2 * lambda_2) / (lambda_3 * lambda_3);
+
+  double d = dim;
+  uword corners = 1u << dim;
+  uword n_nodes = 1 + 4 * dim + 2 * dim * (dim - 1) + corners;
+  nodes.zeros(dim, n_nodes);
+  weights_7.zeros(n_nodes);
+  weights_5.zeros(n_nodes);
+
+  // center
+  weights_7(0) = (12824. - 9120. * d + 400. * d * d) / 19683.;
+  weights_5(0) = (729. - 950. * d + 50. * d * d) / 729.;
+  uword node = 1;
+
+  // pairs on the axes at the inner distance
+  for (uword k = 0; k < dim; k++) {
+    for (double sign : {1., -1.}) {
+      nodes(k, node) = sign * lambda_2;
+      weights_7(node) = 980. / 6561.;
+      weights_5(node) = 245. / 486.;
+      ++node;
+    }
+  }
+
+  // pairs on the axes at the outer distance
+  for (uword k = 0; k < dim; k++) {
+    for (double sign : {1., -1.}) {
+      nodes(k, node) = sign * lambda_3;
+      weights_7(node) = (1820. - 400. * d) / 19683.;
+      weights_5(node) = (265. - 100. * d) / 1458.;
+      ++node;
+    }
+  }
+
+  // diagonals of all pairs of axes
+  for (uword k = 0; k < dim; k++) {
+    for (uword l = k + 1; l < dim; l++) {
+      for (double sign_k : {1., -1.}) {
+        for (double sign_l : {1., -1.}) {
+          nodes(k, node) = sign_k * lambda_4;
+          nodes(l, node) = sign_l * lambda_4;
+          weights_7(node) = 200. / 19683.;
+          weights_5(node) = 25. / 729.;
+          ++node;
+        }
+      }
+    }
+  }
+
+  // corners of the cube, which do not belong to the embedded rule
+  for (uword c = 0; c < corners; c++) {
+    for (uword k = 0; k < dim; k++) {
+      nodes(k, node) = ((c >> k) & 1u) ? -lambda_5 : lambda_5;
+    }
+    weights_7(node) = 6859. / 19683. / corners;
+    ++node;
+  }
+}
+
+vec cubature_vec(const std::function<void(const vec &, vec &)> &f, uword n,
+                 const vec &a, const vec &b, double relerr, double epsabs) {
+  return cubature_vec<std::function<void(const vec &, vec &)>>(
+      f, n, a, b, relerr, epsabs);
+}
@@ -0,0 +1,222 @@
+#ifndef INTEGRATIONSCUBATURE_H
+#define INTEGRATIONSCUBATURE_H
+
+#include <algorithm>
+#include <armadillo>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include "Integrations.h"
+#include "IntegrationsVector.h"
+
+using namespace arma;
+
+//! A subregion of the adaptive cubature
+struct CubatureRegion {
+  vec center, half;  // center and half-widths of the region
+  vec result, error; // integral and error estimate of each component
+  double norm;       // norm of the error relative to the demanded accuracy
+  uword axis;        // axis along which the region is bisected
+};
+
+//! Nodes and weights of the Genz-Malik rule of degree 7 with embedded rule of
+//! degree 5 in d dimensions
+/*!
+ * The rule uses the center, 2d points on each axis at two distances, 2d(d-1)
+ * points on the diagonals of all pairs of axes and the 2^d corners of a scaled
+ * cube, i.e. 17 points in two dimensions. The weights are normalized to the
+ * volume of the region. See A. C. Genz and A. A. Malik, J. Comput. Appl. Math.
+ * 6, 295 (1980).
+ */
+struct GenzMalikRule {
+  uword dim;     // dimension of the integration domain
+  mat nodes;     // nodes on [-1, 1]^d, one per column
+  vec weights_7; // weights of the rule of degree 7
+  vec weights_5; // weights of the embedded rule of degree 5
+  double ratio;  // squared ratio of the two distances on the axes
+
+  explicit GenzMalikRule(uword dim);
+};
+
+// Applies the Genz-Malik rule to the n-component function f on the region.
+// The function values are stored in the columns of fval and the region is
+// assigned the result, the error estimate and the axis with the largest
+// fourth difference, along which it should be bisected.
+template <typename F>
+void genz_malik(const F &f, const GenzMalikRule &rule, CubatureRegion &region,
+                vec &x, mat &fval) {
+  uword dim = rule.dim;
+  uword n = fval.n_rows;
+
+  // evaluate the integrand at all nodes of the rule
+  for (uword i = 0; i < rule.nodes.n_cols; i++) {
+    x = region.center + region.half % rule.nodes.col(i);
+    vec y(fval.colptr(i), n, false, true);
+    f(x, y);
+  }
+
+  double volume = prod(2 * region.half);
+  vec result_5 = volume * (fval * rule.weights_5);
+  region.result = volume * (fval * rule.weights_7);
+  region.error = abs(region.result - result_5);
+
+  // The difference to the embedded rule estimates the error of the rule of
+  // degree 5 and hence grossly overestimates the error of the rule of degree
+  // 7 for smooth integrands. As in QUADPACK's qk15 the error is rescaled with
+  // the integral of the deviation of f from its mean value, where the factor
+  // 10 (200 in qk15) was chosen such that the plate Green's tensor reaches the
+  // demanded accuracy.
+  vec mean = region.result / volume;
+  vec resasc = volume * (abs(fval.each_col() - mean) * abs(rule.weights_7));
+  for (uword j = 0; j < n; j++) {
+    if (resasc(j) != 0 && region.error(j) != 0) {
+      region.error(j) = resasc(j) * std::min(1., std::pow(10 * region.error(j) /
+                                                             resasc(j),
+                                                         1.5));
+    }
+  }
+
+  // The fourth differences along the axes indicate in which direction the
+  // integrand varies most. The differences of all components are weighted by
+  // their relative error, such that the axis is chosen by the components
+  // that limit the accuracy. The nodes on the axes follow the center, first
+  // the pairs at the inner and then the pairs at the outer distance.
+  vec difference = zeros<vec>(dim);
+  for (uword j = 0; j < n; j++) {
+    double scale = std::abs(region.result(j)) > 0
+                       ? region.error(j) / std::abs(region.result(j))
+                       : region.error(j);
+    for (uword k = 0; k < dim; k++) {
+      double inner = fval(j, 1 + 2 * k) + fval(j, 2 + 2 * k) - 2 * fval(j, 0);
+      double outer = fval(j, 1 + 2 * dim + 2 * k) +
+                     fval(j, 2 + 2 * dim + 2 * k) - 2 * fval(j, 0);
+      difference(k) += scale * std::abs(inner - rule.ratio * outer);
+    }
+  }
+
+  // without any variation the widest axis is bisected
+  region.axis = difference.max() > 0 ? difference.index_max()
+                                     : region.half.index_max();
+}
+
+// Adaptive vector-valued cubature of the n-component function f over the union
+// of the disjoint boxes [a.col(i), b.col(i)] in d = a.n_rows dimensions. The
+// function is called as f(x, y) and has to write its n components at the point
+// x into y. The region with the largest error norm among all boxes is bisected
+// along the axis of its largest fourth difference until the error norm of the
+// total result falls below one, with the same error criterion as qag_vec.
+// Like qag_vec, the best estimate is returned and a failure is recorded if the
+// demanded accuracy can not be reached within the maximal number of
+// subregions.
+template <typename F>
+vec cubature_vec(const F &f, uword n, const mat &a, const mat &b,
+                 double relerr, const vec &epsabs) {
+  // maximal number of subregions
+  const size_t limit = 10000;
+
+  GenzMalikRule rule(a.n_rows);
+  vec x(a.n_rows);
+  mat fval(n, rule.nodes.n_cols);
+
+  // bisected regions, ordered as a heap with respect to their error norm
+  std::vector<CubatureRegion> regions;
+  auto compare = [](const CubatureRegion &l, const CubatureRegion &r) {
+    return l.norm < r.norm;
+  };
+
+  vec total = zeros<vec>(n);
+  vec total_error = zeros<vec>(n);
+  size_t evaluated = 0;
+  {
+    // mark integrations performed by the integrand as nested ones
+    IntegrationNesting nesting;
+
+    for (uword i = 0; i < a.n_cols; i++) {
+      CubatureRegion box{0.5 * (a.col(i) + b.col(i)),
+                         0.5 * (b.col(i) - a.col(i)), vec(n), vec(n), 0, 0};
+      genz_malik(f, rule, box, x, fval);
+      ++evaluated;
+      total += box.result;
+      total_error += box.error;
+      regions.push_back(box);
+    }
+    for (auto &region : regions) {
+      region.norm = error_norm(region.error, total, relerr, epsabs);
+    }
+    std::make_heap(regions.begin(), regions.end(), compare);
+
+    while (error_norm(total_error, total, relerr, epsabs) > 1 &&
+           regions.size() < limit) {
+      // take the region with the largest error
+      std::pop_heap(regions.begin(), regions.end(), compare);
+      CubatureRegion parent = regions.back();
+      regions.pop_back();
+
+      // stop if the region can not be bisected any further
+      uword axis = parent.axis;
+      double half = 0.5 * parent.half(axis);
+      double center = parent.center(axis);
+      if (!(center - half < center && center < center + half)) {
+        regions.push_back(parent);
+        break;
+      }
+
+      CubatureRegion left = parent, right = parent;
+      left.half(axis) = half;
+      right.half(axis) = half;
+      left.center(axis) = center - half;
+      right.center(axis) = center + half;
+      genz_malik(f, rule, left, x, fval);
+      genz_malik(f, rule, right, x, fval);
+      evaluated += 2;
+
+      // update the total result and error
+      total += left.result + right.result - parent.result;
+      total_error += left.error + right.error - parent.error;
+
+      left.norm = error_norm(left.error, total, relerr, epsabs);
+      right.norm = error_norm(right.error, total, relerr, epsabs);
+      regions.push_back(left);
+      std::push_heap(regions.begin(), regions.end(), compare);
+      regions.push_back(right);
+      std::push_heap(regions.begin(), regions.end(), compare);
+    }
+  }
+
+  // sum up the results and errors of all regions to avoid accumulated
+  // round-off
+  total.zeros();
+  vec error = zeros<vec>(n);
+  for (auto &region : regions) {
+    total += region.result;
+    error += region.error;
+  }
+
+  // every evaluation of all n components counts as a single evaluation
+  record_integration(rule.nodes.n_cols * evaluated, regions.size(),
+                     max(abs(total)), max(error),
+                     error_norm(error, total, relerr, epsabs) > 1);
+
+  return total;
+}
+
+template <typename F>
+vec cubature_vec(const F &f, uword n, const mat &a, const mat &b,
+                 double relerr, double epsabs) {
+  return cubature_vec(f, n, a, b, relerr, vec(epsabs * ones<vec>(n)));
+}
+
+// cubature over the single box [a, b]
+template <typename F>
+vec cubature_vec(const F &f, uword n, const vec &a, const vec &b,
+                 double relerr, double epsabs) {
+  return cubature_vec(f, n, mat(a), mat(b), relerr,
+                      vec(epsabs * ones<vec>(n)));
+}
+
+// wrapper for std::function
+vec cubature_vec(const std::function<void(const vec &, vec &)> &f, uword n,
+                 const vec &a, const vec &b, double relerr, double epsabs);
+
+#endif // INTEGRATIONSCUBATURE_H
@@ -0,0 +1,50 @@
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "IntegrationsLaguerre.h"
+
+LaguerreRule::LaguerreRule(uword order, double alpha)
+    : order(order), alpha(alpha) {
+  // Jacobi matrix of the recurrence of the generalized Laguerre polynomials
+  mat jacobi(order, order, fill::zeros);
+  for (uword i = 0; i < order; i++) {
+    jacobi(i, i) = 2. * i + alpha + 1.;
+    if (i > 0) {
+      jacobi(i, i - 1) = std::sqrt(i * (i + alpha));
+      jacobi(i - 1, i) = jacobi(i, i - 1);
+    }
+  }
+
+  // The nodes are the eigenvalues, the weights follow from the first
+  // components of the normalized eigenvectors and the zeroth moment
+  // Gamma(alpha + 1) of the weight function.
+  mat eigenvectors;
+  eig_sym(nodes, eigenvectors, jacobi);
+  weights = std::tgamma(alpha + 1) * square(eigenvectors.row(0).t());
+
+  // Divide by the weight function. The weights of the outermost nodes are
+  // tiny and inaccurate, but they are multiplied with the equally tiny
+  // integrand, so that their absolute error stays negligible.
+  weights %= exp(nodes) / pow(nodes, alpha);
+}
+
+const LaguerreRule &laguerre_rule(uword order, double alpha) {
+  static std::mutex mutex;
+  static std::map<std::pair<uword, double>, std::unique_ptr<LaguerreRule>>
+      rules;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &rule = rules[{order, alpha}];
+  if (!rule) {
+    rule.reset(new LaguerreRule(order, alpha));
+  }
+  return *rule;
+}
+
+vec laguerre_vec(const std::function<void(double, vec &)> &f, uword n,
+                 double a, double decay, double relerr, double epsabs) {
+  return laguerre_vec<std::function<void(double, vec &)>>(f, n, a, decay,
+                                                          relerr, epsabs);
+}
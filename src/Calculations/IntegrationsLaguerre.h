@@ -0,0 +1,157 @@
+#ifndef INTEGRATIONSLAGUERRE_H
+#define INTEGRATIONSLAGUERRE_H
+
+#include <armadillo>
+#include <cmath>
+#include <functional>
+
+#include "Integrations.h"
+#include "IntegrationsVector.h"
+
+using namespace arma;
+
+//! Nodes and weights of the generalized Gauss-Laguerre rule of a given order
+/*!
+ * The rule integrates t^alpha exp(-t) p(t) exactly over [0, infinity) for all
+ * polynomials p of degree below 2 * order. The nodes and weights are obtained
+ * from the eigenvalues and eigenvectors of the symmetric tridiagonal Jacobi
+ * matrix of the generalized Laguerre polynomials (Golub-Welsch). The weights
+ * are stored divided by the weight function t^alpha exp(-t), such that the
+ * rule can be applied directly to an integrand containing the weight.
+ */
+struct LaguerreRule {
+  uword order;  // number of nodes
+  double alpha; // exponent of t in the weight function
+  vec nodes;    // nodes in ascending order
+  vec weights;  // weights divided by the weight function at the nodes
+
+  LaguerreRule(uword order, double alpha);
+};
+
+// Returns the rule of the given order and alpha. The rules are computed once
+// and shared by all threads.
+const LaguerreRule &laguerre_rule(uword order, double alpha);
+
+// orders of the first and the last rule applied by laguerre_vec
+const uword laguerre_min_order = 8;
+const uword laguerre_max_order = 128;
+
+// Adaptive Gauss-Laguerre quadrature shared by laguerre_vec and
+// laguerre_batch. The rule is called as rule(nodes, weights, result) and has
+// to store the weighted sum of the integrand at x = a + t / decay in result.
+// The order is doubled until the difference to the rule of half the order,
+// which estimates the error of the latter, falls below the demanded accuracy.
+// The error estimate and the number of evaluations are stored in error and
+// evaluations.
+template <typename Rule>
+vec laguerre_adaptive(const Rule &rule, uword n, double decay, double relerr,
+                      const vec &epsabs, double alpha, vec &error,
+                      size_t &evaluations) {
+  vec previous(n), result(n);
+  const LaguerreRule &first = laguerre_rule(laguerre_min_order, alpha);
+  rule(first.nodes, first.weights, previous);
+  previous /= decay;
+  evaluations = laguerre_min_order;
+
+  for (uword order = 2 * laguerre_min_order; order <= laguerre_max_order;
+       order *= 2) {
+    const LaguerreRule &next = laguerre_rule(order, alpha);
+    rule(next.nodes, next.weights, result);
+    result /= decay;
+    evaluations += order;
+
+    error = abs(result - previous);
+    if (error_norm(error, result, relerr, epsabs) <= 1) {
+      break;
+    }
+    previous = result;
+  }
+  return result;
+}
+
+// Gauss-Laguerre quadrature of the n-component function f over [a, infinity),
+// which decays like exp(-decay * (x - a)) and behaves like (x - a)^alpha at a.
+// The function is called as f(x, y) and has to write its n components at x
+// into y. The order of the rule is doubled from laguerre_min_order until two
+// successive rules agree within the demanded accuracy, with the same error
+// criterion as qag_vec. Like qag_vec, the best estimate is returned and a
+// failure is recorded if the accuracy is not reached with laguerre_max_order.
+template <typename F>
+vec laguerre_vec(const F &f, uword n, double a, double decay, double relerr,
+                 const vec &epsabs, double alpha = 0) {
+  vec y(n);
+  auto rule = [&](const vec &nodes, const vec &weights, vec &result) -> void {
+    result.zeros();
+    for (uword i = 0; i < nodes.n_elem; i++) {
+      f(a + nodes(i) / decay, y);
+      result += weights(i) * y;
+    }
+  };
+
+  vec result, error;
+  size_t evaluations;
+  {
+    // mark integrations performed by the integrand as nested ones
+    IntegrationNesting nesting;
+    result = laguerre_adaptive(rule, n, decay, relerr, epsabs, alpha, error,
+                               evaluations);
+  }
+
+  // every evaluation of all n components counts as a single evaluation
+  record_integration(evaluations, 1, max(abs(result)), max(error),
+                     error_norm(error, result, relerr, epsabs) > 1);
+
+  return result;
+}
+
+template <typename F>
+vec laguerre_vec(const F &f, uword n, double a, double decay, double relerr,
+                 double epsabs, double alpha = 0) {
+  return laguerre_vec(f, n, a, decay, relerr, vec(epsabs * ones<vec>(n)),
+                      alpha);
+}
+
+// Gauss-Laguerre quadrature of the n-component function f over [a, infinity)
+// like laguerre_vec, but f is evaluated at all nodes of a rule at once, as in
+// qag_batch. The value of component j at node x(i) has to be stored in
+// y(i, j).
+template <typename F>
+vec laguerre_batch(const F &f, uword n, double a, double decay, double relerr,
+                   const vec &epsabs, double alpha = 0) {
+  mat fval;
+  auto rule = [&](const vec &nodes, const vec &weights, vec &result) -> void {
+    fval.set_size(nodes.n_elem, n);
+    f(a + nodes / decay, fval);
+    result = fval.t() * weights;
+  };
+
+  vec result, error;
+  size_t evaluations;
+  {
+    // mark integrations performed by the integrand as nested ones
+    IntegrationNesting nesting;
+    result = laguerre_adaptive(rule, n, decay, relerr, epsabs, alpha, error,
+                               evaluations);
+  }
+
+  // every node counts as one evaluation
+  record_integration(evaluations, 1, max(abs(result)), max(error),
+                     error_norm(error, result, relerr, epsabs) > 1);
+
+  return result;
+}
+
+// Gauss-Laguerre quadrature of the scalar function f over [a, infinity) like
+// laguerre_vec
+template <typename F>
+double laguerre(const F &f, double a, double decay, double relerr,
+                double epsabs, double alpha = 0) {
+  auto G = [&](double x, vec &y) -> void { y(0) = f(x); };
+  return laguerre_vec(G, 1, a, decay, relerr, epsabs, alpha)(0);
+}
+
+// wrapper for std::function
+vec laguerre_vec(const std::function<void(double, vec &)> &f, uword n,
+                 double a, double decay, double relerr, double epsabs);
+
+#endif // INTEGRATIONSLAGUERRE_H
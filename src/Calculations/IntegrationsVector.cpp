@@ -0,0 +1,83 @@
+#include "IntegrationsVector.h"
+
+// nodes and weights of the 15-point Gauss-Kronrod rule, see QUADPACK's qk15
+const vec::fixed<15> qk15_nodes = {
+    -0.991455371120812639206854697526329, -0.949107912342758524526189684047851,
+    -0.864864423359769072789712788640926, -0.741531185599394439863864773280788,
+    -0.586087235467691130294144845693013, -0.405845151377397166906606412076961,
+    -0.207784955007898467600689403773245, 0.000000000000000000000000000000000,
+    0.207784955007898467600689403773245,  0.405845151377397166906606412076961,
+    0.586087235467691130294144845693013,  0.741531185599394439863864773280788,
+    0.864864423359769072789712788640926,  0.949107912342758524526189684047851,
+    0.991455371120812639206854697526329};
+
+const vec::fixed<15> qk15_weights_kronrod = {
+    0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+    0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+    0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649, 0.209482141084727828012999174891714,
+    0.204432940075298892414161999234649, 0.190350578064785409913256402421014,
+    0.169004726639267902826583426598550, 0.140653259715525918745189590510238,
+    0.104790010322250183839876322541518, 0.063092092629978553290700663189204,
+    0.022935322010529224963732008058970};
+
+const vec::fixed<15> qk15_weights_gauss = {
+    0., 0.129484966168869693270611432679082,
+    0., 0.279705391489276667901467771423780,
+    0., 0.381830050505118944950369775488975,
+    0., 0.417959183673469387755102040816327,
+    0., 0.381830050505118944950369775488975,
+    0., 0.279705391489276667901467771423780,
+    0., 0.129484966168869693270611432679082,
+    0.};
+
+void qk15_estimate(double half, const vec &resk, const vec &resg,
+                   const vec &resabs, const vec &resasc, vec &result,
+                   vec &error, vec &roundoff) {
+  result = resk * half;
+  error = abs(resk - resg) * std::abs(half);
+  roundoff.zeros(result.n_elem);
+
+  // rescale error estimate as in QUADPACK's qk15
+  const double eps = std::numeric_limits<double>::epsilon();
+  for (uword j = 0; j < result.n_elem; j++) {
+    double abs_j = resabs(j) * std::abs(half);
+    double asc_j = resasc(j) * std::abs(half);
+    if (asc_j != 0 && error(j) != 0) {
+      error(j) = asc_j * std::min(1., std::pow(200 * error(j) / asc_j, 1.5));
+    }
+    if (abs_j > std::numeric_limits<double>::min() / (50 * eps)) {
+      roundoff(j) = 50 * eps * abs_j;
+      error(j) = std::max(roundoff(j), error(j));
+    }
+  }
+}
+
+double error_norm(const vec &error, const vec &total, double relerr,
+                  const vec &epsabs, const vec &roundoff) {
+  double norm = 0;
+  for (uword i = 0; i < error.n_elem; i++) {
+    bool at_roundoff = !roundoff.is_empty() && error(i) <= 2 * roundoff(i);
+    if (error(i) == 0 || at_roundoff) {
+      continue;
+    }
+    double tolerance = std::max(epsabs(i), relerr * std::abs(total(i)));
+    if (tolerance == 0) {
+      return std::numeric_limits<double>::infinity();
+    }
+    norm = std::max(norm, error(i) / tolerance);
+  }
+  return norm;
+}
+
+vec qag_vec(const std::function<void(double, vec &)> &f, uword n, double a,
+            double b, double relerr, double epsabs) {
+  return qag_vec<std::function<void(double, vec &)>>(f, n, a, b, relerr,
+                                                     epsabs);
+}
+
+vec qag_batch(const std::function<void(const vec &, mat &)> &f, uword n,
+              double a, double b, double relerr, double epsabs) {
+  return qag_batch<std::function<void(const vec &, mat &)>>(f, n, a, b, relerr,
+                                                           epsabs);
+}
@@ -0,0 +1,253 @@
+#ifndef INTEGRATIONSVECTOR_H
+#define INTEGRATIONSVECTOR_H
+
+#include <algorithm>
+#include <armadillo>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "Integrations.h"
+
+using namespace arma;
+
+// nodes of the 15-point Kronrod rule on [-1, 1] in ascending order, and the
+// weights of the Kronrod rule and of the embedded 7-point Gauss rule (zero at
+// the nodes that only belong to the Kronrod rule)
+extern const vec::fixed<15> qk15_nodes;
+extern const vec::fixed<15> qk15_weights_kronrod;
+extern const vec::fixed<15> qk15_weights_gauss;
+
+//! A subinterval of the adaptive vector-valued integration
+struct VectorInterval {
+  double a, b;       // integration limits
+  vec result, error; // integral and error estimate of each component
+  vec roundoff;      // round-off level of the error estimate of each component
+  double norm;       // norm of the error relative to the demanded accuracy
+};
+
+// Combines the Kronrod and Gauss estimates of an interval of half-length half
+// into the result and the error estimate of every component, where resabs and
+// resasc are the integrals of |f| and |f - resk / 2| used by QUADPACK to
+// rescale the error estimate. The error estimate is bounded from below by the
+// round-off level 50 eps int |f|, which is stored in roundoff.
+void qk15_estimate(double half, const vec &resk, const vec &resg,
+                   const vec &resabs, const vec &resasc, vec &result,
+                   vec &error, vec &roundoff);
+
+// Applies the 15-point Gauss-Kronrod rule to the n-component function f on
+// [a, b]. The function values at the nodes are stored in the columns of fval.
+template <typename F>
+void qk15_vec(const F &f, double a, double b, mat &fval, vec &result,
+              vec &error, vec &roundoff) {
+  double center = 0.5 * (a + b);
+  double half = 0.5 * (b - a);
+
+  // evaluate the integrand at all nodes of the rule
+  for (uword i = 0; i < 15; i++) {
+    vec y(fval.colptr(i), fval.n_rows, false, true);
+    f(center + half * qk15_nodes(i), y);
+  }
+
+  vec resk = fval * qk15_weights_kronrod;
+  qk15_estimate(half, resk, fval * qk15_weights_gauss,
+                abs(fval) * qk15_weights_kronrod,
+                abs(fval.each_col() - 0.5 * resk) * qk15_weights_kronrod,
+                result, error, roundoff);
+}
+
+// Applies the 15-point Gauss-Kronrod rule to the n-component function f on
+// [a, b], which is evaluated at all nodes at once. The nodes are handed to f
+// in the contiguous vector x and f has to store the value of component j at
+// node x(i) in fval(i, j).
+template <typename F>
+void qk15_batch(const F &f, double a, double b, vec &x, mat &fval, vec &result,
+                vec &error, vec &roundoff) {
+  double center = 0.5 * (a + b);
+  double half = 0.5 * (b - a);
+
+  // evaluate the integrand at all nodes of the rule
+  x = center + half * qk15_nodes;
+  f(x, fval);
+
+  vec resk = fval.t() * qk15_weights_kronrod;
+  qk15_estimate(half, resk, fval.t() * qk15_weights_gauss,
+                abs(fval).t() * qk15_weights_kronrod,
+                abs(fval.each_row() - 0.5 * resk.t()).t() *
+                    qk15_weights_kronrod,
+                result, error, roundoff);
+}
+
+// Norm of the error estimate relative to the demanded accuracy. Every
+// component is measured against its own tolerance max(epsabs, relerr*|R|),
+// such that components of very different magnitude are resolved equally well.
+// A component whose error estimate does not exceed twice its round-off level
+// is converged as well, such that a component that cancels to zero does not
+// demand an infinite accuracy. Without round-off levels only the tolerance is
+// checked. A norm below one means that all components have converged.
+double error_norm(const vec &error, const vec &total, double relerr,
+                  const vec &epsabs, const vec &roundoff = vec());
+
+// Adaptive bisection shared by qag_vec and qag_batch. The rule is called as
+// rule(a, b, result, error, roundoff) and has to store the integral over
+// [a, b], its error estimate and its round-off level of every component. The
+// error estimate and the round-off level of every component of the total
+// result and the number of subintervals are stored in error, roundoff and
+// n_intervals.
+template <typename Rule>
+vec qag_adaptive(const Rule &rule, uword n, double a, double b, double relerr,
+                 const vec &epsabs, vec &error, vec &roundoff,
+                 size_t &n_intervals) {
+  // maximal number of subintervals
+  const size_t limit = 1000;
+
+  // bisected intervals, ordered as a heap with respect to their error norm
+  std::vector<VectorInterval> intervals;
+  auto compare = [](const VectorInterval &l, const VectorInterval &r) {
+    return l.norm < r.norm;
+  };
+
+  VectorInterval first{a, b, vec(n), vec(n), vec(n), 0};
+  rule(a, b, first.result, first.error, first.roundoff);
+  vec total = first.result;
+  vec total_error = first.error;
+  vec total_roundoff = first.roundoff;
+  first.norm = error_norm(first.error, total, relerr, epsabs, first.roundoff);
+  intervals.push_back(first);
+
+  while (error_norm(total_error, total, relerr, epsabs, total_roundoff) > 1 &&
+         intervals.size() < limit) {
+    // take the interval with the largest error
+    std::pop_heap(intervals.begin(), intervals.end(), compare);
+    VectorInterval parent = intervals.back();
+    intervals.pop_back();
+
+    // stop if the interval can not be bisected any further
+    double mid = 0.5 * (parent.a + parent.b);
+    if (!(parent.a < mid && mid < parent.b)) {
+      intervals.push_back(parent);
+      break;
+    }
+
+    VectorInterval left{parent.a, mid, vec(n), vec(n), vec(n), 0};
+    VectorInterval right{mid, parent.b, vec(n), vec(n), vec(n), 0};
+    rule(left.a, left.b, left.result, left.error, left.roundoff);
+    rule(right.a, right.b, right.result, right.error, right.roundoff);
+
+    // update the total result, error and round-off level
+    total += left.result + right.result - parent.result;
+    total_error += left.error + right.error - parent.error;
+    total_roundoff += left.roundoff + right.roundoff - parent.roundoff;
+
+    left.norm = error_norm(left.error, total, relerr, epsabs, left.roundoff);
+    right.norm =
+        error_norm(right.error, total, relerr, epsabs, right.roundoff);
+    intervals.push_back(left);
+    std::push_heap(intervals.begin(), intervals.end(), compare);
+    intervals.push_back(right);
+    std::push_heap(intervals.begin(), intervals.end(), compare);
+  }
+
+  // sum up the results and errors of all intervals to avoid accumulated
+  // round-off
+  total.zeros();
+  error.zeros(n);
+  roundoff.zeros(n);
+  for (auto &interval : intervals) {
+    total += interval.result;
+    error += interval.error;
+    roundoff += interval.roundoff;
+  }
+  n_intervals = intervals.size();
+  return total;
+}
+
+// Adaptive vector-valued integration of the n-component function f over [a, b]
+// with one shared subdivision for all components. The function is called as
+// f(x, y) and has to write its n components at x into y. The interval with the
+// largest error norm is bisected until the error norm of the total result
+// falls below one. Similar to cquad, the best estimate is returned if the
+// demanded accuracy can not be reached within the maximal number of
+// subintervals, e.g. due to round-off in the integrand, and the call is
+// recorded as a failure in the integration diagnostics.
+template <typename F>
+vec qag_vec(const F &f, uword n, double a, double b, double relerr,
+            const vec &epsabs) {
+  // function values at the nodes of the rule
+  mat fval(n, 15);
+  auto rule = [&](double l, double r, vec &result, vec &error,
+                  vec &roundoff) -> void {
+    qk15_vec(f, l, r, fval, result, error, roundoff);
+  };
+
+  vec result, error, roundoff;
+  size_t intervals;
+  {
+    // mark integrations performed by the integrand as nested ones
+    IntegrationNesting nesting;
+    result = qag_adaptive(rule, n, a, b, relerr, epsabs, error, roundoff,
+                          intervals);
+  }
+
+  // the diagnostics are recorded in the maximum norm over the components.
+  // Every evaluation of all n components counts as a single evaluation.
+  record_integration(15 * (2 * intervals - 1), intervals, max(abs(result)),
+                     max(error),
+                     error_norm(error, result, relerr, epsabs, roundoff) > 1);
+
+  return result;
+}
+
+template <typename F>
+vec qag_vec(const F &f, uword n, double a, double b, double relerr,
+            double epsabs) {
+  return qag_vec(f, n, a, b, relerr, vec(epsabs * ones<vec>(n)));
+}
+
+// Adaptive vector-valued integration of the n-component function f over [a, b]
+// like qag_vec, but f is evaluated at all 15 nodes of the rule at once. It is
+// called as f(x, y), where x holds the nodes contiguously and the value of
+// component j at node x(i) has to be stored in y(i, j). This allows to write
+// the integrand as a loop over the nodes, which the compiler can vectorize.
+template <typename F>
+vec qag_batch(const F &f, uword n, double a, double b, double relerr,
+              const vec &epsabs) {
+  // nodes and function values of the rule
+  vec x(15);
+  mat fval(15, n);
+  auto rule = [&](double l, double r, vec &result, vec &error,
+                  vec &roundoff) -> void {
+    qk15_batch(f, l, r, x, fval, result, error, roundoff);
+  };
+
+  vec result, error, roundoff;
+  size_t intervals;
+  {
+    // mark integrations performed by the integrand as nested ones
+    IntegrationNesting nesting;
+    result = qag_adaptive(rule, n, a, b, relerr, epsabs, error, roundoff,
+                          intervals);
+  }
+
+  // every node counts as one evaluation
+  record_integration(15 * (2 * intervals - 1), intervals, max(abs(result)),
+                     max(error),
+                     error_norm(error, result, relerr, epsabs, roundoff) > 1);
+
+  return result;
+}
+
+template <typename F>
+vec qag_batch(const F &f, uword n, double a, double b, double relerr,
+              double epsabs) {
+  return qag_batch(f, n, a, b, relerr, vec(epsabs * ones<vec>(n)));
+}
+
+// wrapper for std::function
+vec qag_vec(const std::function<void(double, vec &)> &f, uword n, double a,
+            double b, double relerr, double epsabs);
+vec qag_batch(const std::function<void(const vec &, mat &)> &f, uword n,
+              double a, double b, double relerr, double epsabs);
+
+#endif // INTEGRATIONSVECTOR_H
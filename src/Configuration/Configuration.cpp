@@ -0,0 +1,21 @@
+#include <utility>
+
+// json parser
+#include <boost/property_tree/json_parser.hpp>
+namespace pt = boost::property_tree;
+
+#include "Configuration.h"
+
+Configuration::Configuration(const std::string &input_file) {
+  // Load the json file in the root
+  pt::read_json(input_file, root);
+}
+
+Configuration::Configuration(pt::ptree root) : root(std::move(root)) {}
+
+Configuration Configuration::with_reflection_coefficients(
+    std::shared_ptr<ReflectionCoefficients> reflection_coefficients) const {
+  Configuration copy(*this);
+  copy.reflection_coefficients = std::move(reflection_coefficients);
+  return copy;
+}
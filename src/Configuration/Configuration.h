@@ -0,0 +1,50 @@
+#ifndef CONFIGURATION_H
+#define CONFIGURATION_H
+
+#include <memory>
+#include <string>
+
+// json parser
+#include <boost/property_tree/ptree.hpp>
+
+class ReflectionCoefficients;
+
+//! A parsed json input file
+/*!
+ * The configuration reads an input file once, such that all models of a
+ * calculation are constructed from the same tree. Every factory and every
+ * constructor that reads an input file accepts a configuration, the
+ * constructors from a file path parse the file and pass it on. A
+ * configuration is not changed after its construction, hence it can be
+ * shared by threads. Models that are expensive to build or hold state that
+ * should be shared, e.g. a cache of the reflection coefficients, can be built
+ * once and handed to all models constructed from a configuration.
+ */
+class Configuration {
+private:
+  boost::property_tree::ptree root; // tree of the input file
+
+  // reflection coefficients used by all models constructed from this
+  // configuration instead of building their own from the tree
+  std::shared_ptr<ReflectionCoefficients> reflection_coefficients;
+
+public:
+  // parse the json input file
+  explicit Configuration(const std::string &input_file);
+
+  // configuration of an already parsed tree
+  explicit Configuration(boost::property_tree::ptree root);
+
+  // copy of the configuration, whose models share the given reflection
+  // coefficients
+  Configuration with_reflection_coefficients(
+      std::shared_ptr<ReflectionCoefficients> reflection_coefficients) const;
+
+  // getter functions
+  const boost::property_tree::ptree &get_root() const { return root; };
+  std::shared_ptr<ReflectionCoefficients> get_reflection_coefficients() const {
+    return reflection_coefficients;
+  };
+};
+
+#endif // CONFIGURATION_H
@@ -1,4 +1,7 @@
 #include <algorithm>
+#include <cassert>
+#include <deque>
+#include <unordered_map>
 #include <vector>
 
 #include <armadillo>
@@ -9,19 +12,35 @@ using namespace arma;
 #include <boost/property_tree/ptree.hpp>
 namespace pt = boost::property_tree;
 
+#include "../Calculations/IntegrationsVector.h"
 #include "../GreensTensor/GreensTensorFactory.h"
+#include "../GreensTensor/GreensTensorPlate.h"
 #include "Friction.h"
 
-Friction::Friction(const std::string &input_file) {
-  // Create a root
-  pt::ptree root;
+Friction::Friction(const std::string &input_file)
+    : Friction(Configuration(input_file)) {}
 
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+Friction::Friction(const Configuration &configuration) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
   this->relerr_omega = root.get<double>("Friction.relerr_omega");
+  this->tail_quadrature = quadrature_option(
+      root.get<std::string>("Friction.tail_quadrature", "adaptive"));
+  std::string omega_integrator =
+      root.get<std::string>("Friction.omega_integrator", "pointwise");
+  if (omega_integrator == "pointwise") {
+    this->omega_integrator = OMEGA_POINTWISE;
+  } else if (omega_integrator == "batch") {
+    this->omega_integrator = OMEGA_BATCH;
+  } else {
+    std::cerr << "Error: Unknown omega integrator (" << omega_integrator
+              << ")!" << std::endl;
+    exit(0);
+  }
+  this->task_parallel = root.get<bool>("Friction.task_parallel", false);
 
   // read greens tensor
-  this->powerspectrum = std::make_shared<PowerSpectrum>(input_file);
+  this->powerspectrum = std::make_shared<PowerSpectrum>(configuration);
   this->polarizability = powerspectrum->get_polarizability();
   this->greens_tensor = powerspectrum->get_greens_tensor();
 }
@@ -34,95 +53,408 @@ Friction::Friction(std::shared_ptr<GreensTensor> greens_tensor,
       powerspectrum(powerspectrum), relerr_omega(relerr_omega) {}
 
 double Friction::calculate(Spectrum_Options spectrum) const {
+  return this->calculate(spectrum, greens_tensor->get_parameters());
+}
+
+double Friction::calculate(Spectrum_Options spectrum,
+                           const EvaluationParameters &parameters) const {
   double result;
-  double omega_a = this->polarizability->get_omega_a();
-  // Collect all specifically relevant point within the integration
-  std::vector<double> lim = {0., 0.99 * omega_a, 1.001 * omega_a,
-                             this->greens_tensor->omega_ch()};
-  // Sort the points and erase duplicates
-  std::sort(lim.begin(), lim.end());
-  auto last = std::unique(lim.begin(), lim.end());
-  lim.erase(last, lim.end());
+  // Collect all specifically relevant point within the integration, the
+  // characteristic frequency depends on the velocity and the distance
+  double omega_ch = greens_tensor->has_parameters(parameters)
+                        ? greens_tensor->omega_ch()
+                        : greens_tensor->with_parameters(parameters)->omega_ch();
+  std::vector<double> lim = omega_bounds({0., omega_ch}, parameters);
 
   // Start integration
   result = 0.;
-  auto F = [=](double x) -> double { return friction_integrand(x, spectrum); };
+  auto F = [&](double x) -> double {
+    return friction_integrand(x, spectrum, parameters);
+  };
+
+  if (omega_integrator == OMEGA_BATCH) {
+    // every rule evaluates the integrand at its 15 frequencies at once
+    auto F_batch = [&](const vec &x, mat &values) -> void {
+      vec y;
+      this->friction_integrand_batch(x, spectrum, parameters, y);
+      values.col(0) = y;
+    };
+    for (int i = 0; i < (int)lim.size() - 1; i++) {
+      result += qag_batch(F_batch, 1, lim[i], lim[i + 1], relerr_omega,
+                          std::abs(result) * relerr_omega)(0);
+    }
+    // Perform last integration from the last significant point to infinity,
+    // the nodes of the double-exponential quadrature are not grouped into
+    // rules, hence it evaluates the integrand frequency by frequency
+    double a = lim[lim.size() - 1];
+    if (tail_quadrature == DOUBLE_EXPONENTIAL) {
+      result += exp_sinh(F, a, relerr_omega, std::abs(result) * relerr_omega);
+      return result;
+    }
+    // the substitution omega = a + (1 - t) / t of qagiu
+    auto G_batch = [&](const vec &t, mat &values) -> void {
+      F_batch(a + (1 - t) / t, values);
+      values.col(0) /= t % t;
+    };
+    result += qag_batch(G_batch, 1, 0, 1, relerr_omega,
+                        std::abs(result) * relerr_omega)(0);
+    return result;
+  }
+
+  if (task_parallel) {
+    // The pieces and the tail are independent tasks, which only use their
+    // relative tolerance. The tasks created by the Green's tensor within the
+    // integrand are executed by the same team.
+    std::vector<double> pieces(lim.size());
+    std::vector<IntegrationDiagnostics> lanes(lim.size());
+#pragma omp parallel
+#pragma omp single
+    for (size_t i = 0; i < lim.size(); i++) {
+#pragma omp task default(shared) firstprivate(i)
+      {
+        IntegrationDiagnosticsLane lane(lanes[i]);
+        if (i + 1 < lim.size()) {
+          pieces[i] = cquad(F, lim[i], lim[i + 1], relerr_omega, 0);
+        } else if (tail_quadrature == DOUBLE_EXPONENTIAL) {
+          pieces[i] = exp_sinh(F, lim[i], relerr_omega, 0);
+        } else {
+          pieces[i] = qagiu(F, lim[i], relerr_omega, 0);
+        }
+      }
+    }
+
+    // sum up in a fixed order, such that the result does not depend on the
+    // number of threads
+    for (size_t i = 0; i < lim.size(); i++) {
+      record_diagnostics(lanes[i]);
+      result += pieces[i];
+    }
+    return result;
+  }
 
   for (int i = 0; i < (int)lim.size() - 1; i++) {
     result += cquad(F, lim[i], lim[i + 1], relerr_omega,
                     std::abs(result) * relerr_omega);
   }
   // Perform last integration from the last significant point to infinity
-  result += qagiu(F, lim[lim.size() - 1], relerr_omega,
-                  std::abs(result) * relerr_omega);
+  if (tail_quadrature == DOUBLE_EXPONENTIAL) {
+    result += exp_sinh(F, lim[lim.size() - 1], relerr_omega,
+                       std::abs(result) * relerr_omega);
+  } else {
+    result += qagiu(F, lim[lim.size() - 1], relerr_omega,
+                    std::abs(result) * relerr_omega);
+  }
   return result;
 }
 
+vec Friction::calculate(Spectrum_Options spectrum,
+                       const std::vector<double> &distances) const {
+  auto plate = std::dynamic_pointer_cast<GreensTensorPlate>(greens_tensor);
+  if (plate == nullptr) {
+    std::cerr << "You try to calculate several distances at once, but did not "
+                 "give a plate Green's tensor."
+              << std::endl;
+    exit(-1);
+  }
+
+  // Collect all specifically relevant point within the integration, the
+  // characteristic frequency of every distance included
+  std::vector<double> lim = {0.};
+  for (double za : distances) {
+    lim.push_back(plate->get_delta_cut() * plate->get_v() / za);
+  }
+
+  // the friction at all distances is integrated jointly
+  auto F = [&](double x, vec &values) -> void {
+    this->friction_integrand(x, spectrum, distances, values);
+  };
+  return integrate_omega(F, distances.size(), lim);
+}
+
+vec Friction::calculate_temperatures(Spectrum_Options spectrum,
+                                     const std::vector<double> &betas) const {
+  // Collect all specifically relevant point within the integration
+  std::vector<double> lim = {0., this->greens_tensor->omega_ch()};
+
+  // the friction at all temperatures is integrated jointly
+  auto F = [&](double x, vec &values) -> void {
+    this->friction_integrand_temperatures(x, spectrum, betas, values);
+  };
+  return integrate_omega(F, betas.size(), lim);
+}
+
+std::vector<double>
+Friction::omega_bounds(std::vector<double> lim,
+                       const EvaluationParameters &parameters) const {
+  std::vector<double> points =
+      polarizability->omega_breakpoints(0, INFINITY, parameters);
+  append_breakpoints(greens_tensor->has_parameters(parameters)
+                         ? greens_tensor->characteristic_frequencies()
+                         : greens_tensor->with_parameters(parameters)
+                               ->characteristic_frequencies(),
+                     0, INFINITY, points);
+  for (double omega : omega_breakpoints) {
+    if (omega > 0) {
+      points.push_back(omega);
+    }
+  }
+  lim.insert(lim.end(), points.begin(), points.end());
+
+  // Sort the points and erase duplicates
+  std::sort(lim.begin(), lim.end());
+  auto last = std::unique(lim.begin(), lim.end());
+  lim.erase(last, lim.end());
+  return lim;
+}
+
+vec Friction::integrate_omega(const std::function<void(double, vec &)> &F,
+                              uword n, std::vector<double> lim) const {
+  lim = omega_bounds(lim, greens_tensor->get_parameters());
+
+  // The integrand of all components is evaluated at once and memorized, such
+  // that the nodes shared by the quadratures of the components are evaluated
+  // only once.
+  std::unordered_map<double, vec> values;
+  auto evaluate = [&](double x) -> const vec & {
+    auto entry = values.find(x);
+    if (entry == values.end()) {
+      vec value;
+      F(x, value);
+      entry = values.emplace(x, std::move(value)).first;
+    }
+    return entry->second;
+  };
+
+  // every component is integrated by the quadratures of the pointwise
+  // integration
+  vec result(n, fill::zeros);
+  for (uword j = 0; j < n; j++) {
+    auto G = [&](double x) -> double { return evaluate(x)(j); };
+    for (int i = 0; i < (int)lim.size() - 1; i++) {
+      result(j) += cquad(G, lim[i], lim[i + 1], relerr_omega,
+                         std::abs(result(j)) * relerr_omega);
+    }
+    // Perform last integration from the last significant point to infinity
+    if (tail_quadrature == DOUBLE_EXPONENTIAL) {
+      result(j) += exp_sinh(G, lim[lim.size() - 1], relerr_omega,
+                            std::abs(result(j)) * relerr_omega);
+    } else {
+      result(j) += qagiu(G, lim[lim.size() - 1], relerr_omega,
+                         std::abs(result(j)) * relerr_omega);
+    }
+  }
+  return result;
+}
+
+double Friction::calculate(Spectrum_Options spectrum,
+                           IntegrationDiagnostics &diagnostics) const {
+  IntegrationDiagnosticsScope scope(diagnostics);
+  return this->calculate(spectrum);
+}
+
 double Friction::friction_integrand(double omega,
                                     Spectrum_Options spectrum) const {
-  // Compute the full spectrum of the power spectrum
-  if (spectrum == FULL) {
+  return this->friction_integrand(omega, spectrum,
+                                  greens_tensor->get_parameters());
+}
 
-    // Initialize all tensors
-    cx_mat::fixed<3, 3> green_kv(fill::zeros);
-    cx_mat::fixed<3, 3> green_temp_kv(fill::zeros);
-    cx_mat::fixed<3, 3> alpha_I(fill::zeros);
-    cx_mat::fixed<3, 3> powerspec(fill::zeros);
+double Friction::friction_integrand(
+    double omega, Spectrum_Options spectrum,
+    const EvaluationParameters &parameters) const {
+  EvaluationContext context(omega, parameters);
+  if (greens_record == nullptr || !greens_tensor->has_parameters(parameters)) {
+    return this->friction_integrand(context, spectrum);
+  }
 
-    // computation of the Green's tensor in the first term of eq. (4.3)
-    greens_tensor->integrate_k(omega, green_kv, IM, KV);
+  // the integrals of the Green's tensor do not depend on the particle, hence
+  // they are taken from the record if this frequency has been visited before
+  std::vector<GreensTensorIntegral> integrals;
+  bool recorded = greens_record->find(omega, integrals);
+  for (const GreensTensorIntegral &integral : integrals) {
+    context.store(*greens_tensor, integral);
+  }
 
-    // computation of the Green's tensor in the second term of eq. (4.3)
-    greens_tensor->integrate_k(omega, green_temp_kv, IM, KV_TEMP);
+  double result = this->friction_integrand(context, spectrum);
 
-    // computation of the imaginary part of the polarizability appearing in the
-    // second term of eq. (4.3)
-    polarizability->calculate_tensor(omega, alpha_I, IM);
+  if (!recorded || context.get_passes() > 0) {
+    greens_record->store(omega, context.integrated(*greens_tensor));
+  }
+  return result;
+}
 
-    // computation of the powerspectrum apperaing in the first term of eq. (4.3)
-    powerspectrum->calculate(omega, powerspec, FULL);
+void Friction::friction_integrand_batch(const vec &omegas,
+                                        Spectrum_Options spectrum,
+                                        vec &result) const {
+  this->friction_integrand_batch(omegas, spectrum,
+                                 greens_tensor->get_parameters(), result);
+}
 
-    return real(2. * trace(-powerspec * green_kv +
-                           1. / M_PI * alpha_I * green_temp_kv));
+void Friction::friction_integrand_batch(const vec &omegas,
+                                        Spectrum_Options spectrum,
+                                        const EvaluationParameters &parameters,
+                                        vec &result) const {
+  // the record only holds integrals at the own parameters
+  bool record = greens_record != nullptr &&
+                greens_tensor->has_parameters(parameters);
+
+  // a deque keeps the addresses of the contexts valid
+  std::deque<EvaluationContext> contexts;
+  std::vector<EvaluationContext *> pointers;
+  std::vector<bool> recorded(omegas.n_elem, false);
+  for (uword j = 0; j < omegas.n_elem; j++) {
+    contexts.emplace_back(omegas(j), parameters);
+    pointers.push_back(&contexts.back());
+
+    // take the integrals of frequencies visited before from the record
+    if (record) {
+      std::vector<GreensTensorIntegral> integrals;
+      recorded[j] = greens_record->find(omegas(j), integrals);
+      for (const GreensTensorIntegral &integral : integrals) {
+        contexts.back().store(*greens_tensor, integral);
+      }
+    }
+    this->request(contexts.back(), spectrum);
   }
-  // Compute onyl the non-LTE contribution of the power-spectrum
-  else if (spectrum == NON_LTE_ONLY) {
-    // Initialize all tensors
-    cx_mat::fixed<3, 3> J(fill::zeros);
-    cx_mat::fixed<3, 3> green_kv(fill::zeros);
-    cx_mat::fixed<3, 3> alpha_fancy_I(fill::zeros);
-    cx_mat::fixed<3, 3> green_fancy_I_kv_non_LTE(fill::zeros);
 
-    // Compute the Green's tensor in the first term of eq. (4.5)
-    greens_tensor->integrate_k(omega, green_kv, IM, KV);
+  // integrate the missing integrals of every Green's tensor at all
+  // frequencies together
+  std::vector<const GreensTensor *> greens_tensors = {
+      greens_tensor.get(), powerspectrum->get_greens_tensor().get(),
+      polarizability->get_greens_tensor().get()};
+  for (size_t i = 0; i < greens_tensors.size(); i++) {
+    if (std::find(greens_tensors.begin(), greens_tensors.begin() + i,
+                  greens_tensors[i]) == greens_tensors.begin() + i) {
+      EvaluationContext::integrate_pending(pointers, *greens_tensors[i]);
+    }
+  }
 
-    // Compute the Green's tensor in the second term of eq. (4.5)
-    // the \Sigma distribution is already included here
-    greens_tensor->integrate_k(omega, green_fancy_I_kv_non_LTE, IM, KV_NON_LTE);
+  result.set_size(omegas.n_elem);
+  for (uword j = 0; j < omegas.n_elem; j++) {
+    result(j) = this->friction_integrand(contexts[j], spectrum);
+    if (record && (!recorded[j] || contexts[j].get_passes() > 0)) {
+      greens_record->store(omegas(j), contexts[j].integrated(*greens_tensor));
+    }
+  }
+}
 
-    // Compute the power spectrum for the first term of eq. (4.5)
-    powerspectrum->calculate(omega, J, NON_LTE_ONLY);
+void Friction::request(EvaluationContext &context,
+                       Spectrum_Options spectrum) const {
+  // If the power spectrum and the polarizability share the Green's tensor,
+  // all Green's tensors of eq. (4.3) or (4.5) are integrated in a single pass.
+  Weight_Options weight_function = spectrum == FULL ? KV_TEMP : KV_NON_LTE;
+  context.request(*greens_tensor, {{IM, KV}, {IM, weight_function}});
+  powerspectrum->request(context);
+  polarizability->request(context);
+}
+
+void Friction::friction_integrand(double omega, Spectrum_Options spectrum,
+                                  const std::vector<double> &distances,
+                                  vec &result) const {
+  auto plate = std::dynamic_pointer_cast<GreensTensorPlate>(greens_tensor);
+  assert(plate != nullptr);
+  assert(powerspectrum->get_greens_tensor() == greens_tensor &&
+         polarizability->get_greens_tensor() == greens_tensor);
+
+  // all Green's tensors of eq. (4.3) or (4.5) at all distances in a single
+  // pass, in the order in which friction_integrand requests them
+  Weight_Options weight_function = spectrum == FULL ? KV_TEMP : KV_NON_LTE;
+  std::vector<GreensTensorRequest> requests = {{IM, KV},
+                                               {IM, weight_function},
+                                               {IM, NON_LTE},
+                                               {RE, UNIT},
+                                               {IM, UNIT}};
+  std::vector<std::vector<cx_mat::fixed<3, 3>>> greens;
+  plate->integrate_k(omega, requests, distances, greens);
 
-    // Compute the polarizability for the second term of eq. (4.5)
-    polarizability->calculate_tensor(omega, alpha_fancy_I, IM);
+  // the remaining algebra is done separately for every distance
+  result.set_size(distances.size());
+  for (uword j = 0; j < distances.size(); j++) {
+    EvaluationContext context(omega);
+    for (uword i = 0; i < requests.size(); i++) {
+      context.store(*greens_tensor, {requests[i], greens[j][i]});
+    }
+    result(j) = this->friction_integrand(context, spectrum);
+  }
+}
 
-    // Put everything together
-    return real(
-        trace(2. *
-              (-J * green_kv + alpha_fancy_I * green_fancy_I_kv_non_LTE)));
+void Friction::friction_integrand_temperatures(
+    double omega, Spectrum_Options spectrum, const std::vector<double> &betas,
+    vec &result) const {
+  // The Green's tensors of eq. (4.3) or (4.5) without a temperature-dependent
+  // weight are shared by all temperatures, the remaining ones are requested
+  // for every temperature. All of them are integrated in a single pass.
+  Weight_Options weight_function = spectrum == FULL ? KV_TEMP : KV_NON_LTE;
+  std::vector<GreensTensorRequest> shared = {{IM, KV}, {RE, UNIT}, {IM, UNIT}};
+  std::vector<GreensTensorRequest> requests = shared;
+  for (double beta : betas) {
+    assert(beta > 0);
+    requests.push_back({IM, weight_function, beta});
+    requests.push_back({IM, NON_LTE, beta});
   }
+  std::vector<cx_mat::fixed<3, 3>> greens;
+  greens_tensor->integrate_k(omega, requests, greens);
+
+  // the remaining algebra is done separately for every temperature, whose
+  // context also provides the temperature of the power spectrum
+  uword m = shared.size();
+  result.set_size(betas.size());
+  for (uword j = 0; j < betas.size(); j++) {
+    EvaluationContext context(omega, betas[j]);
+    for (uword i = 0; i < m; i++) {
+      context.store(*greens_tensor, {shared[i], greens[i]});
+    }
+    context.store(*greens_tensor,
+                  {{IM, weight_function}, greens[m + 2 * j]});
+    context.store(*greens_tensor, {{IM, NON_LTE}, greens[m + 2 * j + 1]});
+    result(j) = this->friction_integrand(context, spectrum);
+  }
+}
+
+double Friction::friction_integrand(EvaluationContext &context,
+                                    Spectrum_Options spectrum) const {
   // Ensure that a valid integration argument has been passed
-  else {
+  if (spectrum != FULL && spectrum != NON_LTE_ONLY) {
     std::cerr << "No valid option for the calculation of quantum friction have "
                  "been passed"
               << std::endl;
     exit(0);
   }
+
+  // the weight of the Green's tensor in the second term of eq. (4.3) or
+  // (4.5), the \Sigma distribution is already included in the non-LTE weight
+  Weight_Options weight_function = spectrum == FULL ? KV_TEMP : KV_NON_LTE;
+
+  // Announce all integrals first
+  this->request(context, spectrum);
+
+  // the power spectrum of the first term and the fancy imaginary part of the
+  // polarizability of the second term, both derived from the same complex
+  // polarizability if it is shared
+  cx_mat::fixed<3, 3> powerspec, alpha_I;
+  powerspectrum->calculate(context, powerspec, spectrum);
+  polarizability->calculate_tensor(context, alpha_I, IM);
+
+  const cx_mat::fixed<3, 3> &green_kv = context.greens(*greens_tensor, IM, KV);
+  const cx_mat::fixed<3, 3> &green_weight =
+      context.greens(*greens_tensor, IM, weight_function);
+
+  if (spectrum == FULL) {
+    return real(2. * trace(-powerspec * green_kv +
+                           1. / M_PI * alpha_I * green_weight));
+  }
+  return real(trace(2. * (-powerspec * green_kv + alpha_I * green_weight)));
 }
 
 void Friction::print_info(std::ostream &stream) const {
   stream << "# Friction\n#\n"
-  << "# relerr_omega = " << relerr_omega << "\n";
+  << "# relerr_omega = " << relerr_omega << "\n"
+  << "# tail_quadrature = "
+  << (tail_quadrature == DOUBLE_EXPONENTIAL ? "double exponential"
+                                            : "adaptive")
+  << "\n"
+  << "# omega_integrator = "
+  << (omega_integrator == OMEGA_BATCH ? "batch" : "pointwise") << "\n"
+  << "# task_parallel = " << (task_parallel ? "true" : "false") << "\n";
  greens_tensor->print_info(stream);
  polarizability->print_info(stream);
  powerspectrum->print_info(stream);
@@ -1,10 +1,20 @@
 #ifndef QUANTUMFRICTION_H
 #define QUANTUMFRICTION_H
 
+#include "../Configuration/Configuration.h"
 #include "../GreensTensor/GreensTensor.h"
+#include "../GreensTensor/GreensTensorRecord.h"
 #include "../Polarizability/Polarizability.h"
 #include "../PowerSpectrum/PowerSpectrum.h"
+#include <functional>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
+
+// Enum variables for the evaluation of the omega integrand, either frequency
+// by frequency or at all frequencies of a Gauss-Kronrod rule at once
+enum Omega_Integrator_Options { OMEGA_POINTWISE, OMEGA_BATCH };
 
 /*!
  * This is a class computing the quantum friction force for a given Green's
@@ -19,21 +29,148 @@ protected:
 
   double relerr_omega;
 
+  // quadrature of the omega integral from the last breakpoint to infinity
+  Quadrature_Options tail_quadrature = ADAPTIVE;
+
+  // evaluation of the omega integrand, either frequency by frequency or for
+  // all frequencies of a Gauss-Kronrod rule at once
+  Omega_Integrator_Options omega_integrator = OMEGA_POINTWISE;
+
+  // if true, the pieces of the pointwise omega integration are OpenMP tasks,
+  // which are executed by a parallel region opened by calculate
+  bool task_parallel = false;
+
+  // optional record of the integrals of the Green's tensor, which are reused
+  // at frequencies that have been visited before
+  std::shared_ptr<GreensTensorRecord> greens_record;
+
+  // additional breakpoints of the omega integration
+  std::vector<double> omega_breakpoints;
+
+  // Returns the sorted boundaries of the pieces of the omega integration. They
+  // consist of the points lim, the breakpoints of the polarizability, the
+  // characteristic frequencies of the Green's tensor at the parameters and
+  // the additional breakpoints.
+  std::vector<double> omega_bounds(std::vector<double> lim,
+                                   const EvaluationParameters &parameters)
+      const;
+
+  // integrate the n components of F over omega from zero to infinity, split
+  // at the omega_bounds of lim. Every component is integrated like the
+  // pointwise integrand, where F is evaluated only once at every node.
+  vec integrate_omega(const std::function<void(double, vec &)> &F, uword n,
+                      std::vector<double> lim) const;
+
 public:
   Friction(const std::string &input_file);
+  explicit Friction(const Configuration &configuration);
   Friction(std::shared_ptr<GreensTensor> greens_tensor,
            std::shared_ptr<Polarizability> polarizability,
            std::shared_ptr<PowerSpectrum> powerspectrum, double relerr_omega);
 
   double calculate(Spectrum_Options spectrum) const;
+
+  // calculate the friction force with the Green's tensor evaluated at the
+  // given parameters instead of its own ones. None of the models is changed,
+  // hence a single friction object can serve several threads that calculate
+  // different parameters. The record of the Green's tensor integrals is only
+  // used if the parameters agree with the ones of the Green's tensor.
+  double calculate(Spectrum_Options spectrum,
+                   const EvaluationParameters &parameters) const;
+
+  // calculate the friction force and collect the diagnostics of all involved
+  // integrations
+  double calculate(Spectrum_Options spectrum,
+                   IntegrationDiagnostics &diagnostics) const;
+  // calculate the friction force above a plate for several distances at
+  // once. The integrals of the plate's Green's tensor at all distances share
+  // their nodes and the omega integration of every distance is refined until
+  // it converges. The Green's tensor must be shared by the power spectrum and
+  // the polarizability.
+  vec calculate(Spectrum_Options spectrum,
+                const std::vector<double> &distances) const;
+
+  // calculate the friction force for several inverse temperatures betas at
+  // once. The weights of the Green's tensors are the only dependence on the
+  // temperature, hence the integrals of all temperatures share the kernel
+  // evaluations and those without a temperature-dependent weight are
+  // computed only once.
+  vec calculate_temperatures(Spectrum_Options spectrum,
+                             const std::vector<double> &betas) const;
+
   double friction_integrand(double omega, Spectrum_Options spectrum) const;
 
+  // integrand with the Green's tensor evaluated at the given parameters
+  double friction_integrand(double omega, Spectrum_Options spectrum,
+                            const EvaluationParameters &parameters) const;
+
+  // integrand at a block of frequencies, stored in result. The integrals of
+  // the Green's tensors at all frequencies are computed by integrate_k_batch,
+  // such that the frequencies of the block are integrated concurrently.
+  void friction_integrand_batch(const vec &omegas, Spectrum_Options spectrum,
+                                vec &result) const;
+
+  // integrand at a block of frequencies with the Green's tensor evaluated at
+  // the given parameters
+  void friction_integrand_batch(const vec &omegas, Spectrum_Options spectrum,
+                                const EvaluationParameters &parameters,
+                                vec &result) const;
+
+  // announce all integrals of the Green's tensors needed by the integrand
+  void request(EvaluationContext &context, Spectrum_Options spectrum) const;
+
+  // integrand at several distances of the plate, stored in result
+  void friction_integrand(double omega, Spectrum_Options spectrum,
+                          const std::vector<double> &distances,
+                          vec &result) const;
+
+  // integrand at several inverse temperatures, stored in result
+  void friction_integrand_temperatures(double omega, Spectrum_Options spectrum,
+                                       const std::vector<double> &betas,
+                                       vec &result) const;
+
+  // integrand at the frequency of the context, the integrals of the Green's
+  // tensors and the polarizability are computed once and stored in it
+  double friction_integrand(EvaluationContext &context,
+                            Spectrum_Options spectrum) const;
+
   // getter functions
   std::shared_ptr<GreensTensor> get_greens_tensor() { return greens_tensor; };
   std::shared_ptr<Polarizability> get_polarizability() {
     return polarizability;
   };
   std::shared_ptr<PowerSpectrum> get_powerspectrum() { return powerspectrum; };
+  double get_relerr_omega() const { return relerr_omega; };
+  Quadrature_Options get_tail_quadrature() const { return tail_quadrature; };
+  Omega_Integrator_Options get_omega_integrator() const {
+    return omega_integrator;
+  };
+  bool get_task_parallel() const { return task_parallel; };
+  std::shared_ptr<GreensTensorRecord> get_greens_record() const {
+    return greens_record;
+  };
+  std::vector<double> get_omega_breakpoints() const {
+    return omega_breakpoints;
+  };
+
+  // setter functions
+  void set_tail_quadrature(Quadrature_Options tail_quadrature_new) {
+    this->tail_quadrature = tail_quadrature_new;
+  };
+  void set_omega_integrator(Omega_Integrator_Options omega_integrator_new) {
+    this->omega_integrator = omega_integrator_new;
+  };
+  void set_task_parallel(bool task_parallel_new) {
+    this->task_parallel = task_parallel_new;
+  };
+  // the record must only be shared by calculations with the same Green's
+  // tensor, nullptr disables it
+  void set_greens_record(std::shared_ptr<GreensTensorRecord> greens_record_new) {
+    this->greens_record = std::move(greens_record_new);
+  };
+  void set_omega_breakpoints(std::vector<double> omega_breakpoints_new) {
+    this->omega_breakpoints = std::move(omega_breakpoints_new);
+  };
 
   // print info
   void print_info(std::ostream &stream) const;
@@ -1,3 +1,5 @@
+#include <iostream>
+
 // json parser
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
@@ -10,16 +12,154 @@ GreensTensor::GreensTensor(double v, double beta) : v(v), beta(beta) {
   assert(beta > 0);
 }
 
-GreensTensor::GreensTensor(const std::string& input_file) {
-  // Create a root
-  pt::ptree root;
+GreensTensor::GreensTensor(const std::string &input_file)
+    : GreensTensor(Configuration(input_file)) {}
 
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+GreensTensor::GreensTensor(const Configuration &configuration) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
 
   // read parameters
   this->v = root.get<double>("GreensTensor.v");
   assert(v >= 0 && v < 1);
   this->beta = root.get<double>("GreensTensor.beta");
   assert(beta > 0);
+
+  // read the optional evaluation scheme of the integrands
+  std::string integrator =
+      root.get<std::string>("GreensTensor.integrator", "pointwise");
+  if (integrator == "pointwise") {
+    this->integrator = POINTWISE;
+  } else if (integrator == "vector") {
+    this->integrator = VECTOR;
+  } else if (integrator == "batch") {
+    this->integrator = BATCH;
+  } else if (integrator == "cubature") {
+    this->integrator = CUBATURE;
+  } else {
+    std::cerr << "Error: Unknown integrator (" << integrator << ")!"
+              << std::endl;
+    exit(0);
+  }
+}
+
+void GreensTensor::integrate_k(double omega, cx_mat::fixed<3, 3> &GT,
+                               Tensor_Options fancy_complex,
+                               Weight_Options weight_function,
+                               IntegrationDiagnostics &diagnostics) const {
+  IntegrationDiagnosticsScope scope(diagnostics);
+  this->integrate_k(omega, GT, fancy_complex, weight_function);
+}
+
+void GreensTensor::integrate_k(double omega,
+                               const std::vector<GreensTensorRequest> &requests,
+                               std::vector<cx_mat::fixed<3, 3>> &GT) const {
+  GT.resize(requests.size());
+  for (size_t i = 0; i < requests.size(); i++) {
+    assert(request_beta(requests[i]) == beta);
+    this->integrate_k(omega, GT[i], requests[i].fancy_complex,
+                      requests[i].weight_function);
+  }
+}
+
+void GreensTensor::integrate_k_batch(
+    const std::vector<double> &omegas,
+    const std::vector<GreensTensorRequest> &requests,
+    std::vector<std::vector<cx_mat::fixed<3, 3>>> &GT) const {
+  GT.resize(omegas.size());
+  std::vector<IntegrationDiagnostics> lanes(omegas.size());
+
+#pragma omp parallel for schedule(dynamic)
+  for (int j = 0; j < (int)omegas.size(); j++) {
+    IntegrationDiagnosticsLane lane(lanes[j]);
+    this->integrate_k(omegas[j], requests, GT[j]);
+  }
+
+  // hand on the diagnostics in the order of the frequencies
+  for (const IntegrationDiagnostics &lane : lanes) {
+    record_diagnostics(lane);
+  }
+}
+
+void GreensTensor::integrate_k(
+    double omega, const EvaluationParameters &parameters,
+    const std::vector<GreensTensorRequest> &requests,
+    std::vector<cx_mat::fixed<3, 3>> &GT) const {
+  if (has_parameters(parameters)) {
+    this->integrate_k(omega, requests, GT);
+    return;
+  }
+  with_parameters(parameters)->integrate_k(omega, requests, GT);
+}
+
+void GreensTensor::integrate_k_batch(
+    const std::vector<double> &omegas, const EvaluationParameters &parameters,
+    const std::vector<GreensTensorRequest> &requests,
+    std::vector<std::vector<cx_mat::fixed<3, 3>>> &GT) const {
+  if (has_parameters(parameters)) {
+    this->integrate_k_batch(omegas, requests, GT);
+    return;
+  }
+  with_parameters(parameters)->integrate_k_batch(omegas, requests, GT);
+}
+
+double GreensTensor::weight(Weight_Options weight_function, double kv,
+                            double omega_pl, double omega) const {
+  return weight(weight_function, kv, omega_pl, omega, beta);
+}
+
+double GreensTensor::weight(const GreensTensorRequest &request, double kv,
+                            double omega_pl, double omega) const {
+  return weight(request.weight_function, kv, omega_pl, omega,
+                request_beta(request));
+}
+
+double GreensTensor::weight(Weight_Options weight_function, double kv,
+                            double omega_pl, double omega, double beta) const {
+  if (weight_function == KV) {
+    return kv;
+  } else if (weight_function == TEMP) {
+    return 1. / (1.0 - exp(-beta * omega_pl));
+  } else if (weight_function == NON_LTE) {
+    return bose_difference(kv * v, omega, beta);
+  } else if (weight_function == KV_TEMP) {
+    return kv / (1.0 - exp(-beta * omega_pl));
+  } else if (weight_function == KV_NON_LTE) {
+    return kv * bose_difference(kv * v, omega, beta);
+  }
+  return 1.;
+}
+
+double GreensTensor::bose_difference(double shift, double omega,
+                                     double beta) const {
+  double omega_pl = omega + shift;
+
+  // without a common sign of the frequencies there is no cancellation
+  if (omega_pl * omega <= 0) {
+    return 1. / (1.0 - exp(-beta * omega_pl)) - 1. / (1.0 - exp(-beta * omega));
+  }
+
+  // n(-x) = 1 - n(x) maps negative frequencies to positive ones
+  if (omega < 0) {
+    return -bose_difference(-shift, -omega, beta);
+  }
+
+  // the smaller frequency serves as reference to avoid overflows
+  if (shift < 0) {
+    return -bose_difference(-shift, omega_pl, beta);
+  }
+
+  // The difference of the two distributions is written in terms of the shift,
+  // such that it is accurate even if omega_pl and omega nearly coincide
+  return exp(-beta * omega) * expm1(-beta * shift) /
+         (expm1(-beta * omega_pl) * expm1(-beta * omega));
+}
+
+double GreensTensor::coldest_beta(
+    const std::vector<GreensTensorRequest> &requests) const {
+  double result = beta;
+  for (const GreensTensorRequest &request : requests) {
+    result = std::max(result, request_beta(request));
+  }
+  return result;
 }
@@ -1,14 +1,60 @@
 #ifndef GREENSTENSOR_H
 #define GREENSTENSOR_H
 
+#include "../Calculations/CharacteristicFrequency.h"
 #include "../Calculations/Integrations.h"
+#include "../Configuration/Configuration.h"
 #include <armadillo>
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <vector>
 using namespace arma;
 
 // Enum variables for the different integration options
 enum Tensor_Options { COMPLEX, IM, RE };
 enum Weight_Options { UNIT, KV, TEMP, KV_TEMP, NON_LTE, KV_NON_LTE };
 
+// Enum variables for the evaluation of the integrands in the k integration,
+// either every element separately with cquad, all elements jointly on a shared
+// subdivision, all nodes of a quadrature rule at once or, for two-dimensional
+// k integrals, with an adaptive cubature over both variables
+enum Integrator_Options { POINTWISE, VECTOR, BATCH, CUBATURE };
+
+//! One integrated Green's tensor of a bundle, see GreensTensor::integrate_k
+struct GreensTensorRequest {
+  Tensor_Options fancy_complex;   // fancy real or imaginary part
+  Weight_Options weight_function; // weighting function of the integrand
+  double beta = 0; // inverse temperature of the weighting function, zero for
+                   // the one of the Green's tensor
+};
+
+// requests with identical options yield the same Green's tensor
+inline bool operator==(const GreensTensorRequest &a,
+                       const GreensTensorRequest &b) {
+  return a.fancy_complex == b.fancy_complex &&
+         a.weight_function == b.weight_function && a.beta == b.beta;
+}
+
+//! Parameters of the motion and the temperature of an evaluation
+/*!
+ * The parameters that loopers sweep are passed to the evaluation instead of
+ * being set in the model, such that a single model can serve all threads.
+ */
+struct EvaluationParameters {
+  double v;    // velocity of the particle
+  double za;   // distance to the surface, NAN without a surface
+  double beta; // inverse temperature
+};
+
+// parameters agree if their velocities and temperatures agree, a missing
+// distance agrees with every distance
+inline bool operator==(const EvaluationParameters &a,
+                       const EvaluationParameters &b) {
+  return a.v == b.v && a.beta == b.beta &&
+         (a.za == b.za || std::isnan(a.za) || std::isnan(b.za));
+}
+
 //! A Greens tensor class
 /*!
  * This is an abstract class that implements an isotropic and reciprocal Greens
@@ -18,11 +64,13 @@ class GreensTensor {
 protected:
   double v; //velocity of the particle 
   double beta; // inverse temperature
+  Integrator_Options integrator = POINTWISE; // evaluation of the integrands
 
 public:
   // constructor
   GreensTensor(double v, double beta);
   explicit GreensTensor(const std::string &input_file);
+  explicit GreensTensor(const Configuration &configuration);
 
   // calculate the tensor in frequency and momentum space
   virtual void calculate_tensor(double omega, vec::fixed<2> k,
@@ -33,18 +81,111 @@ public:
                            Tensor_Options fancy_complex,
                            Weight_Options weight_function) const = 0;
 
+  // integrate over a two-dimensional k space and collect the diagnostics of
+  // all involved integrations
+  void integrate_k(double omega, cx_mat::fixed<3, 3> &GT,
+                   Tensor_Options fancy_complex, Weight_Options weight_function,
+                   IntegrationDiagnostics &diagnostics) const;
+
+  // integrate over a two-dimensional k space for several options at once,
+  // the tensor of requests[i] is stored in GT[i]. All requests share the
+  // same kernel, hence derived classes integrate them in a single pass, also
+  // if their weights belong to different temperatures. The default
+  // integrates them one after another and only supports the own temperature.
+  virtual void integrate_k(double omega,
+                           const std::vector<GreensTensorRequest> &requests,
+                           std::vector<cx_mat::fixed<3, 3>> &GT) const;
+
+  // integrate the requests with the given parameters instead of the own ones,
+  // the Green's tensor itself is not changed
+  void integrate_k(double omega, const EvaluationParameters &parameters,
+                   const std::vector<GreensTensorRequest> &requests,
+                   std::vector<cx_mat::fixed<3, 3>> &GT) const;
+
+  // integrate the requests at a block of frequencies, the tensor of
+  // requests[i] at omegas[j] is stored in GT[j][i]. The frequencies are
+  // independent of each other and are integrated concurrently by the threads
+  // of an OpenMP team, which only has a single thread if the caller already
+  // runs in a parallel region. The results and the diagnostics do not depend
+  // on the number of threads.
+  void integrate_k_batch(
+      const std::vector<double> &omegas,
+      const std::vector<GreensTensorRequest> &requests,
+      std::vector<std::vector<cx_mat::fixed<3, 3>>> &GT) const;
+
+  // integrate the requests at a block of frequencies with the given
+  // parameters instead of the own ones
+  void integrate_k_batch(
+      const std::vector<double> &omegas, const EvaluationParameters &parameters,
+      const std::vector<GreensTensorRequest> &requests,
+      std::vector<std::vector<cx_mat::fixed<3, 3>>> &GT) const;
+
+  // returns a copy of the Green's tensor with the given parameters, which
+  // shares the reflection coefficients and all other models
+  virtual std::shared_ptr<GreensTensor>
+  with_parameters(const EvaluationParameters &parameters) const = 0;
+
+  // true if the own parameters agree with the given ones
+  bool has_parameters(const EvaluationParameters &parameters) const {
+    return get_parameters() == parameters;
+  };
+
   // calculates and returns a characteristic frequency
   virtual double omega_ch() const = 0;
 
+  // Resonances of the integrated Green's tensor as a function of omega, which
+  // are used as breakpoints of omega integrations. By default none are known.
+  virtual std::vector<CharacteristicFrequency>
+  characteristic_frequencies() const {
+    return {};
+  }
+
   // getter functions
   double get_v() const { return this->v; };
   double get_beta() const { return this->beta; };
+  Integrator_Options get_integrator() const { return this->integrator; };
+  virtual EvaluationParameters get_parameters() const {
+    return {this->v, NAN, this->beta};
+  };
 
   // setter function
   virtual void set_v(double v_new) { this->v = v_new; };
+  virtual void set_beta(double beta_new) {
+    assert(beta_new > 0);
+    this->beta = beta_new;
+  };
+  virtual void set_integrator(Integrator_Options integrator_new) {
+    this->integrator = integrator_new;
+  };
 
   // print info
   virtual void print_info(std::ostream &stream) const =0;
+
+protected:
+  // weighting function of the k integrands, where kv is the component of the
+  // wavevector along the velocity and omega_pl the Doppler-shifted frequency
+  double weight(Weight_Options weight_function, double kv, double omega_pl,
+                double omega) const;
+
+  // the weighting function at the inverse temperature beta
+  double weight(Weight_Options weight_function, double kv, double omega_pl,
+                double omega, double beta) const;
+
+  // the weighting function of the request at its inverse temperature
+  double weight(const GreensTensorRequest &request, double kv, double omega_pl,
+                double omega) const;
+
+  // inverse temperature of the weighting function of the request
+  double request_beta(const GreensTensorRequest &request) const {
+    return request.beta > 0 ? request.beta : beta;
+  };
+
+  // largest inverse temperature of all requests
+  double coldest_beta(const std::vector<GreensTensorRequest> &requests) const;
+
+  // difference n(omega + shift) - n(omega) of the Bose-Einstein distribution
+  // of the non-LTE weights, free of cancellation for small shifts
+  double bose_difference(double shift, double omega, double beta) const;
 };
 
 #endif // GREENSTENSOR_H
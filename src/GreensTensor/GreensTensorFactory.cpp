@@ -12,20 +12,22 @@ namespace pt = boost::property_tree;
 // Green's tensor factory
 std::shared_ptr<GreensTensor>
 GreensTensorFactory::create(const std::string &input_file) {
-  // Create a root
-  pt::ptree root;
+  return create(Configuration(input_file));
+}
 
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+std::shared_ptr<GreensTensor>
+GreensTensorFactory::create(const Configuration &configuration) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
 
   // read the type of the kernel
   std::string type = root.get<std::string>("GreensTensor.type");
 
   // set the right pointer, show error if type is unknown
   if (type == "vacuum") {
-    return std::make_shared<GreensTensorVacuum>(input_file);
+    return std::make_shared<GreensTensorVacuum>(configuration);
   } else if (type == "plate") {
-    return std::make_shared<GreensTensorPlate>(input_file);
+    return std::make_shared<GreensTensorPlate>(configuration);
   } else {
     std::cerr << "Error: Unknown Green's tensor type (" << type << ")!"
               << std::endl;
@@ -1,6 +1,7 @@
 #ifndef GREENSTENSORFACTORY_H
 #define GREENSTENSORFACTORY_H
 
+#include "../Configuration/Configuration.h"
 #include "GreensTensor.h"
 #include <memory>
 
@@ -17,6 +18,7 @@ public:
    * @param type Type of the memory kernel.
    */
   static std::shared_ptr<GreensTensor> create(const std::string &input_file);
+  static std::shared_ptr<GreensTensor> create(const Configuration &configuration);
 };
 
 #endif // GREENSTENSORFACTORY_H
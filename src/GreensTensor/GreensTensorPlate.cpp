@@ -1,11 +1,16 @@
 // json parser
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
+#include <algorithm>
+#include <iostream>
 #include <utility>
 namespace pt = boost::property_tree;
 
 // integration routine
 #include "../Calculations/Integrations.h"
+#include "../Calculations/IntegrationsCubature.h"
+#include "../Calculations/IntegrationsLaguerre.h"
+#include "../Calculations/IntegrationsVector.h"
 
 #include "../Permittivity/PermittivityFactory.h"
 #include "../ReflectionCoefficients/ReflectionCoefficientsFactory.h"
@@ -25,15 +30,15 @@ GreensTensorPlate::GreensTensorPlate(
 }
 
 GreensTensorPlate::GreensTensorPlate(const std::string &input_file)
-    : GreensTensor(input_file) {
-  this->reflection_coefficients =
-      ReflectionCoefficientsFactory::create(input_file);
+    : GreensTensorPlate(Configuration(input_file)) {}
 
-  // Create a root
-  pt::ptree root;
+GreensTensorPlate::GreensTensorPlate(const Configuration &configuration)
+    : GreensTensor(configuration) {
+  this->reflection_coefficients =
+      ReflectionCoefficientsFactory::create(configuration);
 
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
 
   // check if type is right
   std::string type = root.get<std::string>("GreensTensor.type");
@@ -45,6 +50,36 @@ GreensTensorPlate::GreensTensorPlate(const std::string &input_file)
   this->rel_err(0) = root.get<double>("GreensTensor.rel_err_0");
   this->rel_err(1) = root.get<double>("GreensTensor.rel_err_1");
 
+  // read the optional substitution of the integration variables
+  std::string substitution =
+      root.get<std::string>("GreensTensor.substitution", "none");
+  if (substitution == "none") {
+    this->substitution = NO_SUBSTITUTION;
+  } else if (substitution == "logarithmic") {
+    this->substitution = LOGARITHMIC;
+  } else if (substitution == "sigmoidal") {
+    this->substitution = SIGMOIDAL;
+  } else {
+    std::cerr << "Error: Unknown substitution (" << substitution << ")!"
+              << std::endl;
+    exit(0);
+  }
+  this->regularize_phi = root.get<bool>("GreensTensor.regularize_phi", false);
+  this->task_parallel = root.get<bool>("GreensTensor.task_parallel", false);
+
+  // read the optional treatment of the tail of the kappa integration
+  std::string tail = root.get<std::string>("GreensTensor.tail", "truncated");
+  if (tail == "truncated") {
+    this->tail = TRUNCATED;
+  } else if (tail == "laguerre") {
+    this->tail = LAGUERRE;
+  } else {
+    std::cerr << "Error: Unknown tail (" << tail << ")!" << std::endl;
+    exit(0);
+  }
+  this->kappa_quadrature = quadrature_option(
+      root.get<std::string>("GreensTensor.kappa_quadrature", "adaptive"));
+
   // assertions
   assert(this->za >= 0);
   assert(this->delta_cut >= 0);
@@ -99,112 +134,819 @@ void GreensTensorPlate::calculate_tensor(double omega, vec::fixed<2> k,
   }
 }
 
-void GreensTensorPlate::integrate_k(double omega, cx_mat::fixed<3, 3> &GT,
-                                    Tensor_Options fancy_complex,
-                                    Weight_Options weight_function) const {
+namespace {
 
+// Stores the xx, yy, zz and zx element, given in this order in elements, in
+// the Green's tensor. The leading I of the zx element is added here.
+void assemble_tensor(const vec &elements, cx_mat::fixed<3, 3> &GT) {
   // imaginary unit
   std::complex<double> I(0.0, 1.0);
 
-  // intialize Green's tensor
   GT.zeros();
 
+  // the xx, yy and zz element
+  GT(0, 0) = elements(0);
+  GT(1, 1) = elements(1);
+  GT(2, 2) = elements(2);
+
+  // the zx element
+  GT(2, 0) = I * elements(3);
+
+  // the xz element
+  GT(0, 2) = -GT(2, 0);
+}
+
+// Stores the fancy real or imaginary part of the weighted xx, yy, zz and zx
+// element in result, starting at offset. Mind the missing leading I of the zx
+// element, which must be added after the double integration!
+void project_elements(const cx_vec::fixed<4> &elements, double weight,
+                      Tensor_Options fancy_complex, vec &result,
+                      uword offset) {
+  if (fancy_complex == RE) {
+    result(offset + 0) = elements(0).real() * weight;
+    result(offset + 1) = elements(1).real() * weight;
+    result(offset + 2) = elements(2).real() * weight;
+    result(offset + 3) = elements(3).imag() * weight;
+  } else if (fancy_complex == IM) {
+    result(offset + 0) = elements(0).imag() * weight;
+    result(offset + 1) = elements(1).imag() * weight;
+    result(offset + 2) = elements(2).imag() * weight;
+    result(offset + 3) = -elements(3).real() * weight;
+  } else {
+    result.subvec(offset, offset + 3).zeros();
+  }
+}
+
+// Finds the position of the element with the given indices among the xx, yy,
+// zz and zx element and its sign, the xz element is the negative of zx.
+// Returns false for the vanishing elements.
+bool element_position(const uvec::fixed<2> &indices, uword &element,
+                      double &sign) {
+  sign = 1;
+  if (indices(0) == indices(1)) {
+    element = indices(0);
+    return true;
+  }
+  if (indices(0) == 2 && indices(1) == 0) {
+    element = 3;
+    return true;
+  }
+  if (indices(0) == 0 && indices(1) == 2) {
+    element = 3;
+    sign = -1;
+    return true;
+  }
+  return false;
+}
+
+// Doppler-shifted frequency omega + k v cos(phi) at the real kappa, where k is
+// expressed via kappa as in the integrands
+double doppler_shift(double kappa, double omega, double v, double cos_phi) {
+  double v_cos_quad = v * v * cos_phi * cos_phi;
+  double kappa_quad = kappa * kappa;
+  double k = (sqrt((kappa_quad + omega * omega) - kappa_quad * v_cos_quad) +
+              v * omega * cos_phi) /
+             (1.E0 - v_cos_quad);
+  return omega + k * cos_phi * v;
+}
+
+// number of decay lengths 1 / (2 za) after which the Gauss-Laguerre rules
+// integrate the tail of the kappa integration
+const double laguerre_tail = 4;
+
+// number of uniform samples used to bracket the sign changes in append_roots
+const int root_samples = 32;
+
+// maximal number of bisections of a bracketed sign change
+const int root_bisections = 60;
+
+// Appends the points in [a, b] at which one of the functions returned by g
+// changes its sign. The interval is sampled uniformly and every bracketed sign
+// change is bisected. The functions are identified by their position in the
+// returned vector, hence no sign change is bracketed between two samples with
+// a different number of functions.
+template <typename G>
+void append_roots(const G &g, double a, double b, std::vector<double> &roots) {
+  double x_left = a;
+  std::vector<double> g_left = g(a);
+  for (int i = 1; i <= root_samples; i++) {
+    double x_right = a + (b - a) * i / root_samples;
+    std::vector<double> g_right = g(x_right);
+    if (g_left.size() == g_right.size()) {
+      for (size_t j = 0; j < g_left.size(); j++) {
+        if ((g_left[j] < 0) == (g_right[j] < 0)) {
+          continue;
+        }
+        double lower = x_left, upper = x_right;
+        for (int n = 0; n < root_bisections; n++) {
+          double mid = 0.5 * (lower + upper);
+          std::vector<double> g_mid = g(mid);
+          if (j >= g_mid.size()) {
+            break;
+          }
+          if ((g_mid[j] < 0) == (g_left[j] < 0)) {
+            lower = mid;
+          } else {
+            upper = mid;
+          }
+        }
+        roots.push_back(0.5 * (lower + upper));
+      }
+    }
+    x_left = x_right;
+    g_left = g_right;
+  }
+}
+
+// Sorts the points, removes the ones outside of (a, b) and duplicates and
+// adds a and b as first and last boundary
+std::vector<double> piece_bounds(double a, double b,
+                                 std::vector<double> points) {
+  std::sort(points.begin(), points.end());
+  std::vector<double> bounds = {a};
+  for (double x : points) {
+    if (x > bounds.back() && x < b) {
+      bounds.push_back(x);
+    }
+  }
+  bounds.push_back(b);
+  return bounds;
+}
+
+// Integrates f with the vector integrator integrate piece by piece between
+// the given boundaries. Every piece after the first one is integrated with an
+// absolute tolerance relative to the sum of the previous pieces. With tasks,
+// the pieces are integrated as OpenMP tasks with their relative tolerance only
+// and summed in their order, such that the result does not depend on the
+// number of threads.
+template <typename Integrate>
+vec integrate_pieces(const Integrate &integrate,
+                     const std::vector<double> &bounds, uword n, double relerr,
+                     bool tasks = false) {
+  if (!tasks) {
+    vec result = integrate(bounds[0], bounds[1], zeros<vec>(n));
+    for (size_t i = 2; i < bounds.size(); i++) {
+      result += integrate(bounds[i - 1], bounds[i], abs(result) * relerr);
+    }
+    return result;
+  }
+
+  std::vector<vec> pieces(bounds.size() - 1);
+  std::vector<IntegrationDiagnostics> lanes(pieces.size());
+  for (size_t i = 0; i < pieces.size(); i++) {
+#pragma omp task default(shared) firstprivate(i)
+    {
+      IntegrationDiagnosticsLane lane(lanes[i]);
+      pieces[i] = integrate(bounds[i], bounds[i + 1], zeros<vec>(n));
+    }
+  }
+#pragma omp taskwait
+
+  vec result(n, fill::zeros);
+  for (size_t i = 0; i < pieces.size(); i++) {
+    record_diagnostics(lanes[i]);
+    result += pieces[i];
+  }
+  return result;
+}
+
+// Substitution x(s), which maps s from 0 to 1 onto the piece [a, b] of the
+// kappa integration. The logarithmic substitution absorbs part of the decay
+// exp(-decay x) on pieces of evanescent waves (a >= 0), the sigmoidal one
+// clusters the nodes at a and b. Otherwise, the piece is mapped linearly.
+struct PieceSubstitution {
+  Substitution_Options type;
+  double a, b, decay;
+
+  // returns x(s) and stores dx/ds in jacobian
+  double operator()(double s, double &jacobian) const {
+    if (type == LOGARITHMIC && decay > 0 && a >= 0) {
+      // Only a quarter of the decay is absorbed. The remaining decay keeps
+      // the integrand smooth at s = 1, where the powers of kappa of the
+      // integrand would turn into a logarithmic singularity otherwise.
+      double rate = decay / 4;
+      double fraction = -std::expm1(-rate * (b - a));
+      jacobian = fraction / (rate * (1 - s * fraction));
+      return std::min(a - std::log1p(-s * fraction) / rate, b);
+    }
+    if (type == SIGMOIDAL) {
+      double norm = s * s + (1 - s) * (1 - s);
+      jacobian = (b - a) * 2 * s * (1 - s) / (norm * norm);
+      return a + (b - a) * s * s / norm;
+    }
+    jacobian = b - a;
+    return a + (b - a) * s;
+  }
+};
+
+// Substitution phi(s), which maps s from 0 to 1 onto the piece [a, b] of the
+// phi integration. The nodes are clustered quadratically at pi / 2, if it is
+// a boundary of the piece. Otherwise, the piece is mapped linearly.
+struct AngularSubstitution {
+  double a, b;
+
+  // returns phi(s) and stores dphi/ds in jacobian
+  double operator()(double s, double &jacobian) const {
+    if (b == M_PI / 2) {
+      jacobian = 2 * (b - a) * (1 - s);
+      return b - (b - a) * (1 - s) * (1 - s);
+    }
+    if (a == M_PI / 2) {
+      jacobian = 2 * (b - a) * s;
+      return a + (b - a) * s * s;
+    }
+    jacobian = b - a;
+    return a + (b - a) * s;
+  }
+};
+
+// cquad of f over the piece after the substitution
+template <typename F, typename Substitution>
+double substituted_cquad(const F &f, const Substitution &substitution,
+                         double relerr, double epsabs) {
+  auto G = [&](double s) -> double {
+    double jacobian;
+    double x = substitution(s, jacobian);
+    return jacobian == 0 ? 0 : f(x) * jacobian;
+  };
+  return cquad(G, 0, 1, relerr, epsabs);
+}
+
+// qag_vec of the n-component function f over the piece after the substitution
+template <typename F, typename Substitution>
+vec substituted_qag_vec(const F &f, uword n, const Substitution &substitution,
+                        double relerr, const vec &epsabs) {
+  auto G = [&](double s, vec &result) -> void {
+    double jacobian;
+    f(substitution(s, jacobian), result);
+    result *= jacobian;
+  };
+  return qag_vec(G, n, 0, 1, relerr, epsabs);
+}
+
+// qag_batch of the n-component function f over the piece after the
+// substitution
+template <typename F, typename Substitution>
+vec substituted_qag_batch(const F &f, uword n,
+                          const Substitution &substitution, double relerr,
+                          const vec &epsabs) {
+  auto G = [&](const vec &s, mat &result) -> void {
+    vec x(s.n_elem), jacobian(s.n_elem);
+    for (uword i = 0; i < s.n_elem; i++) {
+      x(i) = substitution(s(i), jacobian(i));
+    }
+    f(x, result);
+    result.each_col() %= jacobian;
+  };
+  return qag_batch(G, n, 0, 1, relerr, epsabs);
+}
+
+} // namespace
+
+std::vector<double> GreensTensorPlate::kappa_bounds(double omega, double phi,
+                                                    double beta_edge) const {
+  // The cut-off parameters acts as upper bound of the kappa integration.
+  double kappa_cut = delta_cut / (2 * za);
+  double cos_phi = std::cos(phi);
+  std::vector<double> points;
+  if (beta_edge == 0) {
+    beta_edge = beta;
+  }
+
+  // To resolve the probably sharp edge of the Bose-Einstein distribution, the
+  // integration is split at the edge, if the edge lies below the cut-off.
+  double edge = std::abs(omega / (v * cos_phi));
+  if ((kappa_cut > edge) && (2 * za / v < beta_edge)) {
+    points.push_back(edge);
+  }
+
+  // The integration is split where the Doppler-shifted frequency equals a
+  // resonance frequency of the reflection coefficients.
+  if (!reflection_coefficients->resonances(kappa_cut).empty()) {
+    auto detuning = [&](double kappa) -> std::vector<double> {
+      std::vector<double> result = reflection_coefficients->resonances(kappa);
+      double omega_pl = std::abs(doppler_shift(kappa, omega, v, cos_phi));
+      for (double &x : result) {
+        x = omega_pl - x;
+      }
+      return result;
+    };
+    append_roots(detuning, 0, kappa_cut, points);
+  }
+
+  // The Gauss-Laguerre rules integrate the last piece up to infinity, the
+  // cut-off only limits the search for the points above. The rules require
+  // an integrand that is smooth on the scale of the decay length 1 / (2 za),
+  // hence the tail starts no earlier than laguerre_tail decay lengths.
+  if (tail == LAGUERRE) {
+    if (za <= 0) {
+      std::cerr << "Error: Non-positive distance for the Laguerre tail ("
+                << za << ")!" << std::endl;
+      exit(0);
+    }
+    points.push_back(laguerre_tail / (2 * za));
+    return piece_bounds(0, INFINITY, points);
+  }
+  return piece_bounds(0, kappa_cut, points);
+}
+
+std::vector<double> GreensTensorPlate::phi_bounds(double omega,
+                                                  double beta_edge) const {
+  // The cut-off parameters acts as upper bound of the kappa integration.
+  double kappa_cut = delta_cut / (2 * za);
+  std::vector<double> points;
+  if (beta_edge == 0) {
+    beta_edge = beta;
+  }
+
+  // The low-temperature edge lies below the cut-off for angles phi below
+  // phi_edge and above pi - phi_edge
+  double cos_edge = std::abs(omega) / (v * kappa_cut);
+  if ((cos_edge < 1) && (2 * za / v < beta_edge)) {
+    double phi_edge = std::acos(cos_edge);
+    points.push_back(phi_edge);
+    points.push_back(M_PI - phi_edge);
+  }
+
+  // A resonance enters the kappa domain through one of its boundaries, where
+  // the Doppler-shifted frequency equals the resonance frequency
+  for (double kappa : {0., kappa_cut}) {
+    std::vector<double> resonances = reflection_coefficients->resonances(kappa);
+    if (resonances.empty()) {
+      continue;
+    }
+    auto detuning = [&](double phi) -> std::vector<double> {
+      std::vector<double> result = resonances;
+      double omega_pl =
+          std::abs(doppler_shift(kappa, omega, v, std::cos(phi)));
+      for (double &x : result) {
+        x = omega_pl - x;
+      }
+      return result;
+    };
+    append_roots(detuning, 0, M_PI, points);
+  }
+
+  // For relativistic velocities 1 / (1 - v^2 cos^2 phi) peaks at 0 and pi,
+  // the peaks are separated at the angles where it drops to half its height
+  if (2 * v * v > 1) {
+    double phi_v = std::asin(std::sqrt(1 - v * v) / v);
+    points.push_back(phi_v);
+    points.push_back(M_PI - phi_v);
+  }
+
+  // At pi / 2 the edge diverges, the regularized phi integration clusters its
+  // nodes there
+  if (regularize_phi) {
+    points.push_back(M_PI / 2);
+  }
+
+  return piece_bounds(0, M_PI, points);
+}
+
+void GreensTensorPlate::integrate_k(double omega, cx_mat::fixed<3, 3> &GT,
+                                    Tensor_Options fancy_complex,
+                                    Weight_Options weight_function) const {
+  // The batch integrand provides the elements of a single tensor, all other
+  // integrators are covered by the bundle of tensors.
+  if (integrator != BATCH) {
+    std::vector<cx_mat::fixed<3, 3>> bundle;
+    GreensTensorPlate::integrate_k(omega, {{fancy_complex, weight_function}},
+                                   bundle);
+    GT = bundle[0];
+    return;
+  }
+
   // calculate the five non-zero elements of the Green's tensor. Here, the
   // symmetry in y direction was already applied. Thus, the integration only
-  // consideres twice the domain from 0 to pi.
-
-  // the xx element
-  auto F_xx = [=](double x) -> double {
-    return this->integrand_1d_k(x, omega, {0, 0}, fancy_complex,
-                                weight_function);
+  // consideres twice the domain from 0 to pi. The xx, yy, zz and zx element
+  // are integrated jointly on a shared subdivision of the phi domain.
+  auto F = [=](double x, vec &result) -> void {
+    this->integrand_1d_k(x, omega, result, fancy_complex, weight_function);
+  };
+  // The phi domain is split at the angles at which the kappa integrand
+  // changes its structure.
+  auto integrate = [&](double a, double b, const vec &epsabs) -> vec {
+    if (regularize_phi) {
+      return substituted_qag_vec(F, 4, AngularSubstitution{a, b}, rel_err(1),
+                                 epsabs);
+    }
+    return qag_vec(F, 4, a, b, rel_err(1), epsabs);
   };
-  GT(0, 0) = cquad(F_xx, 0, M_PI, rel_err(1), 0) / M_PI;
+  assemble_tensor(
+      integrate_pieces(integrate, phi_bounds(omega), 4, rel_err(1),
+                       task_parallel) /
+          M_PI,
+      GT);
+}
 
-  // the yy element
-  auto F_yy = [=](double x) -> double {
-    return this->integrand_1d_k(x, omega, {1, 1}, fancy_complex,
-                                weight_function);
+void GreensTensorPlate::integrate_k(
+    double omega, const std::vector<GreensTensorRequest> &requests,
+    std::vector<cx_mat::fixed<3, 3>> &GT) const {
+  // the batch integrand is restricted to a single tensor at the own
+  // temperature
+  if (integrator == BATCH) {
+    GT.resize(requests.size());
+    std::vector<IntegrationDiagnostics> lanes(requests.size());
+    for (uword i = 0; i < requests.size(); i++) {
+      // the requests are independent tasks if enabled
+#pragma omp task default(shared) firstprivate(i) if (task_parallel)
+      {
+        IntegrationDiagnosticsLane lane(lanes[i]);
+        GreensTensorPlate plate(*this);
+        plate.set_beta(request_beta(requests[i]));
+        plate.integrate_k(omega, GT[i], requests[i].fancy_complex,
+                          requests[i].weight_function);
+      }
+    }
+#pragma omp taskwait
+    for (const IntegrationDiagnostics &lane : lanes) {
+      record_diagnostics(lane);
+    }
+    return;
+  }
+
+  // The xx, yy, zz and zx element of all requests are either integrated
+  // separately with cquad, or jointly on a shared subdivision of the phi
+  // domain or of the (phi, kappa) domain in case of the cubature. The elements
+  // of request i are stored at 4 * i.
+  uword n = 4 * requests.size();
+  vec elements;
+  if (integrator == CUBATURE) {
+    elements = integrate_2d_k(omega, requests) / M_PI;
+  } else {
+    auto F = [&](double x, vec &result) -> void {
+      this->integrand_1d_k(x, omega, requests, result);
+    };
+    auto integrate = [&](double a, double b, const vec &epsabs) -> vec {
+      if (integrator == VECTOR) {
+        if (regularize_phi) {
+          return substituted_qag_vec(F, n, AngularSubstitution{a, b},
+                                     rel_err(1), epsabs);
+        }
+        return qag_vec(F, n, a, b, rel_err(1), epsabs);
+      }
+      vec result(n);
+      for (uword i = 0; i < n; i++) {
+        auto F_i = [&](double x) -> double {
+          return this->integrand_1d_k(x, omega, requests[i / 4], i % 4);
+        };
+        if (regularize_phi) {
+          result(i) = substituted_cquad(F_i, AngularSubstitution{a, b},
+                                        rel_err(1), epsabs(i));
+        } else {
+          result(i) = cquad(F_i, a, b, rel_err(1), epsabs(i));
+        }
+      }
+      return result;
+    };
+    elements = integrate_pieces(integrate,
+                                phi_bounds(omega, coldest_beta(requests)), n,
+                                rel_err(1), task_parallel) /
+               M_PI;
+  }
+
+  GT.resize(requests.size());
+  for (uword i = 0; i < requests.size(); i++) {
+    assemble_tensor(elements.subvec(4 * i, 4 * i + 3), GT[i]);
+  }
+}
+
+void GreensTensorPlate::integrate_k(
+    double omega, const std::vector<GreensTensorRequest> &requests,
+    const std::vector<double> &distances,
+    std::vector<std::vector<cx_mat::fixed<3, 3>>> &GT) const {
+  assert(!distances.empty());
+  GT.resize(distances.size());
+
+  // only the vector integrator shares its nodes between the distances
+  if (integrator != VECTOR) {
+    for (uword j = 0; j < distances.size(); j++) {
+      GreensTensorPlate plate(*this);
+      plate.set_za(distances[j]);
+      plate.integrate_k(omega, requests, GT[j]);
+    }
+    return;
+  }
+
+  // All distances are integrated on the pieces of the closest one, whose
+  // integrand decays slowest in kappa and needs the largest cut-off.
+  GreensTensorPlate closest(*this);
+  closest.set_za(*std::min_element(distances.begin(), distances.end()));
+
+  // The elements of request i at distance j are stored at 4 * (j * m + i) and
+  // are integrated jointly, such that the subdivision is refined until the
+  // least accurate of them converges.
+  uword m = requests.size();
+  uword n = 4 * m * distances.size();
+  auto F = [&](double x, vec &result) -> void {
+    closest.integrand_1d_k(x, omega, requests, distances, result);
+  };
+  auto integrate = [&](double a, double b, const vec &epsabs) -> vec {
+    if (regularize_phi) {
+      return substituted_qag_vec(F, n, AngularSubstitution{a, b}, rel_err(1),
+                                 epsabs);
+    }
+    return qag_vec(F, n, a, b, rel_err(1), epsabs);
   };
-  GT(1, 1) = cquad(F_yy, 0, M_PI, rel_err(1), 0) / M_PI;
+  vec elements =
+      integrate_pieces(integrate,
+                       closest.phi_bounds(omega, coldest_beta(requests)), n,
+                       rel_err(1), task_parallel) /
+      M_PI;
 
-  // the zz element
-  auto F_zz = [=](double x) -> double {
-    return this->integrand_1d_k(x, omega, {2, 2}, fancy_complex,
-                                weight_function);
+  for (uword j = 0; j < distances.size(); j++) {
+    GT[j].resize(m);
+    for (uword i = 0; i < m; i++) {
+      assemble_tensor(elements.subvec(4 * (j * m + i), 4 * (j * m + i) + 3),
+                      GT[j][i]);
+    }
+  }
+}
+
+vec GreensTensorPlate::integrate_2d_k(
+    double omega, const std::vector<GreensTensorRequest> &requests) const {
+  // The cut-off parameters acts as upper bound of the kappa integration.
+  double kappa_cut = delta_cut / (2 * za);
+
+  // The (phi, kappa) domain is split into pieces, which are mapped onto unit
+  // squares in (s, t). Every piece covers phi from phi_0 to phi_0 + phi_range
+  // and kappa either from 0 to the low-temperature edge (BELOW), from the edge
+  // to kappa_cut (ABOVE), from 0 to kappa_cut (EVANESCENT) or over the strip
+  // of propagating waves from -|omega| to 0 (PROPAGATING).
+  enum Piece_Options { BELOW, ABOVE, EVANESCENT, PROPAGATING };
+  struct Piece {
+    Piece_Options type;
+    double phi_0, phi_range;
   };
-  GT(2, 2) = cquad(F_zz, 0, M_PI, rel_err(1), 0) / M_PI;
+  std::vector<Piece> pieces;
 
-  // the zx element
-  auto F_zx = [=](double x) -> double {
-    return this->integrand_1d_k(x, omega, {2, 0}, fancy_complex,
-                                weight_function);
+  // The edge lies below the cut-off kappa_cut for angles phi below phi_edge
+  // and above pi - phi_edge, where the integration is split at the edge as in
+  // integrand_1d_k.
+  double cos_edge = std::abs(omega) / (v * kappa_cut);
+  if ((cos_edge < 1) && (2 * za / v < coldest_beta(requests))) {
+    double phi_edge = std::acos(cos_edge);
+    for (double phi_0 : {0., M_PI - phi_edge}) {
+      pieces.push_back({BELOW, phi_0, phi_edge});
+      pieces.push_back({ABOVE, phi_0, phi_edge});
+    }
+    pieces.push_back({EVANESCENT, phi_edge, M_PI - 2 * phi_edge});
+  } else {
+    pieces.push_back({EVANESCENT, 0, M_PI});
+  }
+  pieces.push_back({PROPAGATING, 0, M_PI});
+
+  // The pieces are placed next to each other, piece i covers s from i to i+1,
+  // such that all of them are refined with one global error estimate.
+  auto F = [&](const vec &x, vec &result) -> void {
+    uword i = std::min((uword)x(0), (uword)pieces.size() - 1);
+    const Piece &piece = pieces[i];
+    double phi = piece.phi_0 + (x(0) - i) * piece.phi_range;
+    double t = x(1);
+
+    // Calculate low-temperature edge
+    double edge = std::abs(omega / (v * std::cos(phi)));
+
+    double kappa, jacobian;
+    if (piece.type == BELOW) {
+      kappa = t * edge;
+      jacobian = edge;
+    } else if (piece.type == ABOVE) {
+      kappa = edge + t * (kappa_cut - edge);
+      jacobian = kappa_cut - edge;
+    } else if (piece.type == EVANESCENT) {
+      kappa = t * kappa_cut;
+      jacobian = kappa_cut;
+    } else {
+      kappa = -(1. - t) * std::abs(omega);
+      jacobian = std::abs(omega);
+    }
+    jacobian *= piece.phi_range;
+
+    // the xx, yy, zz and zx element of all requests
+    this->integrand_2d_k(kappa, omega, phi, requests, result);
+    result *= jacobian;
   };
-  GT(2, 0) = I * cquad(F_zx, 0, M_PI, rel_err(1), 0) / M_PI;
 
-  // the xz element
-  GT(0, 2) = -GT(2, 0);
+  mat a(2, pieces.size()), b(2, pieces.size());
+  for (uword i = 0; i < pieces.size(); i++) {
+    a.col(i) = vec({(double)i, 0});
+    b.col(i) = vec({(double)i + 1, 1});
+  }
+  return cubature_vec(F, 4 * requests.size(), a, b, rel_err(1), 0);
 }
 
 double GreensTensorPlate::integrand_1d_k(double phi, double omega,
                                          const uvec::fixed<2> &indices,
                                          Tensor_Options fancy_complex,
                                          Weight_Options weight_function) const {
+  uword element;
+  double sign;
+  if (!element_position(indices, element, sign)) {
+    return 0;
+  }
+  return sign * integrand_1d_k(phi, omega, {fancy_complex, weight_function},
+                               element);
+}
 
-  double result;
-
-  // The cut-off parameters acts as upper bound of the kappa integration.
-  double kappa_cut = delta_cut / (2 * za);
+double GreensTensorPlate::integrand_1d_k(double phi, double omega,
+                                         const GreensTensorRequest &request,
+                                         uword element) const {
 
-  // read integration variable phi
-  double cos_phi = std::cos(phi);
+  double result;
 
   // define integrand
-  auto F = [=](double x) -> double {
-    return this->integrand_2d_k(x, omega, phi, indices, fancy_complex,
-                                weight_function);
+  std::vector<GreensTensorRequest> requests = {request};
+  auto F = [&](double x) -> double {
+    vec elements;
+    this->integrand_2d_k(x, omega, phi, requests, elements);
+    return elements(element);
   };
 
-  // Calculate low-temperature edge
-  double edge = std::abs(omega / (v * cos_phi));
+  // integrate from a to b with the chosen substitution, an infinite tail is
+  // integrated with the Gauss-Laguerre rules
+  auto integrate = [&](double a, double b, double epsabs) -> double {
+    if (std::isinf(b)) {
+      return laguerre(F, a, 2 * za, rel_err(0), epsabs);
+    }
+    if (substitution != NO_SUBSTITUTION) {
+      PieceSubstitution piece = {substitution, a, b, 2 * za};
+      return substituted_cquad(F, piece, rel_err(0), epsabs);
+    }
+    return cquad(F, a, b, rel_err(0), epsabs);
+  };
+
+  // Calculate the integrand corresponding to the given options. To resolve
+  // the probably sharp edge of the Bose-Einstein distribution and the
+  // resonances of the reflection coefficients, the integration is split at
+  // these points.
+  std::vector<double> bounds = kappa_bounds(omega, phi, request_beta(request));
+  result = integrate(bounds[0], bounds[1], 0);
+  for (size_t i = 2; i < bounds.size(); i++) {
+    result +=
+        integrate(bounds[i - 1], bounds[i], std::abs(result) * rel_err(0));
+  }
 
-  // Calculate the integrand corresponding to the given options. To resolve the
-  // probably sharp edge of the Bose-Einstein distribution, the integration is
-  // split at the edge, if the edged lies below the cut-off kappa_cut.
-  if ( (kappa_cut > edge) && (2*za/v < beta) ) {
-    result = cquad(F, 0, std::abs(omega / (v * cos_phi)), rel_err(0), 0);
-    result += cquad(F, edge, kappa_cut, rel_err(0), std::abs(result)*rel_err(0));
+  // The integrand of the propagating waves behaves like a square root at
+  // both ends, which the tanh-sinh quadrature resolves without bisection
+  if (kappa_quadrature == DOUBLE_EXPONENTIAL) {
+    result += tanh_sinh(F, -std::abs(omega), 0, rel_err(0),
+                        std::abs(result) * rel_err(0));
   } else {
-    result = cquad(F, 0, kappa_cut, rel_err(0), 0);
+    result += integrate(-std::abs(omega), 0, std::abs(result) * rel_err(0));
   }
-    result += cquad(F, -std::abs(omega), 0, rel_err(0), std::abs(result)*rel_err(0));
 
   return result;
 }
 
+void GreensTensorPlate::integrand_1d_k(double phi, double omega, vec &result,
+                                       Tensor_Options fancy_complex,
+                                       Weight_Options weight_function) const {
+
+  // define integrand of the xx, yy, zz and zx element
+  auto F = [=](double x, vec &elements) -> void {
+    this->integrand_2d_k(x, omega, phi, elements, fancy_complex,
+                         weight_function);
+  };
+
+  // the same integrand evaluated at all nodes of the rule at once
+  auto F_batch = [=](const vec &x, mat &elements) -> void {
+    this->integrand_2d_k(x, omega, phi, elements, fancy_complex,
+                         weight_function);
+  };
+
+  // integrate the elements from a to b with the chosen integrator and
+  // substitution, an infinite tail is integrated with the Gauss-Laguerre rules
+  auto integrate = [&](double a, double b, const vec &epsabs) -> vec {
+    if (std::isinf(b)) {
+      if (integrator == BATCH) {
+        return laguerre_batch(F_batch, 4, a, 2 * za, rel_err(0), epsabs);
+      }
+      return laguerre_vec(F, 4, a, 2 * za, rel_err(0), epsabs);
+    }
+    if (substitution != NO_SUBSTITUTION) {
+      PieceSubstitution piece = {substitution, a, b, 2 * za};
+      if (integrator == BATCH) {
+        return substituted_qag_batch(F_batch, 4, piece, rel_err(0), epsabs);
+      }
+      return substituted_qag_vec(F, 4, piece, rel_err(0), epsabs);
+    }
+    if (integrator == BATCH) {
+      return qag_batch(F_batch, 4, a, b, rel_err(0), epsabs);
+    }
+    return qag_vec(F, 4, a, b, rel_err(0), epsabs);
+  };
+
+  // Calculate the integrand corresponding to the given options. To resolve
+  // the probably sharp edge of the Bose-Einstein distribution and the
+  // resonances of the reflection coefficients, the integration is split at
+  // these points.
+  result = integrate_pieces(integrate, kappa_bounds(omega, phi), 4, rel_err(0));
+  result += integrate(-std::abs(omega), 0, abs(result) * rel_err(0));
+}
+
+void GreensTensorPlate::integrand_1d_k(
+    double phi, double omega, const std::vector<GreensTensorRequest> &requests,
+    vec &result) const {
+  uword n = 4 * requests.size();
+
+  // define integrand of the xx, yy, zz and zx element of all requests
+  auto F = [&](double x, vec &elements) -> void {
+    this->integrand_2d_k(x, omega, phi, requests, elements);
+  };
+  auto integrate = [&](double a, double b, const vec &epsabs) -> vec {
+    if (std::isinf(b)) {
+      return laguerre_vec(F, n, a, 2 * za, rel_err(0), epsabs);
+    }
+    if (substitution != NO_SUBSTITUTION) {
+      PieceSubstitution piece = {substitution, a, b, 2 * za};
+      return substituted_qag_vec(F, n, piece, rel_err(0), epsabs);
+    }
+    return qag_vec(F, n, a, b, rel_err(0), epsabs);
+  };
+
+  // Calculate the integrand corresponding to the given options. To resolve
+  // the probably sharp edge of the Bose-Einstein distribution and the
+  // resonances of the reflection coefficients, the integration is split at
+  // these points.
+  result = integrate_pieces(
+      integrate, kappa_bounds(omega, phi, coldest_beta(requests)), n,
+      rel_err(0));
+  result += integrate(-std::abs(omega), 0, abs(result) * rel_err(0));
+}
+
+void GreensTensorPlate::integrand_1d_k(
+    double phi, double omega, const std::vector<GreensTensorRequest> &requests,
+    const std::vector<double> &distances, vec &result) const {
+  uword n = 4 * requests.size() * distances.size();
+
+  // define integrand of the xx, yy, zz and zx element of all requests and
+  // distances
+  auto F = [&](double x, vec &elements) -> void {
+    this->integrand_2d_k(x, omega, phi, requests, distances, elements);
+  };
+  auto integrate = [&](double a, double b, const vec &epsabs) -> vec {
+    if (std::isinf(b)) {
+      return laguerre_vec(F, n, a, 2 * za, rel_err(0), epsabs);
+    }
+    if (substitution != NO_SUBSTITUTION) {
+      PieceSubstitution piece = {substitution, a, b, 2 * za};
+      return substituted_qag_vec(F, n, piece, rel_err(0), epsabs);
+    }
+    return qag_vec(F, n, a, b, rel_err(0), epsabs);
+  };
+
+  // the pieces of the own distance za are shared by all distances
+  result = integrate_pieces(
+      integrate, kappa_bounds(omega, phi, coldest_beta(requests)), n,
+      rel_err(0));
+  result += integrate(-std::abs(omega), 0, abs(result) * rel_err(0));
+}
+
 double GreensTensorPlate::integrand_2d_k(double kappa_double, double omega,
                                          double phi,
                                          const uvec::fixed<2> &indices,
                                          Tensor_Options fancy_complex,
                                          Weight_Options weight_function) const {
+  uword element;
+  double sign;
+  if (!element_position(indices, element, sign)) {
+    return 0;
+  }
+
+  // the fancy real or imaginary part of all elements of the kernel, of which
+  // the chosen one is returned
+  vec elements;
+  this->integrand_2d_k(kappa_double, omega, phi, elements, fancy_complex,
+                       weight_function);
+  return sign * elements(element);
+}
+
+void GreensTensorPlate::kernel_2d_k(double kappa_double, double omega,
+                                    double phi, cx_vec::fixed<4> &elements,
+                                    double &kv, double &omega_pl) const {
+  std::complex<double> kappa;
+  kernel_2d_k(kappa_double, omega, phi, elements, kv, omega_pl, kappa);
+  elements *= exp(-2 * za * kappa);
+}
 
+void GreensTensorPlate::kernel_2d_k(double kappa_double, double omega,
+                                    double phi, cx_vec::fixed<4> &elements,
+                                    double &kv, double &omega_pl,
+                                    std::complex<double> &kappa) const {
   double v_quad = v * v;
   double omega_quad = omega * omega;
   double cos_phi = cos(phi);
   double cos_phi_quad = cos_phi * cos_phi;
   double sin_phi_quad = 1.0 - cos_phi_quad;
 
-  // Before the real or imaginary part of the chosen matrix element can be
-  // calculated, the complex result is stored in result_complex.
-  std::complex<double> result_complex;
-  double result = 0.;
-
   // imaginary unit
   std::complex<double> I(0.0, 1.0);
 
-  // permittivity and propagation through vacuum (kappa) and surface material
+  // Transfer kappa to the correct complex value
   std::complex<double> kappa_complex;
   double kappa_quad;
-  // Transfer kappa to the correct complex value
   if (kappa_double < 0.0) {
     kappa_complex = std::complex<double>(0.0, kappa_double);
     kappa_quad = -kappa_double * kappa_double;
@@ -214,25 +956,25 @@ double GreensTensorPlate::integrand_2d_k(double kappa_double, double omega,
   }
 
   // Express kappa via frequency and kappa.
-  // In order to achieve the desired accuracy, we subtract first 
+  // In order to achieve the desired accuracy, we subtract first
   // (kappa^2 + omega^2), since this might be equal zero.
-  double k = (sqrt((kappa_quad + omega_quad)- kappa_quad * v_quad * cos_phi_quad) +
-              v * omega * cos_phi) / (1.E0 - v_quad * cos_phi_quad);
-  double k_quad = k * k;
+  double k =
+      (sqrt((kappa_quad + omega_quad) - kappa_quad * v_quad * cos_phi_quad) +
+       v * omega * cos_phi) /
+      (1.E0 - v_quad * cos_phi_quad);
+  kv = k * cos_phi;
 
   // Define the Doppler-shifted frequency
-  double omega_pl = (omega + k * cos_phi * v);
-  double omega_pl_quad = omega_pl * omega_pl;
+  omega_pl = (omega + k * cos_phi * v);
 
   // In order to obey reality in time, a positive omega_pl is used for the
   // actual calculation. Afterwards, the corresponding symmetry operation is
   // performed if the sign of omega_pl is negative.
-  double omega_pl_abs = std::abs(omega_pl);
-
-  // producing the reflection coefficients in p- and s-polarization
-  // reflection coefficients and pre-factors of the corresponding polarization
+  // producing the reflection coefficients in p- and s-polarization, which
+  // are shared by all elements
   std::complex<double> r_p, r_s;
-  reflection_coefficients->calculate(omega_pl_abs, kappa_complex, r_p, r_s);
+  reflection_coefficients->calculate(std::abs(omega_pl), kappa_complex, r_p,
+                                     r_s);
 
   // Impose reality in time
   if (omega_pl < 0) {
@@ -242,79 +984,92 @@ double GreensTensorPlate::integrand_2d_k(double kappa_double, double omega,
   }
 
   // helpful prefactors
-  // general prefactor with volume element and exponential
-  std::complex<double> prefactor = std::abs(kappa_complex) *
-                                   exp(-2 * za * kappa_complex) /
-                                   (1. - cos_phi * v * omega_pl / k);
-  // For an better overview and a efficient calculation, we collect the
-  // pre-factors of the p and s polarization separately
+  // general prefactor with volume element, without the factor exp(-2 za kappa)
+  // of the distance. For an better overview and a efficient calculation, we
+  // collect the pre-factors of the p and s polarization separately.
+  kappa = kappa_complex;
+  std::complex<double> prefactor =
+      std::abs(kappa_complex) / (1. - cos_phi * v * omega_pl / k);
   std::complex<double> prefactor_s =
-      prefactor * r_s * omega_pl_quad / kappa_complex;
+      prefactor * r_s * omega_pl * omega_pl / kappa_complex;
   std::complex<double> prefactor_p = prefactor * r_p * kappa_complex;
 
-  // Calculate the G_xx element
-  if (indices(0) == 0 && indices(1) == 0) {
-    result_complex = prefactor_p * cos_phi_quad + prefactor_s * sin_phi_quad;
-  }
-  // Calculate the G_yy element
-  else if (indices(0) == 1 && indices(1) == 1) {
-    result_complex = prefactor_p * sin_phi_quad + prefactor_s * cos_phi_quad;
-  }
-  // Calculate the G_zz element
-  else if (indices(0) == 2 && indices(1) == 2) {
-    result_complex = prefactor_p * k_quad / kappa_quad;
-  }
-  // Calculate the G_zx element
-  else if (indices(0) == 2 && indices(1) == 0) {
-    result_complex = prefactor_p * I * cos_phi * k / kappa_complex;
+  // the xx, yy, zz and zx element, the xz element is the negative of zx
+  elements(0) = prefactor_p * cos_phi_quad + prefactor_s * sin_phi_quad;
+  elements(1) = prefactor_p * sin_phi_quad + prefactor_s * cos_phi_quad;
+  elements(2) = prefactor_p * k * k / kappa_quad;
+  elements(3) = prefactor_p * I * cos_phi * k / kappa_complex;
+}
+
+void GreensTensorPlate::integrand_2d_k(double kappa_double, double omega,
+                                       double phi, vec &result,
+                                       Tensor_Options fancy_complex,
+                                       Weight_Options weight_function) const {
+  cx_vec::fixed<4> elements;
+  double kv, omega_pl;
+  kernel_2d_k(kappa_double, omega, phi, elements, kv, omega_pl);
+
+  result.set_size(4);
+  project_elements(elements, weight(weight_function, kv, omega_pl, omega),
+                   fancy_complex, result, 0);
+}
+
+void GreensTensorPlate::integrand_2d_k(
+    double kappa_double, double omega, double phi,
+    const std::vector<GreensTensorRequest> &requests, vec &result) const {
+  cx_vec::fixed<4> elements;
+  double kv, omega_pl;
+  kernel_2d_k(kappa_double, omega, phi, elements, kv, omega_pl);
+
+  // only the weighting function and the projection differ between requests
+  result.set_size(4 * requests.size());
+  for (uword i = 0; i < requests.size(); i++) {
+    project_elements(elements, weight(requests[i], kv, omega_pl, omega),
+                     requests[i].fancy_complex, result, 4 * i);
   }
-  // Calculate the G_xz element
-  else if (indices(0) == 0 && indices(1) == 2) {
-    result_complex = -prefactor_p * I * cos_phi * k / kappa_complex;
-  } else {
-    result_complex = 0.;
-  }
-
-  // Add weighting function if demanded
-  if (weight_function == KV) {
-    result_complex *= k * cos_phi;
-  } else if (weight_function == TEMP) {
-    result_complex /= (1.0 - exp(-beta * omega_pl));
-  } else if (weight_function == NON_LTE) {
-    result_complex *=
-        1. / (1.0 - exp(-beta * omega_pl)) - 1. / (1.0 - exp(-beta * omega));
-  } else if (weight_function == KV_TEMP) {
-    result_complex *= k * cos_phi / (1.0 - exp(-beta * omega_pl));
-  } else if (weight_function == KV_NON_LTE) {
-    result_complex *=
-        k * cos_phi *
-        (1. / (1.0 - exp(-beta * omega_pl)) - 1. / (1.0 - exp(-beta * omega)));
-  }
-
-  // Calculate fancy real part of the given matrix element
-  if (fancy_complex == RE) {
-    if ((indices(0) == 2 && indices(1) == 0) ||
-        (indices(0) == 0 && indices(1) == 2)) {
-      // Mind the missing leading I! This must be added after the double
-      // integration!
-      result = result_complex.imag();
-    } else {
-      result = result_complex.real();
-    }
+}
+
+void GreensTensorPlate::integrand_2d_k(
+    double kappa_double, double omega, double phi,
+    const std::vector<GreensTensorRequest> &requests,
+    const std::vector<double> &distances, vec &result) const {
+  cx_vec::fixed<4> kernel, elements;
+  double kv, omega_pl;
+  std::complex<double> kappa;
+  kernel_2d_k(kappa_double, omega, phi, kernel, kv, omega_pl, kappa);
+
+  // the weights do not depend on the distance
+  uword m = requests.size();
+  std::vector<double> weights(m);
+  for (uword i = 0; i < m; i++) {
+    weights[i] = weight(requests[i], kv, omega_pl, omega);
   }
-  // Calculate fancy imaginary part of the given matrix element
-  else if (fancy_complex == IM) {
-    if ((indices(0) == 2 && indices(1) == 0) ||
-        (indices(0) == 0 && indices(1) == 2)) {
-      // Mind the missing leading I! This must be added after the double
-      // integration!
-      result = -result_complex.real();
-    } else {
-      result = result_complex.imag();
+
+  // only the factor exp(-2 za kappa) differs between the distances
+  result.set_size(4 * m * distances.size());
+  for (uword j = 0; j < distances.size(); j++) {
+    elements = kernel * exp(-2 * distances[j] * kappa);
+    for (uword i = 0; i < m; i++) {
+      project_elements(elements, weights[i], requests[i].fancy_complex, result,
+                       4 * (j * m + i));
     }
   }
+}
 
-  return result;
+void GreensTensorPlate::integrand_2d_k(const vec &kappa_double, double omega,
+                                       double phi, mat &result,
+                                       Tensor_Options fancy_complex,
+                                       Weight_Options weight_function) const {
+  uword n = kappa_double.n_elem;
+  result.set_size(n, 4);
+
+  // the elements of every node are stored in a row of result
+  vec elements(4);
+  for (uword i = 0; i < n; i++) {
+    this->integrand_2d_k(kappa_double(i), omega, phi, elements, fancy_complex,
+                         weight_function);
+    result.row(i) = elements.t();
+  }
 }
 
 std::complex<double> GreensTensorPlate::get_r_p(double omega, double k) const {
@@ -341,11 +1096,34 @@ std::complex<double> GreensTensorPlate::get_r_s(double omega, double k) const {
   return r_s;
 }
 
+std::shared_ptr<GreensTensor> GreensTensorPlate::with_parameters(
+    const EvaluationParameters &parameters) const {
+  assert(parameters.beta > 0 && parameters.za > 0);
+  auto copy = std::make_shared<GreensTensorPlate>(*this);
+  copy->v = parameters.v;
+  copy->za = parameters.za;
+  copy->beta = parameters.beta;
+  return copy;
+}
+
 double GreensTensorPlate::omega_ch() const {
   // Calculate omega_cut (reasonable for every plate setup)
   return this->delta_cut * this->v / this->za;
 }
 
+std::vector<CharacteristicFrequency>
+GreensTensorPlate::characteristic_frequencies() const {
+  // The Doppler shift omega + k_x v of the integrand smears the resonances of
+  // the reflection coefficients over the frequencies that are shifted onto
+  // them by the typical k_x ~ 1 / za of the decay exp(-2 za kappa).
+  std::vector<CharacteristicFrequency> result =
+      reflection_coefficients->characteristic_frequencies();
+  for (CharacteristicFrequency &frequency : result) {
+    frequency.width += v / za;
+  }
+  return result;
+}
+
 void GreensTensorPlate::print_info(std::ostream &stream) const {
   stream << "# GreensTensorPlate\n#\n"
          << "# v = " << v << "\n"
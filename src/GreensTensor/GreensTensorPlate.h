@@ -6,10 +6,24 @@
 #include <cmath>
 #include <complex>
 #include <memory>
+#include <utility>
+#include <vector>
 
+#include "../Configuration/Configuration.h"
 #include "../ReflectionCoefficients/ReflectionCoefficients.h"
 #include "GreensTensor.h"
 
+// Substitutions of the integration variable, applied to every piece of the
+// kappa integration of the plate. The logarithmic substitution absorbs part of
+// the exponential decay of the evanescent waves, the sigmoidal one clusters
+// the nodes at the boundaries of the pieces.
+enum Substitution_Options { NO_SUBSTITUTION, LOGARITHMIC, SIGMOIDAL };
+
+// Treatment of the last piece of the evanescent kappa integration, which is
+// either truncated at kappa_cut or extended to infinity and integrated with
+// Gauss-Laguerre rules matched to the decay exp(-2 za kappa)
+enum Tail_Options { TRUNCATED, LAGUERRE };
+
 //! The class of the Green's tensor above a flat macroscopic surface
 class GreensTensorPlate : public GreensTensor {
 protected:
@@ -20,6 +34,26 @@ protected:
   double delta_cut;
   vec::fixed<2> rel_err = {NAN, NAN};
 
+  // substitution of the kappa integration variable
+  Substitution_Options substitution = NO_SUBSTITUTION;
+
+  // if true, the phi integration is split at pi / 2 and its nodes are
+  // clustered quadratically there
+  bool regularize_phi = false;
+
+  // treatment of the tail of the evanescent kappa integration
+  Tail_Options tail = TRUNCATED;
+
+  // quadrature of the propagating waves in the kappa integration of the
+  // pointwise integrator, the double-exponential one resolves the end points
+  // without bisection
+  Quadrature_Options kappa_quadrature = ADAPTIVE;
+
+  // if true, the pieces of the phi integration and the separately integrated
+  // requests are OpenMP tasks, which are executed by the threads of the
+  // enclosing parallel region
+  bool task_parallel = false;
+
   // reflection coefficients are needed to describe the surface's response
   std::shared_ptr<ReflectionCoefficients> reflection_coefficients;
 
@@ -30,41 +64,188 @@ public:
       std::shared_ptr<ReflectionCoefficients> reflection_coefficients,
       double delta_cut, const vec::fixed<2> &rel_err);
   explicit GreensTensorPlate(const std::string &input_file);
+  explicit GreensTensorPlate(const Configuration &configuration);
 
   // calculate the tensor in frequency and momentum space
   void calculate_tensor(double omega, vec::fixed<2> k,
                         cx_mat::fixed<3, 3> &GT) const override;
 
   // integrate over a two-dimensional k space
+  using GreensTensor::integrate_k;
   void integrate_k(double omega, cx_mat::fixed<3, 3> &GT,
                    Tensor_Options fancy_complex,
                    Weight_Options weight_function) const override;
 
+  // integrate over a two-dimensional k space for several options at once,
+  // all tensors are obtained from a single integration
+  void integrate_k(double omega,
+                   const std::vector<GreensTensorRequest> &requests,
+                   std::vector<cx_mat::fixed<3, 3>> &GT) const override;
+
+  // integrate over a two-dimensional k space for several requests and
+  // distances at once, the tensor of requests[i] at distances[j] is stored in
+  // GT[j][i]. The distance only enters the factor exp(-2 za kappa), hence all
+  // distances share the nodes of a single integration on the pieces of the
+  // closest distance with the VECTOR integrator. All other integrators
+  // integrate the distances one after another.
+  void integrate_k(double omega,
+                   const std::vector<GreensTensorRequest> &requests,
+                   const std::vector<double> &distances,
+                   std::vector<std::vector<cx_mat::fixed<3, 3>>> &GT) const;
+
+  // integrate the xx, yy, zz and zx element of all requests jointly over the
+  // two-dimensional (phi, kappa) domain with an adaptive cubature, used by
+  // integrate_k with the CUBATURE integrator. The elements of request i are
+  // returned at 4 * i in this order and are not yet normalized by pi.
+  vec integrate_2d_k(double omega,
+                     const std::vector<GreensTensorRequest> &requests) const;
+
+  // Boundaries of the pieces of the kappa integration at fixed phi in
+  // ascending order, starting at 0 and ending at the cut-off, or at infinity
+  // for the LAGUERRE tail. In between lie the low-temperature edge and the
+  // points where the Doppler-shifted frequency hits a resonance of the
+  // reflection coefficients. The edge is placed for the inverse temperature
+  // beta_edge, or for the own one if beta_edge is zero.
+  std::vector<double> kappa_bounds(double omega, double phi,
+                                   double beta_edge = 0) const;
+
+  // Boundaries of the pieces of the phi integration in ascending order,
+  // starting at 0 and ending at pi. In between lie the angles at which the
+  // low-temperature edge or a resonance enters the kappa domain, and the
+  // width of the peak of 1 / (1 - v^2 cos^2 phi) for relativistic velocities.
+  // The regularized phi integration is split at pi / 2 as well. The edge is
+  // placed as in kappa_bounds.
+  std::vector<double> phi_bounds(double omega, double beta_edge = 0) const;
+
   // integrands
   double integrand_1d_k(double phi, double omega, const uvec::fixed<2> &indices,
                         Tensor_Options fancy_complex,
                         Weight_Options weight_function) const;
 
+  // integrand of the xx, yy, zz or zx element, given by element in this
+  // order, of a single request
+  double integrand_1d_k(double phi, double omega,
+                        const GreensTensorRequest &request,
+                        uword element) const;
+
+  // integrand for the joint integration of the xx, yy, zz and zx element,
+  // which are stored in this order in result
+  void integrand_1d_k(double phi, double omega, vec &result,
+                      Tensor_Options fancy_complex,
+                      Weight_Options weight_function) const;
+
+  // integrand for the joint integration of the xx, yy, zz and zx element of
+  // all requests, the elements of request i are stored at 4 * i in result
+  void integrand_1d_k(double phi, double omega,
+                      const std::vector<GreensTensorRequest> &requests,
+                      vec &result) const;
+
+  // integrand for the joint integration of all requests at several distances
+  // on the kappa pieces of the own distance za, the elements of request i at
+  // distances[j] are stored at 4 * (j * requests.size() + i) in result
+  void integrand_1d_k(double phi, double omega,
+                      const std::vector<GreensTensorRequest> &requests,
+                      const std::vector<double> &distances,
+                      vec &result) const;
+
   double integrand_2d_k(double kappa_double, double omega, double phi,
                         const uvec::fixed<2> &indices,
                         Tensor_Options fancy_complex,
                         Weight_Options weight_function) const;
 
+  // integrand of the xx, yy, zz and zx element, computed from one evaluation
+  // of the reflection coefficients and stored in this order in result
+  void integrand_2d_k(double kappa_double, double omega, double phi,
+                      vec &result, Tensor_Options fancy_complex,
+                      Weight_Options weight_function) const;
+
+  // integrand of the xx, yy, zz and zx element of all requests, computed from
+  // one evaluation of the reflection coefficients, the elements of request i
+  // are stored at 4 * i in result
+  void integrand_2d_k(double kappa_double, double omega, double phi,
+                      const std::vector<GreensTensorRequest> &requests,
+                      vec &result) const;
+
+  // integrand of the xx, yy, zz and zx element of all requests at several
+  // distances, computed from one evaluation of the reflection coefficients and
+  // stored like in the corresponding integrand_1d_k
+  void integrand_2d_k(double kappa_double, double omega, double phi,
+                      const std::vector<GreensTensorRequest> &requests,
+                      const std::vector<double> &distances,
+                      vec &result) const;
+
+  // integrand of the xx, yy, zz and zx element evaluated at all nodes in
+  // kappa at once, the elements are stored in the columns of result
+  void integrand_2d_k(const vec &kappa_double, double omega, double phi,
+                      mat &result, Tensor_Options fancy_complex,
+                      Weight_Options weight_function) const;
+
+  // returns a copy with the velocity, distance and temperature of the
+  // parameters, which shares the reflection coefficients
+  std::shared_ptr<GreensTensor>
+  with_parameters(const EvaluationParameters &parameters) const override;
+
   // getter functions
   std::complex<double> get_r_p(double omega, double k) const;
   std::complex<double> get_r_s(double omega, double k) const;
 
   double get_za() const { return this->za; };
+  EvaluationParameters get_parameters() const override {
+    return {this->v, this->za, this->beta};
+  };
   double get_delta_cut() const { return this->delta_cut; };
   double get_rel_err_0() const { return this->rel_err(0); };
   double get_rel_err_1() const { return this->rel_err(1); };
   double omega_ch() const override;
+  std::vector<CharacteristicFrequency>
+  characteristic_frequencies() const override;
+  Substitution_Options get_substitution() const { return this->substitution; };
+  bool get_regularize_phi() const { return this->regularize_phi; };
+  bool get_task_parallel() const { return this->task_parallel; };
+  Tail_Options get_tail() const { return this->tail; };
+  Quadrature_Options get_kappa_quadrature() const {
+    return this->kappa_quadrature;
+  };
+  std::shared_ptr<ReflectionCoefficients> get_reflection_coefficients() const {
+    return this->reflection_coefficients;
+  };
 
   // setter function
   void set_za(double za_new) { this->za = za_new; };
+  void set_substitution(Substitution_Options substitution_new) {
+    this->substitution = substitution_new;
+  };
+  void set_regularize_phi(bool regularize_phi_new) {
+    this->regularize_phi = regularize_phi_new;
+  };
+  void set_tail(Tail_Options tail_new) { this->tail = tail_new; };
+  void set_kappa_quadrature(Quadrature_Options kappa_quadrature_new) {
+    this->kappa_quadrature = kappa_quadrature_new;
+  };
+  void set_task_parallel(bool task_parallel_new) {
+    this->task_parallel = task_parallel_new;
+  };
+  void set_reflection_coefficients(
+      std::shared_ptr<ReflectionCoefficients> reflection_coefficients_new) {
+    this->reflection_coefficients = std::move(reflection_coefficients_new);
+  };
 
   // print info
   void print_info(std::ostream &stream) const override;
+
+protected:
+  // complex xx, yy, zz and zx element of the kernel without weighting
+  // function at (kappa, phi), together with the component kv of the
+  // wavevector along the velocity and the Doppler-shifted frequency omega_pl
+  void kernel_2d_k(double kappa_double, double omega, double phi,
+                   cx_vec::fixed<4> &elements, double &kv,
+                   double &omega_pl) const;
+
+  // the same kernel without the factor exp(-2 za kappa) of the distance,
+  // where the complex kappa is stored in kappa
+  void kernel_2d_k(double kappa_double, double omega, double phi,
+                   cx_vec::fixed<4> &elements, double &kv, double &omega_pl,
+                   std::complex<double> &kappa) const;
 };
 
 #endif // GREENSTENSORPLATE_H
@@ -20,18 +20,19 @@ GreensTensorPlateVacuum::GreensTensorPlateVacuum(
 }
 
 GreensTensorPlateVacuum::GreensTensorPlateVacuum(const std::string &input_file)
-    : GreensTensorPlate(input_file) {
-  // Create a root
-  pt::ptree root;
+    : GreensTensorPlateVacuum(Configuration(input_file)) {}
 
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+GreensTensorPlateVacuum::GreensTensorPlateVacuum(const Configuration &configuration)
+    : GreensTensorPlate(configuration) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
 
   std::string addvacuum = root.get<std::string>("GreensTensor.addvacuum");
   assert(addvacuum == "true");
 
   this->vacuum_greens_tensor =
       std::make_shared<GreensTensorVacuum>(v, beta, this->rel_err(0));
+  this->vacuum_greens_tensor->set_integrator(this->integrator);
 }
 
 void GreensTensorPlateVacuum::integrate_k(
@@ -48,6 +49,22 @@ void GreensTensorPlateVacuum::integrate_k(
   GT += vac;
 }
 
+void GreensTensorPlateVacuum::integrate_k(
+    double omega, const std::vector<GreensTensorRequest> &requests,
+    std::vector<cx_mat::fixed<3, 3>> &GT) const {
+
+  //compute the contributions from the planar surface
+  GreensTensorPlate::integrate_k(omega, requests, GT);
+
+  //compute the contributions from the vacuum
+  std::vector<cx_mat::fixed<3, 3>> vac;
+  vacuum_greens_tensor->integrate_k(omega, requests, vac);
+
+  for (size_t i = 0; i < requests.size(); i++) {
+    GT[i] += vac[i];
+  }
+}
+
 void GreensTensorPlateVacuum::calculate_tensor(double omega, vec::fixed<2> k,
                                                cx_mat::fixed<3, 3> &GT) const {
 
@@ -61,6 +78,18 @@ void GreensTensorPlateVacuum::calculate_tensor(double omega, vec::fixed<2> k,
   GT += vac;
 }
 
+std::shared_ptr<GreensTensor> GreensTensorPlateVacuum::with_parameters(
+    const EvaluationParameters &parameters) const {
+  assert(parameters.beta > 0 && parameters.za > 0);
+  auto copy = std::make_shared<GreensTensorPlateVacuum>(*this);
+  copy->v = parameters.v;
+  copy->za = parameters.za;
+  copy->beta = parameters.beta;
+  copy->vacuum_greens_tensor = std::static_pointer_cast<GreensTensorVacuum>(
+      vacuum_greens_tensor->with_parameters(parameters));
+  return copy;
+}
+
 void GreensTensorPlateVacuum::print_info(std::ostream &stream) const {
   stream << "# GreensTensorPlateVacuum\n#\n"
          << "# v = " << v << "\n"
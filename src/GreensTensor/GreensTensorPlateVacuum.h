@@ -2,6 +2,7 @@
 #define GREENSTENSORPLATEVACUUM_H
 
 #include <memory>
+#include "../Configuration/Configuration.h"
 #include "GreensTensorPlate.h"
 #include "GreensTensorVacuum.h"
 
@@ -15,17 +16,26 @@ public:
                           std::shared_ptr<ReflectionCoefficients> reflection_coefficients,
                           double delta_cut, vec::fixed<2> rel_err);
   explicit GreensTensorPlateVacuum(const std::string &input_file);
+  explicit GreensTensorPlateVacuum(const Configuration &configuration);
 
   // calculate the tensor in frequency and momentum space
   void calculate_tensor(double omega, vec::fixed<2> k,
                         cx_mat::fixed<3, 3> &GT) const override;
 
   // integrate over a two-dimensional k space
+  using GreensTensor::integrate_k;
   void integrate_k(double omega, cx_mat::fixed<3, 3> &GT,
                    Tensor_Options fancy_complex,
                    Weight_Options weight_function) const override;
+  void integrate_k(double omega,
+                   const std::vector<GreensTensorRequest> &requests,
+                   std::vector<cx_mat::fixed<3, 3>> &GT) const override;
 
   // getters
+  // the copy also has its own vacuum Green's tensor with the parameters
+  std::shared_ptr<GreensTensor>
+  with_parameters(const EvaluationParameters &parameters) const override;
+
   std::shared_ptr<GreensTensorVacuum> get_vacuums_greens_tensor() {
     return vacuum_greens_tensor;
   };
@@ -35,6 +45,14 @@ public:
     this->v = v;
     this->vacuum_greens_tensor->set_v(v);
   };
+  void set_beta(double beta) override {
+    GreensTensorPlate::set_beta(beta);
+    this->vacuum_greens_tensor->set_beta(beta);
+  };
+  void set_integrator(Integrator_Options integrator) override {
+    this->integrator = integrator;
+    this->vacuum_greens_tensor->set_integrator(integrator);
+  };
 
   // print info
   void print_info(std::ostream &stream) const override;
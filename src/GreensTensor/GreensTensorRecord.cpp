@@ -0,0 +1,73 @@
+#include <iostream>
+
+#include "GreensTensorRecord.h"
+
+GreensTensorRecord::GreensTensorRecord(size_t capacity) : capacity(capacity) {
+  if (capacity == 0) {
+    std::cerr << "Error: The capacity of the record must be positive ("
+              << capacity << ")!" << std::endl;
+    exit(0);
+  }
+}
+
+bool GreensTensorRecord::find(double omega,
+                              std::vector<GreensTensorIntegral> &found) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto entry = index.find(omega);
+  if (entry == index.end()) {
+    ++misses;
+    return false;
+  }
+  // mark the frequency as most recently used
+  integrals.splice(integrals.begin(), integrals, entry->second);
+  found = entry->second->second;
+  ++hits;
+  return true;
+}
+
+void GreensTensorRecord::store(
+    double omega, const std::vector<GreensTensorIntegral> &new_integrals) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto entry = index.find(omega);
+  if (entry == index.end()) {
+    integrals.emplace_front(omega, std::vector<GreensTensorIntegral>());
+    index[omega] = integrals.begin();
+
+    // discard the least recently used frequencies
+    while (integrals.size() > capacity) {
+      index.erase(integrals.back().first);
+      integrals.pop_back();
+    }
+  } else {
+    integrals.splice(integrals.begin(), integrals, entry->second);
+  }
+
+  std::vector<GreensTensorIntegral> &stored = integrals.front().second;
+  for (const GreensTensorIntegral &integral : new_integrals) {
+    bool known = false;
+    for (const GreensTensorIntegral &other : stored) {
+      known = known || other.request == integral.request;
+    }
+    if (!known) {
+      stored.push_back(integral);
+    }
+  }
+}
+
+void GreensTensorRecord::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  integrals.clear();
+  index.clear();
+  hits = 0;
+  misses = 0;
+}
+
+size_t GreensTensorRecord::get_size() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return integrals.size();
+}
+
+double GreensTensorRecord::get_hit_rate() const {
+  size_t calls = hits + misses;
+  return calls == 0 ? 0. : double(hits) / calls;
+}
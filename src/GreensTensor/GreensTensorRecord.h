@@ -0,0 +1,73 @@
+#ifndef GREENSTENSORRECORD_H
+#define GREENSTENSORRECORD_H
+
+#include <armadillo>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "GreensTensor.h"
+
+using namespace arma;
+
+//! An integrated Green's tensor together with its options
+struct GreensTensorIntegral {
+  GreensTensorRequest request;
+  cx_mat::fixed<3, 3> value;
+};
+
+//! Record of integrated Green's tensors
+/*!
+ * The record stores the integrals of a Green's tensor over k for every
+ * frequency omega at which they have been computed. It allows calculations
+ * that only change the particle, e.g. omega_a, alpha_zero or the memory
+ * kernel of the polarizability, to reuse the expensive k integrals at all
+ * frequencies that have already been visited. The record does not know the
+ * parameters of the Green's tensor, hence it must only be shared by
+ * calculations with identical Green's tensors. The record holds the integrals
+ * of at most capacity frequencies and discards the least recently used ones,
+ * such that long sweeps do not exhaust the memory. It is thread-safe, such
+ * that it can be shared by the Green's tensors of all threads.
+ */
+class GreensTensorRecord {
+private:
+  mutable std::mutex mutex;
+
+  // integrals of every frequency, where the front of the list is the most
+  // recently used frequency
+  mutable std::list<std::pair<double, std::vector<GreensTensorIntegral>>>
+      integrals;
+  std::unordered_map<double, decltype(integrals)::iterator> index;
+
+  // maximal number of stored frequencies
+  size_t capacity;
+
+  // number of frequencies found in or missing from the record
+  mutable std::atomic<size_t> hits{0};
+  mutable std::atomic<size_t> misses{0};
+
+public:
+  // record of the integrals of at most capacity frequencies
+  explicit GreensTensorRecord(size_t capacity = 100000);
+
+  // copies all integrals stored for omega into found and returns false if
+  // there are none
+  bool find(double omega, std::vector<GreensTensorIntegral> &found) const;
+
+  // adds the integrals at omega, integrals that are already stored are kept
+  void store(double omega, const std::vector<GreensTensorIntegral> &new_integrals);
+
+  // empties the record and resets the counters
+  void clear();
+
+  // getter functions
+  size_t get_size() const;
+  size_t get_capacity() const { return capacity; };
+  size_t get_hits() const { return hits; };
+  size_t get_misses() const { return misses; };
+  double get_hit_rate() const;
+};
+
+#endif // GREENSTENSORRECORD_H
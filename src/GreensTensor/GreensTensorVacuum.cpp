@@ -6,6 +6,7 @@
 namespace pt = boost::property_tree;
 
 #include "../Calculations/Integrations.h"
+#include "../Calculations/IntegrationsVector.h"
 #include "GreensTensorVacuum.h"
 
 GreensTensorVacuum::GreensTensorVacuum(double v, double beta, double relerr)
@@ -13,14 +14,14 @@ GreensTensorVacuum::GreensTensorVacuum(double v, double beta, double relerr)
     assert(relerr >= 0);
     }
 
-GreensTensorVacuum::GreensTensorVacuum(const std::string& input_file)
-    : GreensTensor(input_file) {
+GreensTensorVacuum::GreensTensorVacuum(const std::string &input_file)
+    : GreensTensorVacuum(Configuration(input_file)) {}
 
-  // Create a root
-  pt::ptree root;
+GreensTensorVacuum::GreensTensorVacuum(const Configuration &configuration)
+    : GreensTensor(configuration) {
 
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
 
   // Load relative accuracy
   this->relerr = root.get<double>("GreensTensor.rel_err_1");
@@ -73,50 +74,148 @@ void GreensTensorVacuum::integrate_k(double omega, cx_mat::fixed<3, 3> &GT,
 
     // Reset the tensor to store the final result
     GT.zeros();
+
+    // the xx and yy component, which are integrated jointly on a shared
+    // subdivision by the vector integrator
+    auto F = [=](double x, vec &result) -> void {
+      result(0) =
+          this->integrand_k(x, omega, {0, 0}, fancy_complex, weight_function);
+      result(1) =
+          this->integrand_k(x, omega, {1, 1}, fancy_complex, weight_function);
+    };
+
+    // the same integrand evaluated at all nodes of the rule at once
+    auto F_batch = [=](const vec &x, mat &result) -> void {
+      this->integrand_k(x, omega, result, fancy_complex, weight_function);
+    };
+
+    // integrate the elements from a to b with the chosen integrator
+    auto integrate = [&](double a, double b) -> vec {
+      if (integrator == BATCH) {
+        return qag_batch(F_batch, 2, a, b, this->relerr, 0);
+      }
+      if (integrator == VECTOR) {
+        return qag_vec(F, 2, a, b, this->relerr, 0);
+      }
+      // every element is integrated separately
+      vec elements(2);
+      for (uword i = 0; i < 2; i++) {
+        auto F_i = [=](double x) -> double {
+          return this->integrand_k(x, omega, {i, i}, fancy_complex,
+                                   weight_function);
+        };
+        elements(i) = cquad(F_i, a, b, this->relerr, 0);
+      }
+      return elements;
+    };
+
+    vec elements(2);
     // Ensure that the integration limits are properly ordered
     if (omega >= 0) {
-
-      // Numerically integrate the xx component
-      auto F_xx = [=](double x) -> double {
-        return this->integrand_k(x, omega, {0, 0}, fancy_complex,
-                                 weight_function);
-      };
-      GT(0, 0) = cquad(F_xx, -omega / (1.0 + this->v), omega / (1.0 - this->v),
-                       this->relerr, 0);
-
-      // yy component
-      auto F_yy = [=](double x) -> double {
-        return this->integrand_k(x, omega, {1, 1}, fancy_complex,
-                                 weight_function);
-      };
-      GT(1, 1) = cquad(F_yy, -omega / (1.0 + this->v), omega / (1.0 - this->v),
-                       this->relerr, 0);
-
-      // zz component
-      GT(2, 2) = GT(1, 1);
+      elements = integrate(-omega / (1.0 + this->v), omega / (1.0 - this->v));
     }
     // Switching the integration bounds for negative frequencies
-    if (omega < 0) {
-
-      // Numerically integrate the xx component
-      auto F_xx = [=](double x) -> double {
-        return this->integrand_k(x, omega, {0, 0}, fancy_complex,
-                                 weight_function);
-      };
-      GT(0, 0) = -cquad(F_xx, omega / (1.0 - this->v), -omega / (1.0 + this->v),
-                        this->relerr, 0);
-
-      // yy component
-      auto F_yy = [=](double x) -> double {
-        return this->integrand_k(x, omega, {1, 1}, fancy_complex,
-                                 weight_function);
-      };
-      GT(1, 1) = -cquad(F_yy, omega / (1.0 - this->v), -omega / (1.0 + this->v),
-                        this->relerr, 0);
-
-      // zz component
-      GT(2, 2) = GT(1, 1);
+    else {
+      elements = -integrate(omega / (1.0 - this->v), -omega / (1.0 + this->v));
     }
+
+    // xx and yy component
+    GT(0, 0) = elements(0);
+    GT(1, 1) = elements(1);
+
+    // zz component
+    GT(2, 2) = GT(1, 1);
+  }
+}
+
+void GreensTensorVacuum::integrate_k(
+    double omega, const std::vector<GreensTensorRequest> &requests,
+    std::vector<cx_mat::fixed<3, 3>> &GT) const {
+  // the batch integrand is restricted to a single tensor at the own
+  // temperature
+  if (integrator == BATCH) {
+    GT.resize(requests.size());
+    for (uword i = 0; i < requests.size(); i++) {
+      GreensTensorVacuum vacuum(*this);
+      vacuum.set_beta(request_beta(requests[i]));
+      vacuum.integrate_k(omega, GT[i], requests[i].fancy_complex,
+                         requests[i].weight_function);
+    }
+    return;
+  }
+
+  // Only the imaginary parts are implemented, the real parts remain empty
+  std::vector<uword> imaginary;
+  for (uword i = 0; i < requests.size(); i++) {
+    if (requests[i].fancy_complex == IM) {
+      imaginary.push_back(i);
+    }
+  }
+
+  GT.resize(requests.size());
+  for (auto &tensor : GT) {
+    tensor.zeros();
+  }
+  if (imaginary.empty()) {
+    return;
+  }
+
+  // The xx and yy component of the j-th imaginary part are stored at 2 * j
+  // and 2 * j + 1
+  uword n = 2 * imaginary.size();
+  auto component = [&](double kv, uword i) -> double {
+    vec::fixed<2> elements;
+    double omega_pl;
+    kernel_k(kv, omega, elements, omega_pl);
+    return elements(i % 2) *
+           weight(requests[imaginary[i / 2]], kv, omega_pl, omega);
+  };
+
+  // all components, which are integrated jointly on a shared subdivision by
+  // the vector integrator, share the kernel
+  auto F = [&](double kv, vec &result) -> void {
+    vec::fixed<2> elements;
+    double omega_pl;
+    kernel_k(kv, omega, elements, omega_pl);
+    for (uword j = 0; j < imaginary.size(); j++) {
+      result.subvec(2 * j, 2 * j + 1) =
+          elements * weight(requests[imaginary[j]], kv, omega_pl, omega);
+    }
+  };
+
+  // integrate the components from a to b with the chosen integrator
+  auto integrate = [&](double a, double b) -> vec {
+    if (integrator == VECTOR) {
+      return qag_vec(F, n, a, b, this->relerr, 0);
+    }
+    // every component is integrated separately
+    vec elements(n);
+    for (uword i = 0; i < n; i++) {
+      auto F_i = [&](double kv) -> double { return component(kv, i); };
+      elements(i) = cquad(F_i, a, b, this->relerr, 0);
+    }
+    return elements;
+  };
+
+  vec elements(n);
+  // Ensure that the integration limits are properly ordered
+  if (omega >= 0) {
+    elements = integrate(-omega / (1.0 + this->v), omega / (1.0 - this->v));
+  }
+  // Switching the integration bounds for negative frequencies
+  else {
+    elements = -integrate(omega / (1.0 - this->v), -omega / (1.0 + this->v));
+  }
+
+  for (uword j = 0; j < imaginary.size(); j++) {
+    cx_mat::fixed<3, 3> &tensor = GT[imaginary[j]];
+
+    // xx and yy component
+    tensor(0, 0) = elements(2 * j);
+    tensor(1, 1) = elements(2 * j + 1);
+
+    // zz component
+    tensor(2, 2) = tensor(1, 1);
   }
 }
 
@@ -127,42 +226,61 @@ double GreensTensorVacuum::integrand_k(double kv, double omega,
                                        const uvec::fixed<2> &indices,
                                        Tensor_Options fancy_complex,
                                        Weight_Options weight_function) const {
-  double omega_pl = (omega + kv * v);
-  double omega_pl_quad = omega_pl * omega_pl;
-  double xi_quad = omega_pl_quad - kv * kv;
+  // Only the imaginary part of the diagonal elements is implemented, where
+  // the zz element equals the yy element
+  if (fancy_complex != IM || indices(0) != indices(1)) {
+    return 0;
+  }
 
-  // Variable to store the final result
-  double result = 0;
+  vec::fixed<2> elements;
+  double omega_pl;
+  kernel_k(kv, omega, elements, omega_pl);
+
+  // Multply with the additional weight function f, the options can be found
+  // in eq. (11)
+  return elements(std::min<uword>(indices(0), 1)) *
+         weight(weight_function, kv, omega_pl, omega);
+}
+
+void GreensTensorVacuum::integrand_k(const vec &kv, double omega, mat &result,
+                                     Tensor_Options fancy_complex,
+                                     Weight_Options weight_function) const {
+  uword n = kv.n_elem;
+  result.zeros(n, 2);
 
   // Only the imaginary part is implemented
-  if (fancy_complex == IM) {
-    // Compute the basis integrand of eq. (10)
-    if (indices(0) == 0 && indices(1) == 0) {
-      result = 0.5 * xi_quad;
-    } else if (indices(0) == indices(1)) {
-      result = 0.5 * (omega_pl_quad - xi_quad * 0.5);
-    } else {
-      return 0;
-    }
+  if (fancy_complex != IM) {
+    return;
+  }
 
-    // Multply with the additional weight function f, the options can be found
-    // in eq. (11)
-    if (weight_function == KV) {
-      result *= kv;
-    } else if (weight_function == TEMP) {
-      result /= (1.0 - exp(-beta * omega_pl));
-    } else if (weight_function == KV_TEMP) {
-      result *= kv / (1.0 - exp(-beta * omega_pl));
-    } else if (weight_function == NON_LTE) {
-      result *=
-          (1. / (1. - exp(-beta * omega_pl)) - 1. / (1. - exp(-beta * omega)));
-    } else if (weight_function == KV_NON_LTE) {
-      result *= kv * (1. / (1. - exp(-beta * omega_pl)) -
-                      1. / (1. - exp(-beta * omega)));
-    }
+  for (uword i = 0; i < n; i++) {
+    vec::fixed<2> elements;
+    double omega_pl;
+    kernel_k(kv(i), omega, elements, omega_pl);
+    result.row(i) =
+        elements.t() * weight(weight_function, kv(i), omega_pl, omega);
   }
+}
+
+void GreensTensorVacuum::kernel_k(double kv, double omega,
+                                  vec::fixed<2> &elements,
+                                  double &omega_pl) const {
+  omega_pl = (omega + kv * v);
+  double omega_pl_quad = omega_pl * omega_pl;
+  double xi_quad = omega_pl_quad - kv * kv;
+
+  // Compute the basis integrand of eq. (10)
+  elements(0) = 0.5 * xi_quad;
+  elements(1) = 0.5 * (omega_pl_quad - xi_quad * 0.5);
+}
 
-  return result;
+std::shared_ptr<GreensTensor> GreensTensorVacuum::with_parameters(
+    const EvaluationParameters &parameters) const {
+  assert(parameters.beta > 0);
+  auto copy = std::make_shared<GreensTensorVacuum>(*this);
+  copy->v = parameters.v;
+  copy->beta = parameters.beta;
+  return copy;
 }
 
 double GreensTensorVacuum::omega_ch() const { return 0; }
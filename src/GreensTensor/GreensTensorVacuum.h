@@ -1,6 +1,7 @@
 #ifndef GREENSTENSORVACUUM_H
 #define GREENSTENSORVACUUM_H
 
+#include "../Configuration/Configuration.h"
 #include "GreensTensor.h"
 #include <cmath>
 #include <complex>
@@ -13,26 +14,49 @@ public:
   // constructors
   GreensTensorVacuum(double v, double beta, double relerr);
   GreensTensorVacuum(const std::string& input_file);
+  explicit GreensTensorVacuum(const Configuration &configuration);
 
   // calculate the tensor in frequency and momentum space
   void calculate_tensor(double omega, vec::fixed<2> k,
                         cx_mat::fixed<3, 3> &GT) const override ;
 
   // integrate over a two-dimensional k space
+  using GreensTensor::integrate_k;
   void integrate_k(double omega, cx_mat::fixed<3, 3> &GT,
                    Tensor_Options fancy_complex,
                    Weight_Options weight_function) const override;
 
+  // integrate over a two-dimensional k space for several options at once,
+  // all imaginary parts are obtained from a single integration
+  void integrate_k(double omega,
+                   const std::vector<GreensTensorRequest> &requests,
+                   std::vector<cx_mat::fixed<3, 3>> &GT) const override;
+
   // integrand for integration over one-dimensional k space
   double integrand_k(double kv, double omega, const uvec::fixed<2> &indices,
                                          Tensor_Options fancy_complex,
                                          Weight_Options weight_function) const;
 
+  // integrand of the xx and yy element evaluated at all nodes in kv at once,
+  // the elements are stored in the columns of result
+  void integrand_k(const vec &kv, double omega, mat &result,
+                   Tensor_Options fancy_complex,
+                   Weight_Options weight_function) const;
+
+  std::shared_ptr<GreensTensor>
+  with_parameters(const EvaluationParameters &parameters) const override;
+
   double omega_ch() const override;
   double get_relerr() const { return this->relerr; };
 
   // print info
   void print_info(std::ostream &stream) const override;
+
+protected:
+  // xx and yy element of the kernel without weighting function at kv,
+  // together with the Doppler-shifted frequency omega_pl
+  void kernel_k(double kv, double omega, vec::fixed<2> &elements,
+                double &omega_pl) const;
 };
 
 #endif // GREENSTENSORVACUUM_H
@@ -12,11 +12,13 @@ Looper::Looper(double start, double end, int number_of_steps, const std::string
   this->calculate_steps();
 }
 
-Looper::Looper(const std::string &input_file) {
+Looper::Looper(const std::string &input_file)
+    : Looper(Configuration(input_file)) {}
+
+Looper::Looper(const Configuration &configuration) {
 
   // read parameters
-  pt::ptree root;
-  pt::read_json(input_file, root);
+  const pt::ptree &root = configuration.get_root();
   this->start = root.get<double>("Looper.start");
   this->end = root.get<double>("Looper.end");
   this->number_of_steps = root.get<double>("Looper.steps");
@@ -43,3 +45,12 @@ void Looper::calculate_steps() {
     exit(-1);
   }
 }
+
+vec Looper::calculate_batch(int batch_index,
+                            std::shared_ptr<Friction> quantum_friction) const {
+  return {this->calculate_value(batch_index, quantum_friction)};
+}
+
+int Looper::get_batches_total() const {
+  return (number_of_steps + get_batch() - 1) / get_batch();
+}
@@ -1,6 +1,7 @@
 #ifndef LOOPER_H
 #define LOOPER_H
 
+#include "../Configuration/Configuration.h"
 #include "../Friction/Friction.h"
 #include <string>
 
@@ -19,16 +20,33 @@ public:
   Looper(double start, double end, int number_of_steps,
          const std::string &scale);
   explicit Looper(const std::string &input_file);
+  explicit Looper(const Configuration &configuration);
 
   // calculate the the value of quantum friction
   virtual double
   calculate_value(int step,
                   std::shared_ptr<Friction> quantum_friction) const = 0;
 
+  // calculate the values of quantum friction of all steps of the batch with
+  // the given index, loopers without batches calculate a single step
+  virtual vec calculate_batch(int batch_index,
+                              std::shared_ptr<Friction> quantum_friction) const;
+
+  // true if calculate_value changes the friction object, otherwise a single
+  // friction object can be shared by all threads
+  virtual bool changes_friction() const { return false; };
+
   // getter functions
   int get_steps_total() const { return this->number_of_steps; };
   double get_step(int i) const { return this->steps[i]; };
 
+  // number of consecutive steps calculated together by calculate_batch
+  virtual int get_batch() const { return 1; };
+  int get_batches_total() const;
+  int get_batch_first(int batch_index) const {
+    return batch_index * get_batch();
+  };
+
   // print info
   virtual void print_info(std::ostream &stream) const = 0;
 };
@@ -0,0 +1,39 @@
+// json parser
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+namespace pt = boost::property_tree;
+
+#include "LooperAlphaZero.h"
+
+LooperAlphaZero::LooperAlphaZero(double start, double end, int number_of_steps,
+                                 const std::string &scale)
+    : LooperParticle(start, end, number_of_steps, scale) {}
+
+LooperAlphaZero::LooperAlphaZero(const std::string &input_file)
+    : LooperAlphaZero(Configuration(input_file)) {}
+
+LooperAlphaZero::LooperAlphaZero(const Configuration &configuration)
+    : LooperParticle(configuration) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
+
+  // check if type is right
+  std::string type = root.get<std::string>("Looper.type");
+  assert(type == "alpha_zero");
+}
+
+double LooperAlphaZero::calculate_value(
+    int step, std::shared_ptr<Friction> quantum_friction) const {
+  // change alpha_zero
+  quantum_friction->get_polarizability()->set_alpha_zero(this->steps[step]);
+
+  return this->calculate_friction(quantum_friction);
+}
+
+void LooperAlphaZero::print_info(std::ostream &stream) const {
+  stream << "# LooperAlphaZero\n#\n"
+         << "# start = " << start << "\n"
+         << "# end = " << end << "\n"
+         << "# number_of_steps = " << number_of_steps << "\n"
+         << "# scale = " << scale << "\n";
+}
@@ -0,0 +1,26 @@
+#ifndef LOOPERALPHAZERO_H
+#define LOOPERALPHAZERO_H
+
+#include "../Configuration/Configuration.h"
+#include "../Friction/Friction.h"
+#include "LooperParticle.h"
+#include <string>
+
+class LooperAlphaZero : public LooperParticle {
+public:
+  // constructors
+  LooperAlphaZero(double start, double end, int number_of_steps,
+                  const std::string &scale);
+  LooperAlphaZero(const std::string &input_file);
+  explicit LooperAlphaZero(const Configuration &configuration);
+
+  // calculate the the value of quantum friction
+  double
+  calculate_value(int step,
+                  std::shared_ptr<Friction> quantum_friction) const override;
+
+  // print info
+  void print_info(std::ostream &stream) const override;
+};
+
+#endif // LOOPERALPHAZERO_H
@@ -0,0 +1,40 @@
+#include <algorithm>
+#include <cassert>
+
+// json parser
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+namespace pt = boost::property_tree;
+
+#include "LooperBatch.h"
+
+LooperBatch::LooperBatch(double start, double end, int number_of_steps,
+                         const std::string &scale, int batch)
+    : Looper(start, end, number_of_steps, scale), batch(batch) {
+  assert(batch > 0);
+}
+
+LooperBatch::LooperBatch(const std::string &input_file)
+    : LooperBatch(Configuration(input_file)) {}
+
+LooperBatch::LooperBatch(const Configuration &configuration) : Looper(configuration) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
+
+  // read the number of steps calculated together
+  this->batch = root.get<int>("Looper.batch", 1);
+  assert(batch > 0);
+}
+
+vec LooperBatch::calculate_batch(
+    int batch_index, std::shared_ptr<Friction> quantum_friction) const {
+  int first = get_batch_first(batch_index);
+  int last = std::min(first + batch, number_of_steps);
+  if (last - first == 1) {
+    return {this->calculate_value(first, quantum_friction)};
+  }
+
+  // calculate all steps of the batch at once
+  std::vector<double> values(steps.begin() + first, steps.begin() + last);
+  return this->calculate_together(values, quantum_friction);
+}
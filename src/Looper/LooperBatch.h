@@ -0,0 +1,47 @@
+#ifndef LOOPERBATCH_H
+#define LOOPERBATCH_H
+
+#include "../Configuration/Configuration.h"
+#include "../Friction/Friction.h"
+#include "Looper.h"
+#include <string>
+#include <vector>
+
+//! An abstract looper that calculates several steps together
+/*!
+ * Consecutive steps are grouped into batches of the optional size "batch",
+ * which are calculated together by calculate_batch such that they share the
+ * expensive evaluations of the integrands. Every batch is calculated by a
+ * single call, hence the threads of a loop over the batches never wait for
+ * each other. The value of a single step is calculated on its own by
+ * calculate_value. With the default size 1 every batch consists of a single
+ * step.
+ */
+class LooperBatch : public Looper {
+private:
+  // number of consecutive steps that are calculated together
+  int batch = 1;
+
+protected:
+  // calculate the values of quantum friction at several running variables at
+  // once
+  virtual vec
+  calculate_together(const std::vector<double> &values,
+                     std::shared_ptr<Friction> quantum_friction) const = 0;
+
+public:
+  // constructors
+  LooperBatch(double start, double end, int number_of_steps,
+              const std::string &scale, int batch);
+  explicit LooperBatch(const std::string &input_file);
+  explicit LooperBatch(const Configuration &configuration);
+
+  // calculate the values of all steps of the batch together
+  vec calculate_batch(int batch_index,
+                      std::shared_ptr<Friction> quantum_friction) const override;
+
+  // getter functions
+  int get_batch() const override { return batch; };
+};
+
+#endif // LOOPERBATCH_H
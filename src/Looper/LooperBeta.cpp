@@ -0,0 +1,49 @@
+// json parser
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+namespace pt = boost::property_tree;
+
+#include "LooperBeta.h"
+
+LooperBeta::LooperBeta(double start, double end, int number_of_steps,
+                       const std::string &scale, int batch)
+    : LooperBatch(start, end, number_of_steps, scale, batch) {}
+
+LooperBeta::LooperBeta(const std::string &input_file)
+    : LooperBeta(Configuration(input_file)) {}
+
+LooperBeta::LooperBeta(const Configuration &configuration)
+    : LooperBatch(configuration) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
+
+  // check if type is right
+  std::string type = root.get<std::string>("Looper.type");
+  assert(type == "beta");
+}
+
+double
+LooperBeta::calculate_value(int step,
+                            std::shared_ptr<Friction> quantum_friction) const {
+  // the temperature is passed to the evaluation, the model is not changed
+  EvaluationParameters parameters =
+      quantum_friction->get_greens_tensor()->get_parameters();
+  parameters.beta = this->steps[step];
+  return quantum_friction->calculate(NON_LTE_ONLY, parameters);
+}
+
+vec LooperBeta::calculate_together(
+    const std::vector<double> &values,
+    std::shared_ptr<Friction> quantum_friction) const {
+  // the temperatures share the kernel evaluations of the Green's tensor
+  return quantum_friction->calculate_temperatures(NON_LTE_ONLY, values);
+}
+
+void LooperBeta::print_info(std::ostream &stream) const {
+  stream << "# LooperBeta\n#\n"
+         << "# start = " << start << "\n"
+         << "# end = " << end << "\n"
+         << "# number_of_steps = " << number_of_steps << "\n"
+         << "# scale = " << scale << "\n"
+         << "# batch = " << get_batch() << "\n";
+}
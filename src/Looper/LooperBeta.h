@@ -0,0 +1,33 @@
+#ifndef LOOPERBETA_H
+#define LOOPERBETA_H
+
+#include "../Configuration/Configuration.h"
+#include "../Friction/Friction.h"
+#include "LooperBatch.h"
+#include <string>
+
+class LooperBeta : public LooperBatch {
+protected:
+  // calculate the friction at all temperatures of a batch at once
+  vec calculate_together(
+      const std::vector<double> &values,
+      std::shared_ptr<Friction> quantum_friction) const override;
+
+public:
+  // constructors, a batch of inverse temperatures shares the kernel
+  // evaluations of the integrations of the Green's tensor
+  LooperBeta(double start, double end, int number_of_steps,
+             const std::string &scale, int batch = 1);
+  LooperBeta(const std::string &input_file);
+  explicit LooperBeta(const Configuration &configuration);
+
+  // calculate the the value of quantum friction
+  double
+  calculate_value(int step,
+                  std::shared_ptr<Friction> quantum_friction) const override;
+
+  // print info
+  void print_info(std::ostream &stream) const override;
+};
+
+#endif // LOOPERBETA_H
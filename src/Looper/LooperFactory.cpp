@@ -5,25 +5,40 @@
 #include <boost/property_tree/ptree.hpp>
 namespace pt = boost::property_tree;
 
+#include "LooperAlphaZero.h"
+#include "LooperBeta.h"
 #include "LooperFactory.h"
+#include "LooperGamma.h"
+#include "LooperOmegaA.h"
 #include "LooperV.h"
 #include "LooperZa.h"
 
-std::shared_ptr<Looper> LooperFactory::create(const std::string &input_file) {
-  // Create a root
-  pt::ptree root;
+std::shared_ptr<Looper>
+LooperFactory::create(const std::string &input_file) {
+  return create(Configuration(input_file));
+}
 
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+std::shared_ptr<Looper>
+LooperFactory::create(const Configuration &configuration) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
 
   // read the type of the kernel
   std::string type = root.get<std::string>("Looper.type");
 
   // set the right pointer, show error if type is unknown
   if (type == "v") {
-    return std::make_shared<LooperV>(input_file);
+    return std::make_shared<LooperV>(configuration);
   } else if (type == "za") {
-    return std::make_shared<LooperZa>(input_file);
+    return std::make_shared<LooperZa>(configuration);
+  } else if (type == "omega_a") {
+    return std::make_shared<LooperOmegaA>(configuration);
+  } else if (type == "alpha_zero") {
+    return std::make_shared<LooperAlphaZero>(configuration);
+  } else if (type == "gamma") {
+    return std::make_shared<LooperGamma>(configuration);
+  } else if (type == "beta") {
+    return std::make_shared<LooperBeta>(configuration);
   } else {
     std::cerr << "Error: Unknown Looper type (" << type << ")!" << std::endl;
     exit(0);
@@ -2,11 +2,13 @@
 #define LOOPERFACTORY_H
 
 #include <memory>
+#include "../Configuration/Configuration.h"
 #include "Looper.h"
 
 class LooperFactory {
 public:
   static std::shared_ptr<Looper> create(const std::string &input_file);
+  static std::shared_ptr<Looper> create(const Configuration &configuration);
 };
 
 #endif // LOOPERFACTORY_H
@@ -0,0 +1,57 @@
+#include <iostream>
+
+// json parser
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+namespace pt = boost::property_tree;
+
+#include "../MemoryKernel/OhmicMemoryKernel.h"
+#include "../MemoryKernel/SinglePhononMemoryKernel.h"
+#include "LooperGamma.h"
+
+LooperGamma::LooperGamma(double start, double end, int number_of_steps,
+                         const std::string &scale)
+    : LooperParticle(start, end, number_of_steps, scale) {}
+
+LooperGamma::LooperGamma(const std::string &input_file)
+    : LooperGamma(Configuration(input_file)) {}
+
+LooperGamma::LooperGamma(const Configuration &configuration)
+    : LooperParticle(configuration) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
+
+  // check if type is right
+  std::string type = root.get<std::string>("Looper.type");
+  assert(type == "gamma");
+}
+
+double
+LooperGamma::calculate_value(int step,
+                             std::shared_ptr<Friction> quantum_friction) const {
+  // change the damping coefficient gamma of the memory kernel
+  auto mu = quantum_friction->get_polarizability()->get_memory_kernel();
+  auto ohmic = std::dynamic_pointer_cast<OhmicMemoryKernel>(mu);
+  auto phonon = std::dynamic_pointer_cast<SinglePhononMemoryKernel>(mu);
+
+  if (ohmic != nullptr) {
+    ohmic->set_gamma(this->steps[step]);
+  } else if (phonon != nullptr) {
+    phonon->set_gamma(this->steps[step]);
+  } else {
+    std::cerr << "You try to loop over gamma, but did not give an ohmic or "
+                 "single phonon memory kernel."
+              << std::endl;
+    exit(-1);
+  }
+
+  return this->calculate_friction(quantum_friction);
+}
+
+void LooperGamma::print_info(std::ostream &stream) const {
+  stream << "# LooperGamma\n#\n"
+         << "# start = " << start << "\n"
+         << "# end = " << end << "\n"
+         << "# number_of_steps = " << number_of_steps << "\n"
+         << "# scale = " << scale << "\n";
+}
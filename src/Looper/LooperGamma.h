@@ -0,0 +1,26 @@
+#ifndef LOOPERGAMMA_H
+#define LOOPERGAMMA_H
+
+#include "../Configuration/Configuration.h"
+#include "../Friction/Friction.h"
+#include "LooperParticle.h"
+#include <string>
+
+class LooperGamma : public LooperParticle {
+public:
+  // constructors
+  LooperGamma(double start, double end, int number_of_steps,
+              const std::string &scale);
+  LooperGamma(const std::string &input_file);
+  explicit LooperGamma(const Configuration &configuration);
+
+  // calculate the the value of quantum friction
+  double
+  calculate_value(int step,
+                  std::shared_ptr<Friction> quantum_friction) const override;
+
+  // print info
+  void print_info(std::ostream &stream) const override;
+};
+
+#endif // LOOPERGAMMA_H
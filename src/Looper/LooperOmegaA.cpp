@@ -0,0 +1,46 @@
+// json parser
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+namespace pt = boost::property_tree;
+
+#include "LooperOmegaA.h"
+
+LooperOmegaA::LooperOmegaA(double start, double end, int number_of_steps,
+                           const std::string &scale)
+    : LooperParticle(start, end, number_of_steps, scale) {}
+
+LooperOmegaA::LooperOmegaA(const std::string &input_file)
+    : LooperOmegaA(Configuration(input_file)) {}
+
+LooperOmegaA::LooperOmegaA(const Configuration &configuration)
+    : LooperParticle(configuration) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
+
+  // check if type is right
+  std::string type = root.get<std::string>("Looper.type");
+  assert(type == "omega_a");
+}
+
+double
+LooperOmegaA::calculate_value(int step,
+                              std::shared_ptr<Friction> quantum_friction) const {
+  // change omega_a
+  quantum_friction->get_polarizability()->set_omega_a(this->steps[step]);
+
+  // The breakpoints of the omega integration around the resonance move with
+  // omega_a. Breakpoints enclosing the whole sweep give all steps the same
+  // subintervals below and above the resonances, where the integrals of the
+  // Green's tensor are reused.
+  quantum_friction->set_omega_breakpoints({0.99 * start, 1.001 * end});
+
+  return this->calculate_friction(quantum_friction);
+}
+
+void LooperOmegaA::print_info(std::ostream &stream) const {
+  stream << "# LooperOmegaA\n#\n"
+         << "# start = " << start << "\n"
+         << "# end = " << end << "\n"
+         << "# number_of_steps = " << number_of_steps << "\n"
+         << "# scale = " << scale << "\n";
+}
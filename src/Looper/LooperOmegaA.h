@@ -0,0 +1,26 @@
+#ifndef LOOPEROMEGAA_H
+#define LOOPEROMEGAA_H
+
+#include "../Configuration/Configuration.h"
+#include "../Friction/Friction.h"
+#include "LooperParticle.h"
+#include <string>
+
+class LooperOmegaA : public LooperParticle {
+public:
+  // constructors
+  LooperOmegaA(double start, double end, int number_of_steps,
+               const std::string &scale);
+  LooperOmegaA(const std::string &input_file);
+  explicit LooperOmegaA(const Configuration &configuration);
+
+  // calculate the the value of quantum friction
+  double
+  calculate_value(int step,
+                  std::shared_ptr<Friction> quantum_friction) const override;
+
+  // print info
+  void print_info(std::ostream &stream) const override;
+};
+
+#endif // LOOPEROMEGAA_H
@@ -0,0 +1,19 @@
+#include "LooperParticle.h"
+
+LooperParticle::LooperParticle(double start, double end, int number_of_steps,
+                               const std::string &scale)
+    : Looper(start, end, number_of_steps, scale),
+      greens_record(std::make_shared<GreensTensorRecord>()) {}
+
+LooperParticle::LooperParticle(const std::string &input_file)
+    : LooperParticle(Configuration(input_file)) {}
+
+LooperParticle::LooperParticle(const Configuration &configuration)
+    : Looper(configuration),
+      greens_record(std::make_shared<GreensTensorRecord>()) {}
+
+double LooperParticle::calculate_friction(
+    std::shared_ptr<Friction> quantum_friction) const {
+  quantum_friction->set_greens_record(greens_record);
+  return quantum_friction->calculate(NON_LTE_ONLY);
+}
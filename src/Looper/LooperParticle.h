@@ -0,0 +1,45 @@
+#ifndef LOOPERPARTICLE_H
+#define LOOPERPARTICLE_H
+
+#include "../Configuration/Configuration.h"
+#include "../Friction/Friction.h"
+#include "../GreensTensor/GreensTensorRecord.h"
+#include "Looper.h"
+#include <memory>
+#include <string>
+
+//! An abstract looper over parameters of the particle
+/*!
+ * The parameters of the particle only enter the polarizability, but not the
+ * integrals of the Green's tensor. All steps therefore share a record of the
+ * Green's tensor integrals, such that they are only computed at frequencies
+ * that no previous step has visited. The record is only valid for a single
+ * Green's tensor configuration, hence all friction objects passed to
+ * calculate_value must describe the same Green's tensor.
+ */
+class LooperParticle : public Looper {
+protected:
+  // record of the Green's tensor integrals shared by all steps
+  std::shared_ptr<GreensTensorRecord> greens_record;
+
+  // calculate the friction with the integrals of the Green's tensor taken
+  // from the record
+  double calculate_friction(std::shared_ptr<Friction> quantum_friction) const;
+
+public:
+  // constructors
+  LooperParticle(double start, double end, int number_of_steps,
+                 const std::string &scale);
+  explicit LooperParticle(const std::string &input_file);
+  explicit LooperParticle(const Configuration &configuration);
+
+  // the parameters of the particle are changed in the polarizability
+  bool changes_friction() const override { return true; };
+
+  // getter functions
+  std::shared_ptr<GreensTensorRecord> get_greens_record() const {
+    return greens_record;
+  };
+};
+
+#endif // LOOPERPARTICLE_H
@@ -9,12 +9,12 @@ LooperV::LooperV(double start, double end, int number_of_steps,
                  const std::string &scale)
     : Looper(start, end, number_of_steps, scale) {}
 
-LooperV::LooperV(const std::string &input_file) : Looper(input_file) {
-  // Create a root
-  pt::ptree root;
+LooperV::LooperV(const std::string &input_file)
+    : LooperV(Configuration(input_file)) {}
 
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+LooperV::LooperV(const Configuration &configuration) : Looper(configuration) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
 
   // check if type is right
   std::string type = root.get<std::string>("Looper.type");
@@ -24,10 +24,12 @@ LooperV::LooperV(const std::string &input_file) : Looper(input_file) {
 double
 LooperV::calculate_value(int step,
                          std::shared_ptr<Friction> quantum_friction) const {
-  // change v
-  quantum_friction->get_greens_tensor()->set_v(this->steps[step]);
+  // the velocity is passed to the evaluation, the model is not changed
+  EvaluationParameters parameters =
+      quantum_friction->get_greens_tensor()->get_parameters();
+  parameters.v = this->steps[step];
 
-  return quantum_friction->calculate(NON_LTE_ONLY);
+  return quantum_friction->calculate(NON_LTE_ONLY, parameters);
 }
 
 void LooperV::print_info(std::ostream &stream) const {
@@ -1,6 +1,7 @@
 #ifndef LOOPERV_H
 #define LOOPERV_H
 
+#include "../Configuration/Configuration.h"
 #include "../Friction/Friction.h"
 #include "Looper.h"
 #include <string>
@@ -10,6 +11,7 @@ public:
   // constructors
   LooperV(double start, double end, int number_of_steps, const std::string &scale);
   LooperV(const std::string &input_file);
+  explicit LooperV(const Configuration &configuration);
 
   // calculate the the value of quantum friction
   double calculate_value(int step, std::shared_ptr<Friction> quantum_friction) const override;
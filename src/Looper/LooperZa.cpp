@@ -7,15 +7,15 @@ namespace pt = boost::property_tree;
 #include "LooperZa.h"
 
 LooperZa::LooperZa(double start, double end, int number_of_steps,
-                   const std::string &scale)
-    : Looper(start, end, number_of_steps, scale) {}
+                   const std::string &scale, int batch)
+    : LooperBatch(start, end, number_of_steps, scale, batch) {}
 
-LooperZa::LooperZa(const std::string &input_file) : Looper(input_file) {
-  // Create a root
-  pt::ptree root;
+LooperZa::LooperZa(const std::string &input_file)
+    : LooperZa(Configuration(input_file)) {}
 
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+LooperZa::LooperZa(const Configuration &configuration) : LooperBatch(configuration) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
 
   // check if type is right
   std::string type = root.get<std::string>("Looper.type");
@@ -25,7 +25,7 @@ LooperZa::LooperZa(const std::string &input_file) : Looper(input_file) {
 double LooperZa::calculate_value(int step,
                                  std::shared_ptr<Friction> quantum_friction) const {
 
-  // change za
+  // the distance is passed to the evaluation, the model is not changed
   auto pt = std::dynamic_pointer_cast<GreensTensorPlate>(
       quantum_friction->get_greens_tensor());
 
@@ -36,9 +36,16 @@ double LooperZa::calculate_value(int step,
     exit(-1);
   }
 
-  pt->set_za(this->steps[step]);
+  EvaluationParameters parameters = pt->get_parameters();
+  parameters.za = this->steps[step];
+  return quantum_friction->calculate(NON_LTE_ONLY, parameters);
+}
 
-  return quantum_friction->calculate(NON_LTE_ONLY);
+vec LooperZa::calculate_together(
+    const std::vector<double> &values,
+    std::shared_ptr<Friction> quantum_friction) const {
+  // the distances share the nodes of the integrations of the plate
+  return quantum_friction->calculate(NON_LTE_ONLY, values);
 }
 
 void LooperZa::print_info(std::ostream &stream) const {
@@ -46,5 +53,6 @@ void LooperZa::print_info(std::ostream &stream) const {
          << "# start = " << start << "\n"
          << "# end = " << end << "\n"
          << "# number_of_steps = " << number_of_steps << "\n"
-         << "# scale = " << scale << "\n";
+         << "# scale = " << scale << "\n"
+         << "# batch = " << get_batch() << "\n";
 }
@@ -1,16 +1,25 @@
 #ifndef LOOPERZA_H
 #define LOOPERZA_H
 
+#include "../Configuration/Configuration.h"
 #include "../Friction/Friction.h"
-#include "Looper.h"
+#include "LooperBatch.h"
 #include <string>
 
-class LooperZa : public Looper {
+class LooperZa : public LooperBatch {
+protected:
+  // calculate the friction at all distances of a batch at once
+  vec calculate_together(
+      const std::vector<double> &values,
+      std::shared_ptr<Friction> quantum_friction) const override;
+
 public:
-  // constructors
+  // constructors, a batch of distances above a plate shares the nodes of the
+  // integrations of the Green's tensor
   LooperZa(double start, double end, int number_of_steps,
-           const std::string &scale);
+           const std::string &scale, int batch = 1);
   LooperZa(const std::string &input_file);
+  explicit LooperZa(const Configuration &configuration);
 
   // calculate the the value of quantum friction
   double
@@ -3,6 +3,9 @@
 
 #include <cmath>
 #include <complex>
+#include <vector>
+
+#include "../Calculations/CharacteristicFrequency.h"
 
 //! An abstract class for memory kernels
 class MemoryKernel {
@@ -10,6 +13,13 @@ public:
   // Returns the memory kernel given a frequency omega.
   virtual std::complex<double> calculate(double omega) const = 0;
 
+  // Characteristic frequencies of the memory kernel, e.g. the resonances of
+  // its bath, by default none are known
+  virtual std::vector<CharacteristicFrequency>
+  characteristic_frequencies() const {
+    return {};
+  }
+
   // print info
   virtual void print_info(std::ostream &stream) const =0;
 };
@@ -12,20 +12,23 @@ namespace pt = boost::property_tree;
 std::shared_ptr<MemoryKernel>
 MemoryKernelFactory::create(const std::string &input_file,
                             const std::string &section) {
-  // Create a root
-  pt::ptree root;
+  return create(Configuration(input_file), section);
+}
 
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+std::shared_ptr<MemoryKernel>
+MemoryKernelFactory::create(const Configuration &configuration,
+                            const std::string &section) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
 
   // read the type of the kernel
   std::string type = root.get<std::string>(section + ".type");
 
   // set the right pointer, show error if type is unknown
   if (type == "ohmic") {
-    return std::make_shared<OhmicMemoryKernel>(input_file, section);
+    return std::make_shared<OhmicMemoryKernel>(configuration, section);
   } else if (type == "single_phonon"){
-    return std::make_shared<SinglePhononMemoryKernel>(input_file, section);
+    return std::make_shared<SinglePhononMemoryKernel>(configuration, section);
   } else {
     std::cerr << "Error: Unknown Memory Kernel type (" << type << ")!"
               << std::endl;
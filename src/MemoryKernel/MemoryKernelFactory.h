@@ -1,6 +1,7 @@
 #ifndef MEMORYKERNELFACTORY_H
 #define MEMORYKERNELFACTORY_H
 
+#include "../Configuration/Configuration.h"
 #include "MemoryKernel.h"
 #include <memory>
 
@@ -10,6 +11,8 @@ public:
   // Function returning a memory kernel pointer of the right type.
   static std::shared_ptr<MemoryKernel> create(const std::string &input_file,
                                               const std::string &section);
+  static std::shared_ptr<MemoryKernel> create(const Configuration &configuration,
+                                              const std::string &section);
 };
 
 #endif // MEMORYKERNELFACTORY_H
@@ -8,12 +8,13 @@ namespace pt = boost::property_tree;
 OhmicMemoryKernel::OhmicMemoryKernel(double gamma) : gamma(gamma){}
 
 OhmicMemoryKernel::OhmicMemoryKernel(const std::string &input_file,
-                                     const std::string &section) {
-  // Create a root
-  pt::ptree root;
+                                     const std::string &section)
+    : OhmicMemoryKernel(Configuration(input_file), section) {}
 
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+OhmicMemoryKernel::OhmicMemoryKernel(const Configuration &configuration,
+                                     const std::string &section) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
 
   // check if type is right
   std::string type = root.get<std::string>(section + ".type");
@@ -23,12 +24,12 @@ OhmicMemoryKernel::OhmicMemoryKernel(const std::string &input_file,
   this->gamma = root.get<double>(section + ".gamma");
 }
 
-OhmicMemoryKernel::OhmicMemoryKernel(const std::string &input_file) {
-  // Create a root
-  pt::ptree root;
+OhmicMemoryKernel::OhmicMemoryKernel(const std::string &input_file)
+    : OhmicMemoryKernel(Configuration(input_file)) {}
 
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+OhmicMemoryKernel::OhmicMemoryKernel(const Configuration &configuration) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
 
   // check if type is right
   std::string type = root.get<std::string>("MemoryKernel.type");
@@ -1,6 +1,7 @@
 #ifndef OHMICMEMORYKERNEL_H
 #define OHMICMEMORYKERNEL_H
 
+#include "../Configuration/Configuration.h"
 #include "MemoryKernel.h"
 #include <cmath>
 #include <complex>
@@ -14,7 +15,9 @@ public:
   // constructors
   explicit OhmicMemoryKernel(double gamma);
   OhmicMemoryKernel(const std::string &input_file, const std::string &section);
+  OhmicMemoryKernel(const Configuration &configuration, const std::string &section);
   explicit OhmicMemoryKernel(const std::string &input_file);
+  explicit OhmicMemoryKernel(const Configuration &configuration);
 
   // calculate function
   std::complex<double> calculate(double omega) const override;
@@ -22,6 +25,9 @@ public:
   // getter functions
   double get_gamma() const { return this->gamma; };
 
+  // setter functions
+  void set_gamma(double gamma_new) { this->gamma = gamma_new; };
+
   // print info
   void print_info(std::ostream &stream) const override;
 };
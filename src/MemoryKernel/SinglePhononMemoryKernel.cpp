@@ -9,12 +9,13 @@ SinglePhononMemoryKernel::SinglePhononMemoryKernel(double gamma, double gamma_ph
   			: gamma(gamma), gamma_phon(gamma_phon), omega_phon(omega_phon), coupling(coupling){}
 
 SinglePhononMemoryKernel::SinglePhononMemoryKernel(const std::string &input_file,
-                                     const std::string &section) {
-  // Create a root
-  pt::ptree root;
+                                                   const std::string &section)
+    : SinglePhononMemoryKernel(Configuration(input_file), section) {}
 
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+SinglePhononMemoryKernel::SinglePhononMemoryKernel(const Configuration &configuration,
+                                                   const std::string &section) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
 
   // check if type is right
   std::string type = root.get<std::string>(section + ".type");assert(type == "lorentz");
@@ -26,12 +27,12 @@ SinglePhononMemoryKernel::SinglePhononMemoryKernel(const std::string &input_file
   this->coupling = root.get<double>(section + ".coupling");
 }
 
-SinglePhononMemoryKernel::SinglePhononMemoryKernel(const std::string &input_file) {
-  // Create a root
-  pt::ptree root;
+SinglePhononMemoryKernel::SinglePhononMemoryKernel(const std::string &input_file)
+    : SinglePhononMemoryKernel(Configuration(input_file)) {}
 
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+SinglePhononMemoryKernel::SinglePhononMemoryKernel(const Configuration &configuration) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
 
   // check if type is right
   std::string type = root.get<std::string>("MemoryKernel.type");
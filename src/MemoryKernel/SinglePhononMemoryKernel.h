@@ -1,6 +1,7 @@
 #ifndef SINGLEPHONONMEMORYKERNEL_H
 #define SINGLEPHONONMEMORYKERNEL_H
 
+#include "../Configuration/Configuration.h"
 #include "MemoryKernel.h"
 #include <cmath>
 #include <complex>
@@ -19,19 +20,30 @@ public:
 
   // constructor from .json file
   explicit SinglePhononMemoryKernel(const std::string &input_file);
+  explicit SinglePhononMemoryKernel(const Configuration &configuration);
 
   // constructor from .json file of a specific section
   SinglePhononMemoryKernel(const std::string &input_file, const std::string &section);
+  SinglePhononMemoryKernel(const Configuration &configuration, const std::string &section);
 
   // calculate function
   std::complex<double> calculate(double omega) const override;
 
+  // the phonon resonance
+  std::vector<CharacteristicFrequency>
+  characteristic_frequencies() const override {
+    return {{omega_phon, 0.5 * gamma_phon}};
+  };
+
   // getter functions
   double get_gamma() const { return this->gamma; };
   double get_gamma_phon() const { return this->gamma_phon; };
   double get_omega_phon() const { return this->omega_phon; };
   double get_coupling() const { return this->coupling; };
 
+  // setter functions
+  void set_gamma(double gamma_new) { this->gamma = gamma_new; };
+
   // print info
   void print_info(std::ostream &stream) const override;
 };
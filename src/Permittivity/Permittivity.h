@@ -1,7 +1,11 @@
 #ifndef PERMITTIVITY_H
 #define PERMITTIVITY_H
 
+#include <cmath>
 #include <complex>
+#include <vector>
+
+#include "../Calculations/CharacteristicFrequency.h"
 
 //! An abstract permittivity class
 class Permittivity {
@@ -12,6 +16,28 @@ public:
   // calculate the permittivity times omega
   virtual std::complex<double> calculate_times_omega(double omega) const = 0;
 
+  // Frequencies at which the real part of the permittivity without damping
+  // equals epsilon, in ascending order. They are reported as breakpoints of
+  // integrations, by default none are known.
+  virtual std::vector<double> resonances(double epsilon) const { return {}; }
+
+  // Characteristic frequencies of the permittivity itself, e.g. the bulk
+  // resonance, by default none are known
+  virtual std::vector<CharacteristicFrequency>
+  characteristic_frequencies() const {
+    return {};
+  }
+
+  // Half-width of a resonance at omega, where the real part of the
+  // permittivity crosses a constant value. By default it is estimated by the
+  // imaginary part divided by the slope of the real part.
+  virtual double linewidth(double omega) const {
+    double h = 1E-6 * omega;
+    double slope =
+        (calculate(omega + h).real() - calculate(omega - h).real()) / (2 * h);
+    return std::abs(calculate(omega).imag() / slope);
+  }
+
   // print info
   virtual void print_info(std::ostream &stream) const =0;
 };
@@ -9,13 +9,13 @@ PermittivityDrude::PermittivityDrude(double omega_p, double gamma)
     : omega_p(omega_p), gamma(gamma) {}
 
 // constructor for drude model from .json file
-PermittivityDrude::PermittivityDrude(const std::string &input_file) {
+PermittivityDrude::PermittivityDrude(const std::string &input_file)
+    : PermittivityDrude(Configuration(input_file)) {}
 
-  // Create a root
-  pt::ptree root;
+PermittivityDrude::PermittivityDrude(const Configuration &configuration) {
 
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
 
   // check if type is right
   std::string type = root.get<std::string>("Permittivity.type");
@@ -51,6 +51,25 @@ PermittivityDrude::calculate_times_omega(double omega) const {
   return result;
 }
 
+std::vector<double> PermittivityDrude::resonances(double epsilon) const {
+  // 1 - omega_p^2 / omega^2 = epsilon has a positive solution for epsilon < 1
+  if (epsilon < 1) {
+    return {omega_p / std::sqrt(1 - epsilon)};
+  }
+  return {};
+}
+
+double PermittivityDrude::linewidth(double omega) const {
+  // omega (omega + i gamma) = const has the solutions with the imaginary part
+  // -gamma / 2, independent of the constant
+  return 0.5 * gamma;
+}
+
+std::vector<CharacteristicFrequency>
+PermittivityDrude::characteristic_frequencies() const {
+  return {{omega_p, linewidth(omega_p)}};
+}
+
 void PermittivityDrude::print_info(std::ostream &stream) const {
   stream << "# PermittivityDrude\n#\n"
          << "# omega_p = " << omega_p << "\n"
@@ -1,6 +1,7 @@
 #ifndef PERMITTIVITYDRUDE_H
 #define PERMITTIVITYDRUDE_H
 
+#include "../Configuration/Configuration.h"
 #include "Permittivity.h"
 #include <complex>
 
@@ -14,6 +15,7 @@ public:
   // constructors
   PermittivityDrude(double omega_p, double gamma);
   explicit PermittivityDrude(const std::string &input_file);
+  explicit PermittivityDrude(const Configuration &configuration);
 
   // calculate the permittivity
   std::complex<double> calculate(double omega) const override;
@@ -21,6 +23,16 @@ public:
   // Returns the numerical value of the permittivity scaled by omega.
   std::complex<double> calculate_times_omega(double omega) const override;
 
+  // frequencies at which the undamped permittivity equals epsilon
+  std::vector<double> resonances(double epsilon) const override;
+
+  // half-width gamma / 2 of all resonances
+  double linewidth(double omega) const override;
+
+  // the bulk plasmon at omega_p
+  std::vector<CharacteristicFrequency>
+  characteristic_frequencies() const override;
+
   // getter methods
   double get_gamma() const { return this->gamma; };
   double get_omega_p() const { return this->omega_p; };
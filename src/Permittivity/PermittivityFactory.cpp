@@ -12,20 +12,22 @@ namespace pt = boost::property_tree;
 // permittivity factory
 std::shared_ptr<Permittivity>
 PermittivityFactory::create(const std::string &input_file) {
-  // Create a root
-  pt::ptree root;
+  return create(Configuration(input_file));
+}
 
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+std::shared_ptr<Permittivity>
+PermittivityFactory::create(const Configuration &configuration) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
 
   // read the type of permittivity
   std::string type = root.get<std::string>("Permittivity.type");
 
   // set the right pointer, show error if type is unknown
   if (type == "drude") {
-    return std::make_shared<PermittivityDrude>(input_file);
+    return std::make_shared<PermittivityDrude>(configuration);
   } else if (type == "lorentz") {
-    return std::make_shared<PermittivityLorentz>(input_file);
+    return std::make_shared<PermittivityLorentz>(configuration);
   } else {
     std::cerr << "Error: Unknown Permittivity type (" << type << ")!"
               << std::endl;
@@ -2,6 +2,7 @@
 #define PERMITTIVITYFACTORY_H
 
 #include <memory>
+#include "../Configuration/Configuration.h"
 #include "Permittivity.h"
 
 //! A Permittivity factory
@@ -9,6 +10,7 @@ class PermittivityFactory {
 public:
   // Returns a permittivity pointer of the right type.
   static std::shared_ptr<Permittivity> create(const std::string &input_file);
+  static std::shared_ptr<Permittivity> create(const Configuration &configuration);
 };
 
 #endif // PERMITTIVITYFACTORY_H
@@ -14,13 +14,13 @@ PermittivityLorentz::PermittivityLorentz(
       memory_kernel(std::move(memory_kernel)) {}
 
 // constructor for drude model from .json file
-PermittivityLorentz::PermittivityLorentz(const std::string &input_file) {
+PermittivityLorentz::PermittivityLorentz(const std::string &input_file)
+    : PermittivityLorentz(Configuration(input_file)) {}
 
-  // Create a root
-  pt::ptree root;
+PermittivityLorentz::PermittivityLorentz(const Configuration &configuration) {
 
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
 
   // check if type is right
   std::string type = root.get<std::string>("Permittivity.type");
@@ -32,7 +32,7 @@ PermittivityLorentz::PermittivityLorentz(const std::string &input_file) {
   this->omega_0 = root.get<double>("Permittivity.omega_0");
 
   this->memory_kernel =
-      MemoryKernelFactory::create(input_file, "Permittivity.MemoryKernel");
+      MemoryKernelFactory::create(configuration, "Permittivity.MemoryKernel");
 }
 
 // calculate the permittivity
@@ -64,6 +64,37 @@ PermittivityLorentz::calculate_times_omega(double omega) const {
   return result;
 }
 
+std::vector<double> PermittivityLorentz::resonances(double epsilon) const {
+  // eps_inf - omega_p^2 / (omega_0^2 - omega^2) = epsilon is solved for the
+  // squared frequency
+  if (epsilon != eps_inf) {
+    double omega_quad =
+        omega_0 * omega_0 - omega_p * omega_p / (eps_inf - epsilon);
+    if (omega_quad > 0) {
+      return {std::sqrt(omega_quad)};
+    }
+  }
+  return {};
+}
+
+double PermittivityLorentz::linewidth(double omega) const {
+  // for weak damping omega^2 + i omega mu(omega) = const is solved by
+  // frequencies with the imaginary part -Re mu(omega) / 2
+  return 0.5 * std::abs(memory_kernel->calculate(omega).real());
+}
+
+std::vector<CharacteristicFrequency>
+PermittivityLorentz::characteristic_frequencies() const {
+  // the real part of the permittivity diverges at omega_0, hence the width
+  // follows from the damping of the memory kernel
+  std::vector<CharacteristicFrequency> result = {
+      {omega_0, linewidth(omega_0)}};
+  std::vector<CharacteristicFrequency> kernel =
+      memory_kernel->characteristic_frequencies();
+  result.insert(result.end(), kernel.begin(), kernel.end());
+  return result;
+}
+
 void PermittivityLorentz::print_info(std::ostream &stream) const {
   stream << "# PermittivityLorentz\n#\n"
          << "# eps_inf = " << eps_inf << "\n"
@@ -1,6 +1,7 @@
 #ifndef PERMITTIVITYLORENTZ_H
 #define PERMITTIVITYLORENTZ_H
 
+#include "../Configuration/Configuration.h"
 #include "../MemoryKernel/MemoryKernel.h"
 #include "Permittivity.h"
 #include <complex>
@@ -20,6 +21,7 @@ public:
   PermittivityLorentz(double eps_inf, double omega_p, double omega_0,
                       std::shared_ptr<MemoryKernel> memory_kernel);
   explicit PermittivityLorentz(const std::string &input_file);
+  explicit PermittivityLorentz(const Configuration &configuration);
 
   // calculate the permittivity
   std::complex<double> calculate(double omega) const override;
@@ -27,6 +29,16 @@ public:
   // Returns the numerical value of the permittivity scaled by omega.
   std::complex<double> calculate_times_omega(double omega) const override;
 
+  // frequencies at which the undamped permittivity equals epsilon
+  std::vector<double> resonances(double epsilon) const override;
+
+  // half-width of a resonance at omega given by the memory kernel
+  double linewidth(double omega) const override;
+
+  // the resonance at omega_0 and the ones of the memory kernel
+  std::vector<CharacteristicFrequency>
+  characteristic_frequencies() const override;
+
   // getter methods
   double get_eps_inf() const { return this->eps_inf; };
   double get_omega_p() const { return this->omega_p; };
@@ -0,0 +1,172 @@
+#include "EvaluationContext.h"
+
+EvaluationContext::EvaluationContext(double omega, double beta)
+    : omega(omega), beta(beta) {}
+
+EvaluationContext::EvaluationContext(double omega,
+                                     const EvaluationParameters &parameters)
+    : omega(omega), beta(parameters.beta), parameterized(true),
+      parameters(parameters) {}
+
+EvaluationContext::GreensEntry *
+EvaluationContext::find(const GreensTensor &greens_tensor,
+                        const GreensTensorRequest &request) {
+  for (GreensEntry &entry : greens_entries) {
+    if (entry.greens_tensor == &greens_tensor && entry.request == request) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+void EvaluationContext::request(
+    const GreensTensor &greens_tensor,
+    const std::vector<GreensTensorRequest> &requests) {
+  for (const GreensTensorRequest &request : requests) {
+    if (find(greens_tensor, request) == nullptr) {
+      greens_entries.push_back(
+          {&greens_tensor, request, cx_mat::fixed<3, 3>(fill::zeros), false});
+    }
+  }
+}
+
+const cx_mat::fixed<3, 3> &
+EvaluationContext::greens(const GreensTensor &greens_tensor,
+                          Tensor_Options fancy_complex,
+                          Weight_Options weight_function) {
+  GreensTensorRequest request = {fancy_complex, weight_function};
+  this->request(greens_tensor, {request});
+  GreensEntry *entry = find(greens_tensor, request);
+
+  if (!entry->integrated) {
+    // integrate all pending requests of this Green's tensor in the order in
+    // which they have been announced
+    std::vector<GreensEntry *> pending;
+    std::vector<GreensTensorRequest> requests;
+    for (GreensEntry &other : greens_entries) {
+      if (other.greens_tensor == &greens_tensor && !other.integrated) {
+        pending.push_back(&other);
+        requests.push_back(other.request);
+        if (requests.back().beta == 0) {
+          requests.back().beta = beta;
+        }
+      }
+    }
+
+    std::vector<cx_mat::fixed<3, 3>> values;
+    if (parameterized) {
+      greens_tensor.integrate_k(omega, parameters, requests, values);
+    } else {
+      greens_tensor.integrate_k(omega, requests, values);
+    }
+    passes++;
+
+    for (size_t i = 0; i < pending.size(); i++) {
+      pending[i]->value = values[i];
+      pending[i]->integrated = true;
+    }
+  }
+
+  return entry->value;
+}
+
+void EvaluationContext::store(const GreensTensor &greens_tensor,
+                              const GreensTensorIntegral &integral) {
+  this->request(greens_tensor, {integral.request});
+  GreensEntry *entry = find(greens_tensor, integral.request);
+  entry->value = integral.value;
+  entry->integrated = true;
+}
+
+std::vector<GreensTensorIntegral>
+EvaluationContext::integrated(const GreensTensor &greens_tensor) const {
+  std::vector<GreensTensorIntegral> result;
+  for (const GreensEntry &entry : greens_entries) {
+    if (entry.greens_tensor == &greens_tensor && entry.integrated) {
+      result.push_back({entry.request, entry.value});
+    }
+  }
+  return result;
+}
+
+std::vector<GreensTensorRequest>
+EvaluationContext::pending(const GreensTensor &greens_tensor) const {
+  std::vector<GreensTensorRequest> result;
+  for (const GreensEntry &entry : greens_entries) {
+    if (entry.greens_tensor == &greens_tensor && !entry.integrated) {
+      result.push_back(entry.request);
+    }
+  }
+  return result;
+}
+
+void EvaluationContext::integrate_pending(
+    const std::vector<EvaluationContext *> &contexts,
+    const GreensTensor &greens_tensor) {
+  std::vector<bool> grouped(contexts.size(), false);
+  for (size_t j = 0; j < contexts.size(); j++) {
+    if (grouped[j]) {
+      continue;
+    }
+
+    // collect all contexts that share the pending integrals of this one
+    std::vector<GreensTensorRequest> requests =
+        contexts[j]->pending(greens_tensor);
+    std::vector<EvaluationContext *> group;
+    std::vector<double> omegas;
+    for (size_t l = j; l < contexts.size(); l++) {
+      if (!grouped[l] && contexts[l]->beta == contexts[j]->beta &&
+          contexts[l]->parameterized == contexts[j]->parameterized &&
+          (!contexts[j]->parameterized ||
+           contexts[l]->parameters == contexts[j]->parameters) &&
+          contexts[l]->pending(greens_tensor) == requests) {
+        grouped[l] = true;
+        group.push_back(contexts[l]);
+        omegas.push_back(contexts[l]->omega);
+      }
+    }
+    if (requests.empty()) {
+      continue;
+    }
+
+    // the requests without an own temperature are integrated at the one of
+    // the contexts, like in greens
+    std::vector<GreensTensorRequest> integrated = requests;
+    for (GreensTensorRequest &request : integrated) {
+      if (request.beta == 0) {
+        request.beta = contexts[j]->beta;
+      }
+    }
+    std::vector<std::vector<cx_mat::fixed<3, 3>>> values;
+    if (contexts[j]->parameterized) {
+      greens_tensor.integrate_k_batch(omegas, contexts[j]->parameters,
+                                      integrated, values);
+    } else {
+      greens_tensor.integrate_k_batch(omegas, integrated, values);
+    }
+
+    for (size_t l = 0; l < group.size(); l++) {
+      for (size_t i = 0; i < requests.size(); i++) {
+        group[l]->store(greens_tensor, {requests[i], values[l][i]});
+      }
+      group[l]->passes++;
+    }
+  }
+}
+
+const cx_mat::fixed<3, 3> *
+EvaluationContext::find_alpha(const Polarizability &polarizability) const {
+  for (const AlphaEntry &entry : alpha_entries) {
+    if (entry.polarizability == &polarizability) {
+      return &entry.value;
+    }
+  }
+  return nullptr;
+}
+
+const cx_mat::fixed<3, 3> &
+EvaluationContext::store_alpha(const Polarizability &polarizability,
+                               const cx_mat::fixed<3, 3> &alpha) {
+  alpha_entries.push_back({&polarizability, alpha});
+  return alpha_entries.back().value;
+}
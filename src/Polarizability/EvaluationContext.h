@@ -0,0 +1,121 @@
+#ifndef EVALUATIONCONTEXT_H
+#define EVALUATIONCONTEXT_H
+
+#include <armadillo>
+#include <deque>
+#include <vector>
+
+#include "../GreensTensor/GreensTensor.h"
+#include "../GreensTensor/GreensTensorRecord.h"
+
+using namespace arma;
+
+class Polarizability;
+
+//! Memoized quantities of a single frequency
+/*!
+ * An evaluation context stores the integrals of Green's tensors and the
+ * complex polarizabilities at a fixed frequency omega, such that
+ * Polarizability, PowerSpectrum and Friction compute each of them only once
+ * and derive their fancy real and imaginary parts or products from the same
+ * evaluation.
+ * Integrals announced with request are not computed right away. On the first
+ * access of an integral of a Green's tensor, all pending integrals of that
+ * Green's tensor are integrated together in a single pass of integrate_k.
+ * A context with a nonzero inverse temperature beta integrates all requests
+ * without an own temperature at beta, such that the Green's tensors of several
+ * temperatures can be evaluated at the same frequency in separate contexts.
+ * A context with evaluation parameters integrates all Green's tensors with
+ * these parameters instead of their own ones, such that the models are not
+ * changed.
+ * A context is not thread-safe and is meant to live for one frequency only.
+ */
+class EvaluationContext {
+private:
+  // an integral of a Green's tensor
+  struct GreensEntry {
+    const GreensTensor *greens_tensor;
+    GreensTensorRequest request;
+    cx_mat::fixed<3, 3> value;
+    bool integrated;
+  };
+
+  // a complex polarizability tensor
+  struct AlphaEntry {
+    const Polarizability *polarizability;
+    cx_mat::fixed<3, 3> value;
+  };
+
+  double omega; // frequency of all stored quantities
+  double beta;  // inverse temperature, zero for the ones of the Green's tensors
+
+  // parameters of the Green's tensors, if parameterized
+  bool parameterized = false;
+  EvaluationParameters parameters = {NAN, NAN, NAN};
+
+  // a deque keeps the references returned by greens and store_alpha valid
+  std::deque<GreensEntry> greens_entries;
+  std::deque<AlphaEntry> alpha_entries;
+
+  size_t passes = 0; // number of calls of integrate_k
+
+  // returns the entry of the integral or nullptr if it is unknown
+  GreensEntry *find(const GreensTensor &greens_tensor,
+                    const GreensTensorRequest &request);
+
+public:
+  // constructor for the frequency omega and the inverse temperature beta
+  explicit EvaluationContext(double omega, double beta = 0);
+
+  // constructor for the frequency omega, at which all Green's tensors are
+  // integrated with the parameters, including their temperature
+  EvaluationContext(double omega, const EvaluationParameters &parameters);
+
+  // announce integrals of the Green's tensor that will be accessed, requests
+  // that are already known are ignored
+  void request(const GreensTensor &greens_tensor,
+               const std::vector<GreensTensorRequest> &requests);
+
+  // returns the integral of the Green's tensor over k with the given options
+  const cx_mat::fixed<3, 3> &greens(const GreensTensor &greens_tensor,
+                                    Tensor_Options fancy_complex,
+                                    Weight_Options weight_function);
+
+  // store an integral of the Green's tensor that has been computed elsewhere
+  void store(const GreensTensor &greens_tensor,
+             const GreensTensorIntegral &integral);
+
+  // returns all integrals of the Green's tensor computed so far
+  std::vector<GreensTensorIntegral>
+  integrated(const GreensTensor &greens_tensor) const;
+
+  // returns the announced integrals of the Green's tensor that have not been
+  // integrated yet, in the order of their announcement
+  std::vector<GreensTensorRequest>
+  pending(const GreensTensor &greens_tensor) const;
+
+  // integrate the pending integrals of the Green's tensor in all contexts.
+  // Contexts with the same temperature, parameters and pending integrals are
+  // integrated together by a single call of integrate_k_batch.
+  static void integrate_pending(const std::vector<EvaluationContext *> &contexts,
+                                const GreensTensor &greens_tensor);
+
+  // returns the stored complex polarizability or nullptr if there is none
+  const cx_mat::fixed<3, 3> *find_alpha(const Polarizability &polarizability)
+      const;
+
+  // store the complex polarizability and return the stored tensor
+  const cx_mat::fixed<3, 3> &store_alpha(const Polarizability &polarizability,
+                                         const cx_mat::fixed<3, 3> &alpha);
+
+  // getter functions
+  double get_omega() const { return omega; };
+  double get_beta() const { return beta; };
+  size_t get_passes() const { return passes; };
+  // returns the parameters or nullptr if the context has none
+  const EvaluationParameters *get_parameters() const {
+    return parameterized ? &parameters : nullptr;
+  };
+};
+
+#endif // EVALUATIONCONTEXT_H
@@ -1,9 +1,12 @@
 // json parser
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
+#include <algorithm>
 #include <utility>
+#include <vector>
 namespace pt = boost::property_tree;
 
+#include "../Calculations/IntegrationsVector.h"
 #include "../GreensTensor/GreensTensorFactory.h"
 #include "../MemoryKernel/MemoryKernelFactory.h"
 #include "Polarizability.h"
@@ -22,27 +25,27 @@ Polarizability::Polarizability(double omega_a, double alpha_zero,
     : omega_a(omega_a), alpha_zero(alpha_zero), mu(std::move(mu)),
       greens_tensor(std::move(greens_tensor)) {}
 
-Polarizability::Polarizability(const std::string &input_file) {
-  // Create a root
-  pt::ptree root;
+Polarizability::Polarizability(const std::string &input_file)
+    : Polarizability(Configuration(input_file)) {}
 
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+Polarizability::Polarizability(const Configuration &configuration) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
 
   // read parameters
   this->omega_a = root.get<double>("Polarizability.omega_a");
   this->alpha_zero = root.get<double>("Polarizability.alpha_zero");
 
   // read greens tensor
-  this->greens_tensor = GreensTensorFactory::create(input_file);
+  this->greens_tensor = GreensTensorFactory::create(configuration);
 
   // Check if the category Polarizability.MemoryKernel exists
-  boost::optional<pt::ptree &> kernel_given =
+  boost::optional<const pt::ptree &> kernel_given =
       root.get_child_optional("Polarizability.MemoryKernel");
 
   if (kernel_given) {
     this->mu =
-        MemoryKernelFactory::create(input_file, "Polarizability.MemoryKernel");
+        MemoryKernelFactory::create(configuration, "Polarizability.MemoryKernel");
   } else {
     this->mu = nullptr;
   }
@@ -50,6 +53,44 @@ Polarizability::Polarizability(const std::string &input_file) {
 
 void Polarizability::calculate_tensor(double omega, cx_mat::fixed<3, 3> &alpha,
                                       Tensor_Options fancy_complex) const {
+  EvaluationContext context(omega);
+  this->calculate_tensor(context, alpha, fancy_complex);
+}
+
+void Polarizability::calculate_tensor(
+    double omega, cx_mat::fixed<3, 3> &alpha, Tensor_Options fancy_complex,
+    const EvaluationParameters &parameters) const {
+  EvaluationContext context(omega, parameters);
+  this->calculate_tensor(context, alpha, fancy_complex);
+}
+
+void Polarizability::calculate_tensor(EvaluationContext &context,
+                                      cx_mat::fixed<3, 3> &alpha,
+                                      Tensor_Options fancy_complex) const {
+  const cx_mat::fixed<3, 3> *alpha_complex = context.find_alpha(*this);
+  if (alpha_complex == nullptr) {
+    // calculate the integrals over the green's tensor with fancy R and fancy
+    // I in a single pass
+    this->request(context);
+    cx_mat::fixed<3, 3> value;
+    this->calculate_tensor(context.get_omega(), value, COMPLEX,
+                           context.greens(*greens_tensor, RE, UNIT),
+                           context.greens(*greens_tensor, IM, UNIT));
+    alpha_complex = &context.store_alpha(*this, value);
+  }
+
+  alpha = *alpha_complex;
+  project(alpha, fancy_complex);
+}
+
+void Polarizability::request(EvaluationContext &context) const {
+  context.request(*greens_tensor, {{RE, UNIT}, {IM, UNIT}});
+}
+
+void Polarizability::calculate_tensor(
+    double omega, cx_mat::fixed<3, 3> &alpha, Tensor_Options fancy_complex,
+    const cx_mat::fixed<3, 3> &greens_R,
+    const cx_mat::fixed<3, 3> &greens_I) const {
   // imaginary unit
   std::complex<double> I(0.0, 1.0);
 
@@ -62,19 +103,19 @@ void Polarizability::calculate_tensor(double omega, cx_mat::fixed<3, 3> &alpha,
   } else {
     diag(0, 0) = diag(1, 1) = diag(2, 2) = omega_a * omega_a - omega * omega;
   }
-  // calculate integral over green's tensor with fancy R
-  cx_mat::fixed<3, 3> greens_R;
-  this->greens_tensor->integrate_k(omega, greens_R, RE, UNIT);
-
-  // calculate integral over green's tensor with fancy I
-  cx_mat::fixed<3, 3> greens_I;
-  this->greens_tensor->integrate_k(omega, greens_I, IM, UNIT);
-
   // put everything together
   alpha =
       alpha_zero * omega_a * omega_a *
       inv(diag - alpha_zero * omega_a * omega_a * (greens_R + I * greens_I));
 
+  project(alpha, fancy_complex);
+}
+
+void Polarizability::project(cx_mat::fixed<3, 3> &alpha,
+                             Tensor_Options fancy_complex) {
+  // imaginary unit
+  std::complex<double> I(0.0, 1.0);
+
   if (fancy_complex == IM) {
     alpha = (alpha - trans(alpha)) /
             (2.0 * I); // trans is hermitean conjugation in armadillo
@@ -84,6 +125,13 @@ void Polarizability::calculate_tensor(double omega, cx_mat::fixed<3, 3> &alpha,
   }
 }
 
+void Polarizability::calculate_tensor(
+    double omega, cx_mat::fixed<3, 3> &alpha, Tensor_Options fancy_complex,
+    IntegrationDiagnostics &diagnostics) const {
+  IntegrationDiagnosticsScope scope(diagnostics);
+  this->calculate_tensor(omega, alpha, fancy_complex);
+}
+
 double Polarizability::integrand_omega(double omega,
                                        const uvec::fixed<2> &indices,
                                        Tensor_Options fancy_complex) const {
@@ -96,6 +144,39 @@ double Polarizability::integrand_omega(double omega,
   return result;
 }
 
+std::vector<double> Polarizability::omega_breakpoints(double omega_min,
+                                                      double omega_max) const {
+  return omega_breakpoints(omega_min, omega_max,
+                           greens_tensor->get_parameters());
+}
+
+std::vector<double> Polarizability::omega_breakpoints(
+    double omega_min, double omega_max,
+    const EvaluationParameters &parameters) const {
+  // the characteristic frequencies depend on the velocity and the distance
+  std::vector<double> points;
+  append_breakpoints(
+      greens_tensor->has_parameters(parameters)
+          ? greens_tensor->characteristic_frequencies()
+          : greens_tensor->with_parameters(parameters)
+                ->characteristic_frequencies(),
+      omega_min, omega_max, points);
+  if (mu != nullptr) {
+    append_breakpoints(mu->characteristic_frequencies(), omega_min, omega_max,
+                       points);
+  }
+  for (double omega : {0.99 * omega_a, 1.001 * omega_a}) {
+    if (omega > omega_min && omega < omega_max) {
+      points.push_back(omega);
+    }
+  }
+
+  // Sort the points and erase duplicates
+  std::sort(points.begin(), points.end());
+  points.erase(std::unique(points.begin(), points.end()), points.end());
+  return points;
+}
+
 double Polarizability::integrate_omega(const uvec::fixed<2> &indices,
                                        Tensor_Options fancy_complex,
                                        double omega_min, double omega_max,
@@ -103,7 +184,43 @@ double Polarizability::integrate_omega(const uvec::fixed<2> &indices,
   auto F = [=](double x) -> double {
     return this->integrand_omega(x, indices, fancy_complex);
   };
-  return cquad(F, omega_min, omega_max, relerr, abserr);
+
+  // every piece between the breakpoints is integrated with the demanded
+  // relative accuracy, the absolute error is shared equally by the pieces
+  std::vector<double> bounds = omega_breakpoints(omega_min, omega_max);
+  bounds.insert(bounds.begin(), omega_min);
+  bounds.push_back(omega_max);
+  double abserr_piece = abserr / (bounds.size() - 1);
+  double result = 0.;
+  for (size_t i = 0; i + 1 < bounds.size(); i++) {
+    result += cquad(F, bounds[i], bounds[i + 1], relerr, abserr_piece);
+  }
+  return result;
+}
+
+void Polarizability::integrate_omega(cx_mat::fixed<3, 3> &alpha,
+                                     Tensor_Options fancy_complex,
+                                     double omega_min, double omega_max,
+                                     double relerr, double abserr) const {
+  // the real and imaginary parts of all nine elements are integrated jointly
+  auto F = [=](double x, vec &result) -> void {
+    cx_mat::fixed<3, 3> alpha_omega;
+    this->calculate_tensor(x, alpha_omega, fancy_complex);
+    result.head(9) = vectorise(real(alpha_omega));
+    result.tail(9) = vectorise(imag(alpha_omega));
+  };
+  // the absolute error is shared equally by the pieces
+  std::vector<double> bounds = omega_breakpoints(omega_min, omega_max);
+  bounds.insert(bounds.begin(), omega_min);
+  bounds.push_back(omega_max);
+  double abserr_piece = abserr / (bounds.size() - 1);
+  vec elements(18, fill::zeros);
+  for (size_t i = 0; i + 1 < bounds.size(); i++) {
+    elements += qag_vec(F, 18, bounds[i], bounds[i + 1], relerr, abserr_piece);
+  }
+
+  alpha = cx_mat(reshape(elements.head(9), 3, 3),
+                 reshape(elements.tail(9), 3, 3));
 }
 
 void Polarizability::print_info(std::ostream &stream) const {
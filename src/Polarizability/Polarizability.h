@@ -5,9 +5,13 @@
 #include <cmath>
 #include <complex>
 #include <memory>
+#include <utility>
+#include <vector>
 
+#include "../Configuration/Configuration.h"
 #include "../GreensTensor/GreensTensor.h"
 #include "../MemoryKernel/MemoryKernel.h"
+#include "EvaluationContext.h"
 
 using namespace arma;
 
@@ -31,16 +35,67 @@ public:
 
   // Constructor from a given json file
   explicit Polarizability(const std::string &input_file);
+  explicit Polarizability(const Configuration &configuration);
 
   // calculate the polarizability tensor
   void calculate_tensor(double omega, cx_mat::fixed<3, 3> &alpha,
                         Tensor_Options fancy_complex) const;
 
-  // integration over omega
+  // calculate the polarizability tensor with the Green's tensor evaluated at
+  // the given parameters instead of its own ones
+  void calculate_tensor(double omega, cx_mat::fixed<3, 3> &alpha,
+                        Tensor_Options fancy_complex,
+                        const EvaluationParameters &parameters) const;
+
+  // calculate the polarizability tensor at the frequency of the context. The
+  // complex tensor is computed once per context and all fancy parts are
+  // derived from it.
+  void calculate_tensor(EvaluationContext &context, cx_mat::fixed<3, 3> &alpha,
+                        Tensor_Options fancy_complex) const;
+
+  // announce the integrals of the Green's tensor needed by calculate_tensor
+  void request(EvaluationContext &context) const;
+
+  // calculate the polarizability tensor from the given integrals of the
+  // Green's tensor with fancy R and fancy I and unit weight
+  void calculate_tensor(double omega, cx_mat::fixed<3, 3> &alpha,
+                        Tensor_Options fancy_complex,
+                        const cx_mat::fixed<3, 3> &greens_R,
+                        const cx_mat::fixed<3, 3> &greens_I) const;
+
+  // calculate the polarizability tensor and collect the diagnostics of the
+  // involved integrations
+  void calculate_tensor(double omega, cx_mat::fixed<3, 3> &alpha,
+                        Tensor_Options fancy_complex,
+                        IntegrationDiagnostics &diagnostics) const;
+
+  // replace the complex tensor alpha by its fancy real or imaginary part
+  static void project(cx_mat::fixed<3, 3> &alpha, Tensor_Options fancy_complex);
+
+  // Breakpoints of omega integrations strictly between omega_min and
+  // omega_max in ascending order. They enclose the resonance at omega_a and
+  // the characteristic frequencies of the memory kernel and the Green's
+  // tensor.
+  std::vector<double> omega_breakpoints(double omega_min,
+                                        double omega_max) const;
+
+  // the breakpoints with the characteristic frequencies of the Green's tensor
+  // at the given parameters
+  std::vector<double>
+  omega_breakpoints(double omega_min, double omega_max,
+                    const EvaluationParameters &parameters) const;
+
+  // integration over omega, split at the omega_breakpoints
   double integrate_omega(const uvec::fixed<2> &indices,
                          Tensor_Options fancy_complex, double omega_min,
                          double omega_max, double relerr, double abserr) const;
 
+  // integration of the whole polarizability tensor over omega with a shared
+  // subdivision for all elements
+  void integrate_omega(cx_mat::fixed<3, 3> &alpha, Tensor_Options fancy_complex,
+                       double omega_min, double omega_max, double relerr,
+                       double abserr) const;
+
   // integrand for the omega integration
   double integrand_omega(double omega, const uvec::fixed<2> &indices,
                          Tensor_Options fancy_complex) const;
@@ -52,6 +107,18 @@ public:
     return greens_tensor;
   };
 
+  std::shared_ptr<MemoryKernel> get_memory_kernel() const { return mu; };
+
+  // setter functions for the parameters of the particle, which do not change
+  // the Green's tensor
+  void set_omega_a(double omega_a_new) { this->omega_a = omega_a_new; };
+  void set_alpha_zero(double alpha_zero_new) {
+    this->alpha_zero = alpha_zero_new;
+  };
+  void set_memory_kernel(std::shared_ptr<MemoryKernel> mu_new) {
+    this->mu = std::move(mu_new);
+  };
+
   // getter function for memory kernel
   std::complex<double> get_mu(double omega) const {
     if (mu != nullptr) {
@@ -1,21 +1,13 @@
 #include "PowerSpectrum.h"
 #include "../GreensTensor/GreensTensorFactory.h"
 
-// json parser
-#include <boost/property_tree/json_parser.hpp>
-#include <boost/property_tree/ptree.hpp>
-namespace pt = boost::property_tree;
-
 // Constructor using a json-file
-PowerSpectrum::PowerSpectrum(const std::string &input_file) {
-  // Create a root
-  pt::ptree root;
-
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+PowerSpectrum::PowerSpectrum(const std::string &input_file)
+    : PowerSpectrum(Configuration(input_file)) {}
 
+PowerSpectrum::PowerSpectrum(const Configuration &configuration) {
   // initialize polarizability by an input file
-  this->polarizability = std::make_shared<Polarizability>(input_file);
+  this->polarizability = std::make_shared<Polarizability>(configuration);
   // initialize Green's tensor by an input file
   this->greens_tensor = polarizability->get_greens_tensor(); 
 }
@@ -28,26 +20,64 @@ PowerSpectrum::PowerSpectrum(std::shared_ptr<GreensTensor> greens_tensor,
 // Compute the power spectrum for a given frequency \omega
 void PowerSpectrum::calculate(double omega, cx_mat::fixed<3, 3> &powerspectrum,
                               Spectrum_Options spectrum) const {
+  EvaluationContext context(omega);
+  this->calculate(context, powerspectrum, spectrum);
+}
+
+void PowerSpectrum::calculate(double omega, cx_mat::fixed<3, 3> &powerspectrum,
+                              Spectrum_Options spectrum,
+                              const EvaluationParameters &parameters) const {
+  EvaluationContext context(omega, parameters);
+  this->calculate(context, powerspectrum, spectrum);
+}
+
+void PowerSpectrum::calculate(EvaluationContext &context,
+                              cx_mat::fixed<3, 3> &powerspectrum,
+                              Spectrum_Options spectrum) const {
+  // If the polarizability shares the Green's tensor, the Green's tensor with
+  // the non-LTE weight and the ones entering the polarizability are
+  // integrated in a single pass
+  this->request(context);
+
+  // Compute the polarizability
+  cx_mat::fixed<3, 3> alpha;
+  polarizability->calculate_tensor(context, alpha, COMPLEX);
+
+  // a context of its own temperature replaces the one of the Green's tensor
+  double beta = context.get_beta() > 0 ? context.get_beta()
+                                       : greens_tensor->get_beta();
+  this->calculate(context.get_omega(), powerspectrum, spectrum,
+                  context.greens(*greens_tensor, IM, NON_LTE), alpha, beta);
+}
+
+void PowerSpectrum::request(EvaluationContext &context) const {
+  context.request(*greens_tensor, {{IM, NON_LTE}});
+  polarizability->request(context);
+}
+
+void PowerSpectrum::calculate(double omega, cx_mat::fixed<3, 3> &powerspectrum,
+                              Spectrum_Options spectrum,
+                              const cx_mat::fixed<3, 3> &green,
+                              const cx_mat::fixed<3, 3> &alpha) const {
+  this->calculate(omega, powerspectrum, spectrum, green, alpha,
+                  greens_tensor->get_beta());
+}
+
+void PowerSpectrum::calculate(double omega, cx_mat::fixed<3, 3> &powerspectrum,
+                              Spectrum_Options spectrum,
+                              const cx_mat::fixed<3, 3> &green,
+                              const cx_mat::fixed<3, 3> &alpha,
+                              double beta) const {
   // imaginary unit
   std::complex<double> I(0.0, 1.0);
   // Compute the full spectrum
   if (spectrum == FULL) {
-    // Initialize tensor storing the Green's tensor and setting the integration
-    // options for the Green's tensor
-    cx_mat::fixed<3, 3> green(fill::zeros);
-    greens_tensor->integrate_k(omega, green, IM, NON_LTE);
-
-    // Initialize tensor storing the polarizability and seting the integration
-    // options for the polarizability
-    cx_mat::fixed<3, 3> alpha(fill::zeros);
-    polarizability->calculate_tensor(omega, alpha, COMPLEX);
-
     cx_mat::fixed<3, 3> alphaI(fill::zeros);
     alphaI = (alpha - trans(alpha)) / (2. * I);
 
     // First setting the LTE part
     powerspectrum =
-        (alphaI / M_PI) / (1. - exp(-this->greens_tensor->get_beta() * omega));
+        (alphaI / M_PI) / (1. - exp(-beta * omega));
 
     // Adding the NON-LTE part
     powerspectrum += 1. / M_PI * alpha * green * trans(alpha);
@@ -55,19 +85,6 @@ void PowerSpectrum::calculate(double omega, cx_mat::fixed<3, 3> &powerspectrum,
 
   // Compute only the non-LTE contributions to the power spectrum
   if (spectrum == NON_LTE_ONLY) {
-    // Initialize tensor storing the Green's tensor and setting the integration
-    // options for the Green's tensor
-    cx_mat::fixed<3, 3> green(fill::zeros);
-
-    // Compute the Green's tensor
-    this->greens_tensor->integrate_k(omega, green, IM, NON_LTE);
-
-    // Initialize tensor storing the polarizability and seting the integration
-    // options for the polarizability
-    cx_mat::fixed<3, 3> alpha(fill::zeros);
-    // Compute the polarizability
-    this->polarizability->calculate_tensor(omega, alpha, COMPLEX);
-
     // Combine the Green's tensor and the polarizability, see eq. [3.9] in
     // Marty's PhD thesis
     powerspectrum = 1. / M_PI * alpha * green * trans(alpha);
@@ -1,6 +1,7 @@
 #ifndef POWERSPECTRUM_H
 #define POWERSPECTRUM_H
 
+#include "../Configuration/Configuration.h"
 #include "../GreensTensor/GreensTensor.h"
 #include "../Polarizability/Polarizability.h"
 
@@ -20,6 +21,7 @@ protected:
 public:
   // Constructors
   PowerSpectrum(const std::string &input_file);
+  explicit PowerSpectrum(const Configuration &configuration);
 
   // Constructor with initialization list
   PowerSpectrum(std::shared_ptr<GreensTensor> greens_tensor,
@@ -29,6 +31,32 @@ public:
   void calculate(double omega, cx_mat::fixed<3, 3> &powerspectrum,
                  Spectrum_Options spectrum) const;
 
+  // Calculate the power spectrum with the Green's tensor evaluated at the
+  // given parameters instead of its own ones
+  void calculate(double omega, cx_mat::fixed<3, 3> &powerspectrum,
+                 Spectrum_Options spectrum,
+                 const EvaluationParameters &parameters) const;
+
+  // Calculate the power spectrum at the frequency of the context, reusing the
+  // integrals of the Green's tensor and the polarizability stored in it
+  void calculate(EvaluationContext &context, cx_mat::fixed<3, 3> &powerspectrum,
+                 Spectrum_Options spectrum) const;
+
+  // announce the integrals of the Green's tensor needed by calculate
+  void request(EvaluationContext &context) const;
+
+  // Calculate the power spectrum from the given integral of the Green's
+  // tensor with fancy I and non-LTE weight and the complex polarizability
+  void calculate(double omega, cx_mat::fixed<3, 3> &powerspectrum,
+                 Spectrum_Options spectrum, const cx_mat::fixed<3, 3> &green,
+                 const cx_mat::fixed<3, 3> &alpha) const;
+
+  // the same at the inverse temperature beta instead of the one of the
+  // Green's tensor
+  void calculate(double omega, cx_mat::fixed<3, 3> &powerspectrum,
+                 Spectrum_Options spectrum, const cx_mat::fixed<3, 3> &green,
+                 const cx_mat::fixed<3, 3> &alpha, double beta) const;
+
   // getter functions
   std::shared_ptr<GreensTensor> get_greens_tensor() { return greens_tensor; };
   std::shared_ptr<Polarizability> get_polarizability() {
@@ -4,6 +4,9 @@
 #include <armadillo>
 #include <cmath>
 #include <complex>
+#include <vector>
+
+#include "../Calculations/CharacteristicFrequency.h"
 
 // abstract class for reflection coefficients
 class ReflectionCoefficients {
@@ -13,6 +16,18 @@ public:
                          std::complex<double> &r_p,
                          std::complex<double> &r_s) const = 0;
 
+  // Frequencies at which the reflection coefficients are resonant for the
+  // given real kappa, e.g. surface plasmons, in ascending order. They are used
+  // as breakpoints of the integrations, by default none are known.
+  virtual std::vector<double> resonances(double kappa) const { return {}; }
+
+  // Characteristic frequencies of the reflection coefficients at rest, e.g.
+  // the surface plasmon in the quasi-static limit, by default none are known
+  virtual std::vector<CharacteristicFrequency>
+  characteristic_frequencies() const {
+    return {};
+  }
+
   // print info
   virtual void print_info(std::ostream &stream) const =0;
 };
@@ -0,0 +1,146 @@
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+// json parser
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+namespace pt = boost::property_tree;
+
+#include "ReflectionCoefficientsCached.h"
+
+namespace {
+
+// number of independently locked shards of the cache
+const size_t number_of_shards = 16;
+
+} // namespace
+
+bool ReflectionCoefficientsCached::Key::operator==(const Key &other) const {
+  return omega == other.omega && kappa_real == other.kappa_real &&
+         kappa_imag == other.kappa_imag;
+}
+
+size_t ReflectionCoefficientsCached::KeyHash::operator()(const Key &key) const {
+  // combine the bit patterns of the arguments
+  size_t hash = 0;
+  for (double x : {key.omega, key.kappa_real, key.kappa_imag}) {
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    bits ^= bits >> 33;
+    bits *= 0xff51afd7ed558ccdULL;
+    bits ^= bits >> 33;
+    hash ^= bits + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+  }
+  return hash;
+}
+
+// direct constructor
+ReflectionCoefficientsCached::ReflectionCoefficientsCached(
+    std::shared_ptr<ReflectionCoefficients> reflection_coefficients,
+    size_t capacity)
+    : reflection_coefficients(std::move(reflection_coefficients)),
+      capacity(capacity), shards(number_of_shards) {
+  // assertions
+  assert(this->capacity > 0);
+
+  shard_capacity = std::max<size_t>(1, capacity / number_of_shards);
+}
+
+// constructor from .json file
+ReflectionCoefficientsCached::ReflectionCoefficientsCached(
+    std::shared_ptr<ReflectionCoefficients> reflection_coefficients,
+    const std::string &input_file)
+    : ReflectionCoefficientsCached(std::move(reflection_coefficients),
+                                   Configuration(input_file)) {}
+
+ReflectionCoefficientsCached::ReflectionCoefficientsCached(
+    std::shared_ptr<ReflectionCoefficients> reflection_coefficients,
+    const Configuration &configuration)
+    : reflection_coefficients(std::move(reflection_coefficients)),
+      shards(number_of_shards) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
+
+  // read parameters
+  this->capacity =
+      root.get<size_t>("ReflectionCoefficients.cached.capacity", 1000000);
+
+  // assertions
+  assert(this->capacity > 0);
+
+  shard_capacity = std::max<size_t>(1, capacity / number_of_shards);
+}
+
+void ReflectionCoefficientsCached::calculate(double omega,
+                                             std::complex<double> kappa,
+                                             std::complex<double> &r_p,
+                                             std::complex<double> &r_s) const {
+  Key key = {omega, kappa.real(), kappa.imag()};
+  size_t hash = KeyHash()(key);
+  Shard &shard = shards[hash % number_of_shards];
+
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto found = shard.index.find(key);
+    if (found != shard.index.end()) {
+      // move the entry to the front of the list
+      shard.entries.splice(shard.entries.begin(), shard.entries,
+                           found->second);
+      r_p = found->second->second.first;
+      r_s = found->second->second.second;
+      ++hits;
+      return;
+    }
+  }
+
+  // the coefficients are computed without holding the lock
+  reflection_coefficients->calculate(omega, kappa, r_p, r_s);
+  ++misses;
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  // another thread may have inserted the entry in the meantime
+  if (shard.index.count(key) > 0) {
+    return;
+  }
+  shard.entries.emplace_front(key, std::make_pair(r_p, r_s));
+  shard.index[key] = shard.entries.begin();
+
+  // discard the least recently used entry
+  if (shard.entries.size() > shard_capacity) {
+    shard.index.erase(shard.entries.back().first);
+    shard.entries.pop_back();
+  }
+}
+
+void ReflectionCoefficientsCached::clear() {
+  for (Shard &shard : shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.entries.clear();
+    shard.index.clear();
+  }
+  hits = 0;
+  misses = 0;
+}
+
+size_t ReflectionCoefficientsCached::get_size() const {
+  size_t size = 0;
+  for (Shard &shard : shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    size += shard.entries.size();
+  }
+  return size;
+}
+
+double ReflectionCoefficientsCached::get_hit_rate() const {
+  size_t calls = hits + misses;
+  return calls == 0 ? 0. : double(hits) / calls;
+}
+
+void ReflectionCoefficientsCached::print_info(std::ostream &stream) const {
+  stream << "# ReflectionCoefficientsCached\n#\n"
+         << "# capacity = " << capacity << "\n";
+  reflection_coefficients->print_info(stream);
+}
@@ -0,0 +1,113 @@
+#ifndef REFLECTIONCOEFFICIENTSCACHED_H
+#define REFLECTIONCOEFFICIENTSCACHED_H
+
+#include "../Configuration/Configuration.h"
+#include "ReflectionCoefficients.h"
+#include <algorithm>
+#include <atomic>
+#include <complex>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+//! Cached reflection coefficients
+/*!
+ * This is a decorator that memorizes the reflection coefficients of another
+ * ReflectionCoefficients object for the exact arguments (omega, kappa). The
+ * cache holds at most capacity entries and discards the least recently used
+ * ones. It is thread-safe, such that a single instance can be shared by all
+ * threads. For this purpose the cache is split into shards with their own
+ * lock, and the coefficients of a missing entry are computed outside of the
+ * lock.
+ */
+class ReflectionCoefficientsCached : public ReflectionCoefficients {
+private:
+  // exact arguments of the reflection coefficients
+  struct Key {
+    double omega, kappa_real, kappa_imag;
+    bool operator==(const Key &other) const;
+  };
+
+  // hash of the bit patterns of the arguments
+  struct KeyHash {
+    size_t operator()(const Key &key) const;
+  };
+
+  // least recently used cache with its own lock, where the front of the list
+  // is the most recently used entry
+  struct Shard {
+    std::mutex mutex;
+    std::list<std::pair<Key, std::pair<std::complex<double>,
+                                       std::complex<double>>>>
+        entries;
+    std::unordered_map<Key, decltype(entries)::iterator, KeyHash> index;
+  };
+
+  // reflection coefficients that are cached
+  std::shared_ptr<ReflectionCoefficients> reflection_coefficients;
+
+  // maximal number of entries of every shard
+  size_t capacity;
+  size_t shard_capacity;
+
+  // the entries are distributed among the shards by their hash
+  mutable std::vector<Shard> shards;
+
+  // number of calls answered from the cache and of computed coefficients
+  mutable std::atomic<size_t> hits{0};
+  mutable std::atomic<size_t> misses{0};
+
+public:
+  /*!
+   * Constructor for the cached reflection coefficients, which store at most
+   * capacity entries.
+   */
+  ReflectionCoefficientsCached(
+      std::shared_ptr<ReflectionCoefficients> reflection_coefficients,
+      size_t capacity);
+
+  // constructor reading the capacity from the section
+  // ReflectionCoefficients.cached of the given .json file
+  ReflectionCoefficientsCached(
+      std::shared_ptr<ReflectionCoefficients> reflection_coefficients,
+      const std::string &input_file);
+  ReflectionCoefficientsCached(
+      std::shared_ptr<ReflectionCoefficients> reflection_coefficients,
+      const Configuration &configuration);
+
+  /*!
+   * Returns the p- and s-polarized reflection coefficient.
+   */
+  void calculate(double omega, std::complex<double> kappa,
+                 std::complex<double> &r_p,
+                 std::complex<double> &r_s) const override;
+
+  // empties the cache and resets the counters
+  void clear();
+
+  // resonances of the wrapped reflection coefficients
+  std::vector<double> resonances(double kappa) const override {
+    return reflection_coefficients->resonances(kappa);
+  };
+  std::vector<CharacteristicFrequency>
+  characteristic_frequencies() const override {
+    return reflection_coefficients->characteristic_frequencies();
+  };
+
+  // getter functions
+  std::shared_ptr<ReflectionCoefficients> get_reflection_coefficients() const {
+    return reflection_coefficients;
+  };
+  size_t get_capacity() const { return capacity; };
+  size_t get_size() const;
+  size_t get_hits() const { return hits; };
+  size_t get_misses() const { return misses; };
+  double get_hit_rate() const;
+
+  // print info
+  void print_info(std::ostream &stream) const override;
+};
+
+#endif // REFLECTIONCOEFFICIENTSCACHED_H
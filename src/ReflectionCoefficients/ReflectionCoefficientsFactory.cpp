@@ -6,29 +6,56 @@
 namespace pt = boost::property_tree;
 
 #include "ReflectionCoefficientsFactory.h"
+#include "ReflectionCoefficientsCached.h"
 #include "ReflectionCoefficientsLocBulk.h"
 #include "ReflectionCoefficientsLocSlab.h"
+#include "ReflectionCoefficientsTabulated.h"
 
 // reflection coefficients factory
 std::shared_ptr<ReflectionCoefficients>
-ReflectionCoefficientsFactory::create(const std::string& input_file) {
-  // Create a root
-  pt::ptree root;
+ReflectionCoefficientsFactory::create(const std::string &input_file) {
+  return create(Configuration(input_file));
+}
 
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+std::shared_ptr<ReflectionCoefficients>
+ReflectionCoefficientsFactory::create(const Configuration &configuration) {
+  // reflection coefficients that are shared by all models of the
+  // configuration
+  if (configuration.get_reflection_coefficients()) {
+    return configuration.get_reflection_coefficients();
+  }
+
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
 
   // read the type of reflection coefficient
   std::string type = root.get<std::string>("ReflectionCoefficients.type");
 
   // set the right pointer, show error if type is unknown
+  std::shared_ptr<ReflectionCoefficients> reflection_coefficients;
   if (type == "local bulk") {
-    return std::make_shared<ReflectionCoefficientsLocBulk>(input_file);
+    reflection_coefficients =
+        std::make_shared<ReflectionCoefficientsLocBulk>(configuration);
   } else if (type == "local slab") {
-    return std::make_shared<ReflectionCoefficientsLocSlab>(input_file);
+    reflection_coefficients =
+        std::make_shared<ReflectionCoefficientsLocSlab>(configuration);
   } else {
     std::cerr << "Error: Unknown Permittivity type (" << type << ")!"
               << std::endl;
     exit(0);
   }
+
+  // interpolate the reflection coefficients from a table if demanded
+  if (root.get_child_optional("ReflectionCoefficients.tabulated")) {
+    reflection_coefficients = std::make_shared<ReflectionCoefficientsTabulated>(
+        reflection_coefficients, configuration);
+  }
+
+  // memorize the reflection coefficients if demanded
+  if (root.get_child_optional("ReflectionCoefficients.cached")) {
+    reflection_coefficients = std::make_shared<ReflectionCoefficientsCached>(
+        reflection_coefficients, configuration);
+  }
+
+  return reflection_coefficients;
 }
@@ -1,6 +1,7 @@
 #ifndef REFLECTIONCOEFFICIENTSFACTORY_H
 #define REFLECTIONCOEFFICIENTSFACTORY_H
 
+#include "../Configuration/Configuration.h"
 #include "ReflectionCoefficients.h"
 #include <memory>
 
@@ -9,10 +10,14 @@ class ReflectionCoefficientsFactory {
 public:
   /*!
    * Function returning a reflection coefficients pointer of the right type.
+   * The reflection coefficients handed to the configuration are returned
+   * instead, if there are any.
    * @param type Type of the reflection coefficients.
    */
   static std::shared_ptr<ReflectionCoefficients>
   create(const std::string &input_file);
+  static std::shared_ptr<ReflectionCoefficients>
+  create(const Configuration &configuration);
 };
 
 #endif // REFLECTIONCOEFFICIENTSFACTORY_H
@@ -8,9 +8,13 @@ ReflectionCoefficientsLocBulk::ReflectionCoefficientsLocBulk(
 
 // constructor from .json file
 ReflectionCoefficientsLocBulk::ReflectionCoefficientsLocBulk(
-    const std::string &input_file) {
+    const std::string &input_file)
+    : ReflectionCoefficientsLocBulk(Configuration(input_file)) {}
+
+ReflectionCoefficientsLocBulk::ReflectionCoefficientsLocBulk(
+    const Configuration &configuration) {
   // set permittivity
-  this->permittivity = PermittivityFactory::create(input_file);
+  this->permittivity = PermittivityFactory::create(configuration);
 }
 
 // calculate the p-polarized reflection coefficient
@@ -41,6 +45,23 @@ void ReflectionCoefficientsLocBulk::calculate(double omega,
   }
 }
 
+std::vector<double>
+ReflectionCoefficientsLocBulk::resonances(double kappa) const {
+  // In the quasi-static limit r_p has a pole at the surface plasmon, where
+  // the permittivity equals -1
+  return permittivity->resonances(-1.);
+}
+
+std::vector<CharacteristicFrequency>
+ReflectionCoefficientsLocBulk::characteristic_frequencies() const {
+  std::vector<CharacteristicFrequency> result =
+      permittivity->characteristic_frequencies();
+  for (double omega : permittivity->resonances(-1.)) {
+    result.push_back({omega, permittivity->linewidth(omega)});
+  }
+  return result;
+}
+
 void ReflectionCoefficientsLocBulk::print_info(std::ostream &stream) const {
   stream << "# ReflectionCoefficientsLocBulk\n#\n";
   permittivity->print_info(stream);
@@ -1,6 +1,7 @@
 #ifndef REFLECTIONCOEFFICIENTSLOCBULK_H
 #define REFLECTIONCOEFFICIENTSLOCBULK_H
 
+#include "../Configuration/Configuration.h"
 #include "../Permittivity/PermittivityFactory.h"
 #include "ReflectionCoefficients.h"
 #include <armadillo>
@@ -24,6 +25,7 @@ public:
    */
   ReflectionCoefficientsLocBulk(std::shared_ptr<Permittivity> permittivity);
   ReflectionCoefficientsLocBulk(const std::string &input_file);
+  explicit ReflectionCoefficientsLocBulk(const Configuration &configuration);
 
   /*!
    * Returns the p- and s-polarized reflection coefficient.
@@ -32,6 +34,13 @@ public:
                  std::complex<double> &r_p,
                  std::complex<double> &r_s) const override;
 
+  // frequencies of the surface resonances of r_p
+  std::vector<double> resonances(double kappa) const override;
+
+  // the surface plasmon of a half-space and the ones of the permittivity
+  std::vector<CharacteristicFrequency>
+  characteristic_frequencies() const override;
+
   // getter functions
   std::complex<double> get_epsilon(double omega) const {
     return permittivity->calculate(omega);
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <armadillo>
 
 // json parser
@@ -15,15 +16,16 @@ ReflectionCoefficientsLocSlab::ReflectionCoefficientsLocSlab(
 
 // constructor from .json file
 ReflectionCoefficientsLocSlab::ReflectionCoefficientsLocSlab(
-    const std::string &input_file) {
+    const std::string &input_file)
+    : ReflectionCoefficientsLocSlab(Configuration(input_file)) {}
+
+ReflectionCoefficientsLocSlab::ReflectionCoefficientsLocSlab(
+    const Configuration &configuration) {
   // set permittivity
   // set parameters
-  this->permittivity = PermittivityFactory::create(input_file);
-  // Create a root
-  pt::ptree root;
-
-  // Load the json file in this ptree
-  pt::read_json(input_file, root);
+  this->permittivity = PermittivityFactory::create(configuration);
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
 
   // read parameters
   this->thickness = root.get<double>("ReflectionCoefficients.thickness");
@@ -65,6 +67,39 @@ void ReflectionCoefficientsLocSlab::calculate(double omega,
     r_s = conj(r_s);
   }
 }
+std::vector<double>
+ReflectionCoefficientsLocSlab::resonances(double kappa) const {
+  // In the quasi-static limit the surface plasmons of both interfaces
+  // hybridize to a symmetric and an antisymmetric mode, where the
+  // permittivity equals -(1 + x) / (1 - x) and -(1 - x) / (1 + x) with
+  // x = exp(-kappa d)
+  double x = std::exp(-kappa * thickness);
+  std::vector<double> result = permittivity->resonances(-(1 - x) / (1 + x));
+  if (x < 1) {
+    std::vector<double> symmetric =
+        permittivity->resonances(-(1 + x) / (1 - x));
+    result.insert(result.end(), symmetric.begin(), symmetric.end());
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+std::vector<CharacteristicFrequency>
+ReflectionCoefficientsLocSlab::characteristic_frequencies() const {
+  std::vector<CharacteristicFrequency> result =
+      permittivity->characteristic_frequencies();
+  // the hybridized modes at kappa = 1 / thickness, where they are split the
+  // most within the wavevectors relevant to the slab, followed by the surface
+  // plasmon, to which both tend for kappa d >> 1
+  std::vector<double> modes = resonances(1. / thickness);
+  std::vector<double> surface = permittivity->resonances(-1.);
+  modes.insert(modes.end(), surface.begin(), surface.end());
+  for (double omega : modes) {
+    result.push_back({omega, permittivity->linewidth(omega)});
+  }
+  return result;
+}
+
 void ReflectionCoefficientsLocSlab::print_info(std::ostream &stream) const {
   stream << "# ReflectionCoefficientsLocSlab\n#\n"
          << "# thickness = " << thickness << "\n";
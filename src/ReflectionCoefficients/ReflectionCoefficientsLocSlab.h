@@ -1,6 +1,7 @@
 #ifndef REFLECTIONCOEFFICIENTSLOCSLAB_H
 #define REFLECTIONCOEFFICIENTSLOCSLAB_H
 
+#include "../Configuration/Configuration.h"
 #include "../Permittivity/PermittivityFactory.h"
 #include "ReflectionCoefficients.h"
 #include <armadillo>
@@ -27,6 +28,7 @@ public:
                                 double thickness);
 
   ReflectionCoefficientsLocSlab(const std::string &input_file);
+  explicit ReflectionCoefficientsLocSlab(const Configuration &configuration);
 
   /*!
    * Returns the p- and s-polarized reflection coefficient.
@@ -35,6 +37,15 @@ public:
                  std::complex<double> &r_p,
                  std::complex<double> &r_s) const override;
 
+  // frequencies of the surface resonances of r_p
+  std::vector<double> resonances(double kappa) const override;
+
+  // the characteristic frequencies of the permittivity, the hybridized modes
+  // at kappa = 1 / thickness and the surface plasmon, to which both modes
+  // tend for kappa d >> 1
+  std::vector<CharacteristicFrequency>
+  characteristic_frequencies() const override;
+
   // getter functions
   std::complex<double> get_epsilon(double omega) const {
     return permittivity->calculate(omega);
@@ -0,0 +1,315 @@
+#include <iostream>
+#include <utility>
+
+// json parser
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+namespace pt = boost::property_tree;
+
+#include "ReflectionCoefficientsTabulated.h"
+
+namespace {
+
+// number of interpolation points per axis of a cell
+const uword points = 6;
+
+// number of bisections of the rectangle before the accuracy is checked,
+// alternating between the axes, which yields a uniform grid of 8 x 8 cells
+const uword forced_depth = 6;
+
+// maximal depth of the bisection and maximal number of leaves per table
+const uword max_depth = 60;
+const size_t max_leaves = 100000;
+
+// Chebyshev points of the first kind on [-1, 1], their barycentric weights,
+// the values of the highest Chebyshev polynomial at the points and the points
+// at which the interpolation is checked. These are the boundaries and the
+// points in between the interpolation points. The interpolation points do not
+// include the boundaries of a cell, such that the table itself never needs
+// the coefficients at omega = 0.
+struct Chebyshev {
+  double nodes[points], weights[points], highest[points], checks[points + 1];
+
+  Chebyshev() {
+    for (uword i = 0; i < points; i++) {
+      double theta = M_PI * (2 * i + 1) / (2 * points);
+      nodes[i] = std::cos(theta);
+      weights[i] = ((i % 2 == 0) ? 1. : -1.) * std::sin(theta);
+      highest[i] = std::cos((points - 1) * theta);
+    }
+    for (uword i = 0; i <= points; i++) {
+      checks[i] = std::cos(M_PI * i / points);
+    }
+  }
+};
+const Chebyshev chebyshev;
+
+// barycentric factors of the interpolation at u in [-1, 1]
+void barycentric_factors(double u, double *factors) {
+  for (uword i = 0; i < points; i++) {
+    if (u == chebyshev.nodes[i]) {
+      // the point coincides with a node
+      for (uword j = 0; j < points; j++) {
+        factors[j] = (i == j) ? 1. : 0.;
+      }
+      return;
+    }
+  }
+  double sum = 0;
+  for (uword i = 0; i < points; i++) {
+    factors[i] = chebyshev.weights[i] / (u - chebyshev.nodes[i]);
+    sum += factors[i];
+  }
+  for (uword i = 0; i < points; i++) {
+    factors[i] /= sum;
+  }
+}
+
+// Interpolates r_p and r_s at (u, v) in [-1, 1]^2 from their values at the
+// Chebyshev points. The values of r_p at the point (u_i, v_j) are stored at
+// i * points + j, the ones of r_s follow after all values of r_p.
+void interpolate_cell(const std::complex<double> *values, double u, double v,
+                      std::complex<double> &r_p, std::complex<double> &r_s) {
+  double a[points], b[points];
+  barycentric_factors(u, a);
+  barycentric_factors(v, b);
+
+  r_p = 0;
+  r_s = 0;
+  for (uword i = 0; i < points; i++) {
+    std::complex<double> row_p = 0, row_s = 0;
+    for (uword j = 0; j < points; j++) {
+      row_p += b[j] * values[i * points + j];
+      row_s += b[j] * values[points * points + i * points + j];
+    }
+    r_p += a[i] * row_p;
+    r_s += a[i] * row_s;
+  }
+}
+
+} // namespace
+
+// direct constructor
+ReflectionCoefficientsTabulated::ReflectionCoefficientsTabulated(
+    std::shared_ptr<ReflectionCoefficients> reflection_coefficients,
+    double omega_min, double omega_max, double kappa_max, double accuracy)
+    : reflection_coefficients(std::move(reflection_coefficients)),
+      omega_min(omega_min), omega_max(omega_max), kappa_max(kappa_max),
+      accuracy(accuracy) {
+  build_tables();
+}
+
+// constructor from .json file
+ReflectionCoefficientsTabulated::ReflectionCoefficientsTabulated(
+    std::shared_ptr<ReflectionCoefficients> reflection_coefficients,
+    const std::string &input_file)
+    : ReflectionCoefficientsTabulated(std::move(reflection_coefficients),
+                                      Configuration(input_file)) {}
+
+ReflectionCoefficientsTabulated::ReflectionCoefficientsTabulated(
+    std::shared_ptr<ReflectionCoefficients> reflection_coefficients,
+    const Configuration &configuration)
+    : reflection_coefficients(std::move(reflection_coefficients)) {
+  // the parsed input file
+  const pt::ptree &root = configuration.get_root();
+
+  // read parameters
+  this->omega_min =
+      root.get<double>("ReflectionCoefficients.tabulated.omega_min", 0.);
+  this->omega_max =
+      root.get<double>("ReflectionCoefficients.tabulated.omega_max");
+  this->kappa_max =
+      root.get<double>("ReflectionCoefficients.tabulated.kappa_max");
+  this->accuracy =
+      root.get<double>("ReflectionCoefficients.tabulated.accuracy", 1E-8);
+
+  build_tables();
+}
+
+void ReflectionCoefficientsTabulated::build_tables() {
+  // assertions
+  assert(omega_min >= 0 && omega_max > omega_min);
+  assert(kappa_max > 0 && accuracy > 0);
+
+  // evanescent waves with real kappa
+  build(evanescent, omega_min, omega_max, 0, kappa_max,
+        [this](double omega, double kappa, std::complex<double> &r_p,
+               std::complex<double> &r_s) -> void {
+          reflection_coefficients->calculate(
+              omega, std::complex<double>(kappa, 0), r_p, r_s);
+        });
+
+  // propagating waves with kappa = -i t omega
+  build(propagating, omega_min, omega_max, 0, 1,
+        [this](double omega, double t, std::complex<double> &r_p,
+               std::complex<double> &r_s) -> void {
+          reflection_coefficients->calculate(
+              omega, std::complex<double>(0, -t * omega), r_p, r_s);
+        });
+}
+
+void ReflectionCoefficientsTabulated::build(
+    Table &table, double x_min, double x_max, double y_min, double y_max,
+    const std::function<void(double, double, std::complex<double> &,
+                             std::complex<double> &)> &f) {
+  table.cells.clear();
+  table.values.clear();
+  table.cells.push_back({x_min, x_max, y_min, y_max, -1, 0, 0});
+  size_t table_leaves = 0;
+
+  // values of r_p and r_s at the interpolation points of the current cell
+  std::vector<std::complex<double>> values(2 * points * points);
+
+  std::function<void(size_t, uword)> refine = [&](size_t c,
+                                                  uword depth) -> void {
+    // copy, since the cells may be reallocated by the children
+    Table::Cell cell = table.cells[c];
+    double x_center = 0.5 * (cell.x_min + cell.x_max);
+    double x_half = 0.5 * (cell.x_max - cell.x_min);
+    double y_center = 0.5 * (cell.y_min + cell.y_max);
+    double y_half = 0.5 * (cell.y_max - cell.y_min);
+
+    // bisect the cell at its center along the given axis
+    auto bisect = [&](uword axis) -> void {
+      Table::Cell first = cell, second = cell;
+      if (axis == 0) {
+        first.x_max = second.x_min = x_center;
+      } else {
+        first.y_max = second.y_min = y_center;
+      }
+      long child = table.cells.size();
+      table.cells[c].child = child;
+      table.cells[c].axis = axis;
+      table.cells.push_back(first);
+      table.cells.push_back(second);
+      refine(child, depth + 1);
+      refine(child + 1, depth + 1);
+    };
+
+    // the uniform refinement alternates between the axes
+    if (depth < forced_depth) {
+      bisect(depth % 2);
+      return;
+    }
+
+    for (uword i = 0; i < points; i++) {
+      for (uword j = 0; j < points; j++) {
+        f(x_center + x_half * chebyshev.nodes[i],
+          y_center + y_half * chebyshev.nodes[j], values[i * points + j],
+          values[points * points + i * points + j]);
+      }
+    }
+    evaluations += points * points;
+
+    // The interpolation is compared to the exact coefficients on the
+    // boundaries and between the interpolation points, where its error is
+    // largest. The boundary at omega = 0 is left out.
+    double error = 0;
+    for (uword i = 0; i <= points; i++) {
+      double x = x_center + x_half * chebyshev.checks[i];
+      if (x == 0) {
+        continue;
+      }
+      for (uword j = 0; j <= points; j++) {
+        double v = chebyshev.checks[j];
+        std::complex<double> r_p, r_s, r_p_exact, r_s_exact;
+        interpolate_cell(values.data(), chebyshev.checks[i], v, r_p, r_s);
+        f(x, y_center + y_half * v, r_p_exact, r_s_exact);
+        error = std::max(error, std::abs(r_p - r_p_exact) /
+                                    std::max(std::abs(r_p_exact), 1.));
+        error = std::max(error, std::abs(r_s - r_s_exact) /
+                                    std::max(std::abs(r_s_exact), 1.));
+        ++evaluations;
+      }
+    }
+
+    // The cell is bisected along the axis with the larger highest Chebyshev
+    // coefficient, in which the coefficients vary most.
+    double tail[2] = {0, 0};
+    for (uword r = 0; r < 2; r++) {
+      const std::complex<double> *f_r = values.data() + r * points * points;
+      for (uword k = 0; k < points; k++) {
+        std::complex<double> sum_x = 0, sum_y = 0;
+        for (uword l = 0; l < points; l++) {
+          sum_x += chebyshev.highest[l] * f_r[l * points + k];
+          sum_y += chebyshev.highest[l] * f_r[k * points + l];
+        }
+        tail[0] = std::max(tail[0], std::abs(sum_x));
+        tail[1] = std::max(tail[1], std::abs(sum_y));
+      }
+    }
+    uword axis = tail[1] > tail[0] ? 1 : 0;
+
+    // stop if the cell can not be bisected any further
+    double lower = axis == 0 ? cell.x_min : cell.y_min;
+    double upper = axis == 0 ? cell.x_max : cell.y_max;
+    double mid = 0.5 * (lower + upper);
+    bool divisible = lower < mid && mid < upper;
+
+    if (error <= accuracy || depth >= max_depth ||
+        table_leaves >= max_leaves || !divisible) {
+      table.cells[c].offset = table.values.size();
+      table.values.insert(table.values.end(), values.begin(), values.end());
+      ++table_leaves;
+      return;
+    }
+    bisect(axis);
+  };
+
+  refine(0, 0);
+  leaves += table_leaves;
+}
+
+void ReflectionCoefficientsTabulated::Table::interpolate(
+    double x, double y, std::complex<double> &r_p,
+    std::complex<double> &r_s) const {
+  // descend to the leaf containing the point
+  const Cell *cell = &cells[0];
+  while (cell->child >= 0) {
+    double mid = cell->axis == 0 ? 0.5 * (cell->x_min + cell->x_max)
+                                 : 0.5 * (cell->y_min + cell->y_max);
+    double coordinate = cell->axis == 0 ? x : y;
+    cell = &cells[cell->child + (coordinate >= mid ? 1 : 0)];
+  }
+
+  double u = (2 * x - (cell->x_min + cell->x_max)) / (cell->x_max - cell->x_min);
+  double v = (2 * y - (cell->y_min + cell->y_max)) / (cell->y_max - cell->y_min);
+  interpolate_cell(values.data() + cell->offset, u, v, r_p, r_s);
+}
+
+void ReflectionCoefficientsTabulated::calculate(
+    double omega, std::complex<double> kappa, std::complex<double> &r_p,
+    std::complex<double> &r_s) const {
+  // absolute value of omega. The coefficients are tabulated for positive omega
+  // and if needed complex conjugated after the interpolation
+  double omega_abs = std::abs(omega);
+
+  if (omega_abs >= omega_min && omega_abs <= omega_max &&
+      kappa.imag() == 0 && kappa.real() >= 0 && kappa.real() <= kappa_max) {
+    evanescent.interpolate(omega_abs, kappa.real(), r_p, r_s);
+  } else if (omega_abs >= omega_min && omega_abs <= omega_max &&
+             kappa.real() == 0 && kappa.imag() < 0 &&
+             -kappa.imag() <= omega_abs) {
+    propagating.interpolate(omega_abs, -kappa.imag() / omega_abs, r_p, r_s);
+  } else {
+    // outside of the table the coefficients are computed exactly
+    reflection_coefficients->calculate(omega, kappa, r_p, r_s);
+    return;
+  }
+
+  // Imposing crossing relation
+  if (omega < 0.) {
+    r_p = conj(r_p);
+    r_s = conj(r_s);
+  }
+}
+
+void ReflectionCoefficientsTabulated::print_info(std::ostream &stream) const {
+  stream << "# ReflectionCoefficientsTabulated\n#\n"
+         << "# omega_min = " << omega_min << "\n"
+         << "# omega_max = " << omega_max << "\n"
+         << "# kappa_max = " << kappa_max << "\n"
+         << "# accuracy = " << accuracy << "\n"
+         << "# leaves = " << leaves << "\n";
+  reflection_coefficients->print_info(stream);
+}
@@ -0,0 +1,126 @@
+#ifndef REFLECTIONCOEFFICIENTSTABULATED_H
+#define REFLECTIONCOEFFICIENTSTABULATED_H
+
+#include "../Configuration/Configuration.h"
+#include "ReflectionCoefficients.h"
+#include <armadillo>
+#include <complex>
+#include <functional>
+#include <memory>
+#include <vector>
+using namespace arma;
+
+//! Tabulated reflection coefficients
+/*!
+ * This is a decorator that interpolates the reflection coefficients of another
+ * ReflectionCoefficients object from a precomputed table. The table covers the
+ * frequencies omega_min <= |omega| <= omega_max, the evanescent waves with
+ * real 0 <= kappa <= kappa_max and the propagating waves with imaginary
+ * kappa = -i t |omega|, 0 <= t <= 1. Both regions are bisected adaptively,
+ * starting with a coarse uniform grid, until the interpolation on every cell
+ * reaches the demanded accuracy. Hence the cells get small near the plasmon
+ * resonances and the light line kappa = 0, which separates the two regions.
+ * The accuracy is measured as the deviation from the exact coefficient
+ * relative to max(|r|, 1). Outside of the table the coefficients are computed
+ * exactly.
+ */
+class ReflectionCoefficientsTabulated : public ReflectionCoefficients {
+private:
+  //! An adaptively bisected table over a rectangle in (x, y)
+  /*!
+   * Every leaf interpolates the coefficients from their values at the
+   * Chebyshev points of the cell with the barycentric formula.
+   */
+  struct Table {
+    // Cell of the table, the children of an inner cell are stored next to
+    // each other starting at child and split the cell at its center along axis
+    struct Cell {
+      double x_min, x_max, y_min, y_max;
+      long child;    // index of the first child, -1 for leaves
+      uword axis;    // axis of the bisection, 0 for x and 1 for y
+      size_t offset; // position of the values of a leaf
+    };
+
+    std::vector<Cell> cells;
+    // values of r_p and r_s at the interpolation points of all leaves
+    std::vector<std::complex<double>> values;
+
+    // interpolate r_p and r_s at (x, y) inside of the rectangle
+    void interpolate(double x, double y, std::complex<double> &r_p,
+                     std::complex<double> &r_s) const;
+  };
+
+  // reflection coefficients that are tabulated
+  std::shared_ptr<ReflectionCoefficients> reflection_coefficients;
+
+  // range of the table and demanded accuracy
+  double omega_min, omega_max, kappa_max, accuracy;
+
+  // table of the evanescent waves over (|omega|, kappa) and of the propagating
+  // waves over (|omega|, t) with kappa = -i t |omega|
+  Table evanescent, propagating;
+
+  // number of leaves and of evaluations of the tabulated coefficients
+  size_t leaves = 0;
+  size_t evaluations = 0;
+
+  // fill the table by adaptive bisection of the rectangle, where f computes
+  // the tabulated coefficients at (x, y)
+  void build(Table &table, double x_min, double x_max, double y_min,
+             double y_max,
+             const std::function<void(double, double, std::complex<double> &,
+                                      std::complex<double> &)> &f);
+
+  // builds the tables of the evanescent and the propagating waves
+  void build_tables();
+
+public:
+  /*!
+   * Constructor for the tabulated reflection coefficients, the table is
+   * computed at construction.
+   */
+  ReflectionCoefficientsTabulated(
+      std::shared_ptr<ReflectionCoefficients> reflection_coefficients,
+      double omega_min, double omega_max, double kappa_max, double accuracy);
+
+  // constructor reading the range and accuracy of the table from the section
+  // ReflectionCoefficients.tabulated of the given .json file
+  ReflectionCoefficientsTabulated(
+      std::shared_ptr<ReflectionCoefficients> reflection_coefficients,
+      const std::string &input_file);
+  ReflectionCoefficientsTabulated(
+      std::shared_ptr<ReflectionCoefficients> reflection_coefficients,
+      const Configuration &configuration);
+
+  /*!
+   * Returns the p- and s-polarized reflection coefficient.
+   */
+  void calculate(double omega, std::complex<double> kappa,
+                 std::complex<double> &r_p,
+                 std::complex<double> &r_s) const override;
+
+  // resonances of the wrapped reflection coefficients
+  std::vector<double> resonances(double kappa) const override {
+    return reflection_coefficients->resonances(kappa);
+  };
+  std::vector<CharacteristicFrequency>
+  characteristic_frequencies() const override {
+    return reflection_coefficients->characteristic_frequencies();
+  };
+
+  // getter functions
+  std::shared_ptr<ReflectionCoefficients> get_reflection_coefficients() const {
+    return reflection_coefficients;
+  };
+  double get_omega_min() const { return omega_min; };
+  double get_omega_max() const { return omega_max; };
+  double get_kappa_max() const { return kappa_max; };
+  double get_accuracy() const { return accuracy; };
+  size_t get_leaves() const { return leaves; };
+  size_t get_evaluations() const { return evaluations; };
+
+  // print info
+  void print_info(std::ostream &stream) const override;
+};
+
+#endif // REFLECTIONCOEFFICIENTSTABULATED_H
@@ -0,0 +1,55 @@
+#include "Quaca.h"
+#include "catch.hpp"
+#include <cmath>
+#include <functional>
+
+TEST_CASE("Overhead of the integrand dispatch", "[Integrations]") {
+  // a cheap integrand, such that the cost of calling it dominates
+  auto f = [](double x) -> double { return 1. / (x * x + 1.0); };
+  std::function<double(double)> f_std = f;
+
+  // the gsl_functions as they are handed to the gsl by the wrappers
+  gsl_function_pp<std::function<double(double)>> Fp_std(f_std);
+  gsl_function_pp<decltype(f)> Fp_tpl(f);
+  auto *F_std = static_cast<gsl_function *>(&Fp_std);
+  auto *F_tpl = static_cast<gsl_function *>(&Fp_tpl);
+
+  // number of integrand evaluations per benchmark run
+  const int n = 1000;
+
+  BENCHMARK("1000 evaluations through std::function") {
+    double sum = 0;
+    for (int i = 0; i < n; i++) {
+      sum += GSL_FN_EVAL(F_std, i * 1E-3);
+    }
+    return sum;
+  };
+
+  BENCHMARK("1000 evaluations through a templated callable") {
+    double sum = 0;
+    for (int i = 0; i < n; i++) {
+      sum += GSL_FN_EVAL(F_tpl, i * 1E-3);
+    }
+    return sum;
+  };
+
+  BENCHMARK("Nested cquad with std::function") {
+    std::function<double(double)> outer = [&](double y) -> double {
+      std::function<double(double)> inner = [=](double x) -> double {
+        return 1. / (x * x + y * y + 1.0);
+      };
+      return cquad(inner, 0, 1, 1E-10, 0);
+    };
+    return cquad(outer, 0, 1, 1E-10, 0);
+  };
+
+  BENCHMARK("Nested cquad with templated callables") {
+    auto outer = [&](double y) -> double {
+      auto inner = [=](double x) -> double {
+        return 1. / (x * x + y * y + 1.0);
+      };
+      return cquad(inner, 0, 1, 1E-10, 0);
+    };
+    return cquad(outer, 0, 1, 1E-10, 0);
+  };
+}
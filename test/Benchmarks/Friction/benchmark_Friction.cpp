@@ -0,0 +1,50 @@
+#include "Quaca.h"
+#include "catch.hpp"
+#include <omp.h>
+
+TEST_CASE("Quadratures of the friction omega tail", "[Friction]") {
+  Friction quant_fric("../data/test_files/FrictionVacuum.json");
+
+  // the omega tail as integrated at the end of Friction::calculate
+  double omega_min = std::max(
+      1.001 * quant_fric.get_polarizability()->get_omega_a(),
+      quant_fric.get_greens_tensor()->omega_ch());
+  auto F = [&](double x) -> double {
+    return quant_fric.friction_integrand(x, NON_LTE_ONLY);
+  };
+
+  BENCHMARK("qagiu on the friction omega tail") {
+    return qagiu(F, omega_min, 1E-6, 0);
+  };
+
+  BENCHMARK("exp_sinh on the friction omega tail") {
+    return exp_sinh(F, omega_min, 1E-6, 0);
+  };
+
+  // the same comparison for a smooth model tail
+  auto G = [](double x) -> double { return x * x * exp(-x) / (1. + x); };
+
+  BENCHMARK("qagiu on a model tail") { return qagiu(G, 1., 1E-10, 0); };
+
+  BENCHMARK("exp_sinh on a model tail") { return exp_sinh(G, 1., 1E-10, 0); };
+}
+
+TEST_CASE("Task-parallel friction on one and all threads", "[Friction]") {
+  Friction quant_fric("../data/test_files/FrictionVacuum.json");
+  quant_fric.set_task_parallel(true);
+  int max_threads = omp_get_max_threads();
+
+  // The pieces of the omega integration are the only tasks, hence the
+  // speed-up is bounded by the share of the most expensive piece, the one
+  // around the resonance of the polarizability.
+  omp_set_num_threads(1);
+  BENCHMARK("task-parallel friction on 1 thread") {
+    return quant_fric.calculate(NON_LTE_ONLY);
+  };
+
+  omp_set_num_threads(omp_get_num_procs());
+  BENCHMARK("task-parallel friction on all threads") {
+    return quant_fric.calculate(NON_LTE_ONLY);
+  };
+  omp_set_num_threads(max_threads);
+}
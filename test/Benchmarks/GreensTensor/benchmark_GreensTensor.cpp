@@ -0,0 +1,85 @@
+#include "Quaca.h"
+#include "catch.hpp"
+#include <string>
+#include <type_traits>
+
+// Integrates the xx, yy, zz and zx element of the plate Green's tensor one
+// after another with cquad over the whole phi domain, as done before the phi
+// domain was split into pieces
+double integrate_k_cquad(const GreensTensorPlate &greens_tensor, double omega,
+                         Tensor_Options fancy_complex,
+                         Weight_Options weight_function) {
+  double sum = 0;
+  std::vector<uvec::fixed<2>> indices = {{0, 0}, {1, 1}, {2, 2}, {2, 0}};
+  for (auto &index : indices) {
+    auto F = [&](double phi) -> double {
+      return greens_tensor.integrand_1d_k(phi, omega, index, fancy_complex,
+                                          weight_function);
+    };
+    sum += cquad(F, 0, M_PI, greens_tensor.get_rel_err_1(), 0) / M_PI;
+  }
+  return sum;
+}
+
+// Integrates the xx and yy element of the vacuum Green's tensor one after
+// another with cquad
+double integrate_k_cquad(const GreensTensorVacuum &greens_tensor, double omega,
+                         Tensor_Options fancy_complex,
+                         Weight_Options weight_function) {
+  double v = greens_tensor.get_v();
+  double sum = 0;
+  std::vector<uvec::fixed<2>> indices = {{0, 0}, {1, 1}};
+  for (auto &index : indices) {
+    auto F = [&](double kv) -> double {
+      return greens_tensor.integrand_k(kv, omega, index, fancy_complex,
+                                       weight_function);
+    };
+    sum += cquad(F, -omega / (1.0 + v), omega / (1.0 - v),
+                 greens_tensor.get_relerr(), 0);
+  }
+  return sum;
+}
+
+TEMPLATE_TEST_CASE_SIG("Integrators of the k integration on the test configs",
+                       "[GreensTensor]", ((typename T, int config), T, config),
+                       (GreensTensorPlate, 0), (GreensTensorPlate, 1),
+                       (GreensTensorVacuum, 2)) {
+  std::vector<std::string> files = {
+      "../data/test_files/GreensTensorPlate.json",
+      "../data/test_files/GreensTensorSlab.json",
+      "../data/test_files/GreensTensorVacuum.json"};
+  T greens_tensor(files[config]);
+
+  double omega = 0.54;
+  cx_mat::fixed<3, 3> GT;
+
+  BENCHMARK("cquad for every element (" + files[config] + ")") {
+    return integrate_k_cquad(greens_tensor, omega, IM, KV_TEMP);
+  };
+
+  greens_tensor.set_integrator(POINTWISE);
+  BENCHMARK("cquad for every element on the pieces (" + files[config] + ")") {
+    greens_tensor.integrate_k(omega, GT, IM, KV_TEMP);
+    return GT(0, 0);
+  };
+
+  greens_tensor.set_integrator(VECTOR);
+  BENCHMARK("qag_vec with pointwise integrand (" + files[config] + ")") {
+    greens_tensor.integrate_k(omega, GT, IM, KV_TEMP);
+    return GT(0, 0);
+  };
+
+  greens_tensor.set_integrator(BATCH);
+  BENCHMARK("qag_batch with batch integrand (" + files[config] + ")") {
+    greens_tensor.integrate_k(omega, GT, IM, KV_TEMP);
+    return GT(0, 0);
+  };
+  // the cubature only applies to the two-dimensional k integral of the plate
+  if (std::is_same<T, GreensTensorPlate>::value) {
+    greens_tensor.set_integrator(CUBATURE);
+    BENCHMARK("cubature_vec over (phi, kappa) (" + files[config] + ")") {
+      greens_tensor.integrate_k(omega, GT, IM, KV_TEMP);
+      return GT(0, 0);
+    };
+  }
+}
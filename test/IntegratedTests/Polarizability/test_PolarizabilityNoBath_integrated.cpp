@@ -97,3 +97,31 @@ TEST_CASE("Integrated PolarizabilityNoBath fulfills the omega_cut much larger "
   // Ensure that the error is above the error due to the series expansin
   REQUIRE(approx_equal(result, asymp_mat, "absdiff", sqrt(alpha_zero)));
 }
+
+TEST_CASE("Integration of the whole PolarizabilityNoBath tensor coincides "
+          "with the integration of its elements",
+          "[PolarizabilityNoBath]") {
+  auto greens = std::make_shared<GreensTensorVacuum>(1e-4, 1e2, 1E-9);
+  Polarizability pol(1.3, 6e-9, greens);
+
+  double omega_min = 0.0;
+  double omega_max = 1.;
+  double relerr = 1e-10;
+  double abserr = 0.;
+
+  cx_mat::fixed<3, 3> result_elements(fill::zeros);
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 3; j++) {
+      result_elements(i, j) = pol.integrate_omega({i, j}, IM, omega_min,
+                                                  omega_max, relerr, abserr);
+    }
+  }
+
+  cx_mat::fixed<3, 3> result_tensor(fill::zeros);
+  pol.integrate_omega(result_tensor, IM, omega_min, omega_max, relerr, abserr);
+
+  // Ensure non-trivial result
+  REQUIRE(!result_tensor.is_zero());
+
+  REQUIRE(approx_equal(result_tensor, result_elements, "reldiff", 1e-8));
+}
@@ -1,5 +1,6 @@
 #include "Quaca.h"
 #include "catch.hpp"
+#include <algorithm>
 #include <cmath>
 
 TEST_CASE("Integration routines return right results", "[Integrations]") {
@@ -21,3 +22,419 @@ TEST_CASE("Integration routines return right results", "[Integrations]") {
     REQUIRE(testqagiu == Approx(M_PI / 2.0).epsilon(1E-10));
   }
 }
+
+TEST_CASE("Integration workspaces are reused after warm-up",
+          "[Integrations]") {
+  SECTION("Nested integrations do not allocate new workspaces") {
+    // three levels of nested integrations using all wrapped routines
+    auto nested = [=]() -> double {
+      auto outer = [=](double x) -> double {
+        auto middle = [=](double y) -> double {
+          auto inner = [=](double z) -> double {
+            return exp(-x * z) / (1. + y * y);
+          };
+          return cquad(inner, 0., 1., 1E-8, 0) +
+                 qags(inner, 0., 1., 1E-8, 0);
+        };
+        return cquad(middle, 0., 1., 1E-6, 0);
+      };
+      return qagiu(outer, 1., 1E-4, 0);
+    };
+
+    // warm-up
+    double warm = nested();
+    size_t allocations = integration_workspace_allocations();
+    REQUIRE(allocations > 0);
+
+    // after warm-up the pooled workspaces are reused
+    REQUIRE(nested() == warm);
+    REQUIRE(integration_workspace_allocations() == allocations);
+  }
+
+  SECTION("The nested Green's tensor integration does not allocate") {
+    GreensTensorPlate greens_tensor("../data/test_files/GreensTensorPlate.json");
+    cx_mat::fixed<3, 3> GT;
+
+    // warm-up
+    greens_tensor.integrate_k(1E-1, GT, IM, KV);
+    size_t allocations = integration_workspace_allocations();
+
+    greens_tensor.integrate_k(1E-1, GT, IM, KV);
+    greens_tensor.integrate_k(2E-1, GT, RE, TEMP);
+    REQUIRE(integration_workspace_allocations() == allocations);
+  }
+}
+
+TEST_CASE("Vector-valued integration returns right results",
+          "[Integrations]") {
+  SECTION("All components reach the demanded accuracy") {
+    auto f = [=](double x, vec &result) -> void {
+      result(0) = 1. / (x * x + 1.0);
+      result(1) = 1. / sqrt(x);
+      result(2) = 1E-12 * cos(x);
+    };
+    vec test = qag_vec(f, 3, 0, 1, 1E-10, 0);
+    REQUIRE(test(0) == Approx(M_PI / 4.).epsilon(1E-10));
+    REQUIRE(test(1) == Approx(2.0).epsilon(1E-10));
+    REQUIRE(test(2) == Approx(1E-12 * sin(1.)).epsilon(1E-10));
+  }
+
+  SECTION("The components share one subdivision") {
+    int evaluations = 0;
+    auto f = [&](double x, vec &result) -> void {
+      ++evaluations;
+      result(0) = exp(-x);
+      result(1) = 2. * exp(-x);
+    };
+    vec test = qag_vec(f, 2, 0, 10, 1E-12, 0);
+    REQUIRE(test(0) == Approx(1. - exp(-10.)).epsilon(1E-12));
+    REQUIRE(test(1) == Approx(2. * (1. - exp(-10.))).epsilon(1E-12));
+
+    int evaluations_vector = evaluations;
+    evaluations = 0;
+    auto g = [&](double x, vec &result) -> void {
+      ++evaluations;
+      result(0) = exp(-x);
+    };
+    qag_vec(g, 1, 0, 10, 1E-12, 0);
+    REQUIRE(evaluations_vector == evaluations);
+  }
+}
+
+TEST_CASE("Adaptive cubature returns right results", "[Integrations]") {
+  SECTION("The Genz-Malik rule integrates polynomials exactly") {
+    // polynomials of degree 5 are integrated exactly by both rules, hence the
+    // initial region is not bisected
+    auto f = [](const vec &x, vec &result) -> void {
+      result(0) = pow(x(0), 4) * x(1) + pow(x(0), 2) * pow(x(1), 3) + 1.;
+      result(1) = pow(x(0) * x(1), 2);
+    };
+    IntegrationDiagnostics diagnostics;
+    vec test;
+    {
+      IntegrationDiagnosticsScope scope(diagnostics);
+      test = cubature_vec(f, 2, vec({0, 0}), vec({1, 2}), 1E-12, 0);
+    }
+    REQUIRE(test(0) == Approx(2. / 5. + 4. / 3. + 2.).epsilon(1E-12));
+    REQUIRE(test(1) == Approx(8. / 9.).epsilon(1E-12));
+    REQUIRE(diagnostics.intervals == 1);
+    REQUIRE(diagnostics.evaluations == 17);
+  }
+
+  SECTION("Disjoint boxes are integrated jointly") {
+    auto f = [](const vec &x, vec &result) -> void {
+      result(0) = x(0) < 1 ? exp(-x(1)) : 2. * exp(-x(1));
+    };
+    mat a = {{0, 1}, {0, 0}};
+    mat b = {{1, 2}, {1, 1}};
+    vec test = cubature_vec(f, 1, a, b, 1E-10, 0);
+    REQUIRE(test(0) == Approx(3. * (1. - exp(-1.))).epsilon(1E-10));
+  }
+
+  SECTION("All components reach the demanded accuracy") {
+    auto f = [](const vec &x, vec &result) -> void {
+      result(0) = exp(-x(0) - 2 * x(1));
+      result(1) = 1. / sqrt(x(0) + x(1));
+      result(2) = 1E-12 * cos(x(0)) * cos(x(1));
+    };
+    vec test = cubature_vec(f, 3, vec({0, 0}), vec({1, 1}), 1E-8, 0);
+    REQUIRE(test(0) ==
+            Approx((1. - exp(-1.)) * (1. - exp(-2.)) / 2.).epsilon(1E-8));
+    REQUIRE(test(1) ==
+            Approx(4. / 3. * (2. * sqrt(2.) - 2.)).epsilon(1E-8));
+    REQUIRE(test(2) == Approx(1E-12 * sin(1.) * sin(1.)).epsilon(1E-8));
+  }
+}
+
+TEST_CASE("Integration diagnostics are collected", "[Integrations]") {
+  SECTION("Single integrations are recorded") {
+    int evaluations = 0;
+    auto f = [&](double x) -> double {
+      ++evaluations;
+      return 1. / (x * x + 1.0);
+    };
+
+    IntegrationDiagnostics diagnostics;
+    double result;
+    {
+      IntegrationDiagnosticsScope scope(diagnostics);
+      result = cquad(f, 0, 1, 1E-10, 0);
+    }
+    REQUIRE(diagnostics.calls == 1);
+    REQUIRE(diagnostics.evaluations == (size_t)evaluations);
+    REQUIRE(diagnostics.intervals == 1);
+    REQUIRE(diagnostics.result == result);
+    REQUIRE(diagnostics.relerr() <= 1E-10);
+
+    // without a scope nothing is recorded
+    cquad(f, 0, 1, 1E-10, 0);
+    REQUIRE(diagnostics.calls == 1);
+  }
+
+  SECTION("Nested integrations only contribute evaluations") {
+    int evaluations = 0;
+    auto inner = [&](double y) -> double {
+      ++evaluations;
+      return exp(-y);
+    };
+    auto outer = [&](double x) -> double {
+      ++evaluations;
+      return x * qagiu(inner, x, 1E-10, 0);
+    };
+    auto vector = [&](double x, vec &result) -> void {
+      result(0) = outer(x);
+      result(1) = 2. * outer(x);
+    };
+
+    IntegrationDiagnostics diagnostics;
+    vec result;
+    {
+      IntegrationDiagnosticsScope scope(diagnostics);
+      result = qag_vec(vector, 2, 0, 1, 1E-10, 0);
+    }
+    REQUIRE(diagnostics.calls > 1);
+    REQUIRE(diagnostics.evaluations > (size_t)evaluations / 2);
+    REQUIRE(diagnostics.evaluations < (size_t)evaluations);
+    REQUIRE(diagnostics.result == max(abs(result)));
+    REQUIRE(diagnostics.relerr() <= 1E-10);
+  }
+
+  SECTION("Diagnostics are collected through the Green's tensor") {
+    GreensTensorPlate greens_tensor("../data/test_files/GreensTensorPlate.json");
+    cx_mat::fixed<3, 3> GT, GT_diagnostics;
+    IntegrationDiagnostics diagnostics;
+
+    greens_tensor.integrate_k(1E-1, GT, IM, KV);
+    greens_tensor.integrate_k(1E-1, GT_diagnostics, IM, KV, diagnostics);
+    REQUIRE(approx_equal(GT, GT_diagnostics, "reldiff", 1E-15));
+    REQUIRE(diagnostics.calls > 1);
+    REQUIRE(diagnostics.evaluations > diagnostics.intervals);
+    REQUIRE(diagnostics.relerr() < 1);
+  }
+
+  SECTION("Diagnostics of a block of frequencies add up") {
+    GreensTensorPlate greens_tensor("../data/test_files/GreensTensorPlate.json");
+    std::vector<GreensTensorRequest> requests = {{IM, KV}, {RE, UNIT}};
+    std::vector<double> omegas = {1E-1, 2E-1};
+    std::vector<std::vector<cx_mat::fixed<3, 3>>> GT;
+    std::vector<cx_mat::fixed<3, 3>> single;
+
+    IntegrationDiagnostics batch, separate;
+    {
+      IntegrationDiagnosticsScope scope(batch);
+      greens_tensor.integrate_k_batch(omegas, requests, GT);
+    }
+    {
+      IntegrationDiagnosticsScope scope(separate);
+      for (double omega : omegas) {
+        greens_tensor.integrate_k(omega, requests, single);
+      }
+    }
+    REQUIRE(batch.calls == separate.calls);
+    REQUIRE(batch.evaluations == separate.evaluations);
+    REQUIRE(batch.intervals == separate.intervals);
+    REQUIRE(batch.result == Approx(separate.result).epsilon(1E-12));
+  }
+}
+
+TEST_CASE("Double-exponential quadrature returns right results",
+          "[Integrations]") {
+  SECTION("Tanh-sinh resolves end-point singularities") {
+    auto f = [](double x) -> double { return 1. / sqrt(x); };
+    REQUIRE(tanh_sinh(f, 0, 1, 1E-10, 0) == Approx(2.0).epsilon(1E-10));
+
+    auto g = [](double x) -> double { return log(x); };
+    REQUIRE(tanh_sinh(g, 0, 1, 1E-10, 0) == Approx(-1.0).epsilon(1E-10));
+
+    // kink at the upper end point
+    auto h = [](double x) -> double { return std::abs(x - 1.); };
+    REQUIRE(tanh_sinh(h, -1, 1, 1E-10, 0) == Approx(2.0).epsilon(1E-10));
+  }
+
+  SECTION("Tanh-sinh integrates smooth functions on shifted intervals") {
+    auto f = [](double x) -> double { return cos(x); };
+    REQUIRE(tanh_sinh(f, 2, 7, 1E-10, 0) ==
+            Approx(sin(7.) - sin(2.)).epsilon(1E-10));
+  }
+
+  SECTION("Exp-sinh integrates over semi-infinite intervals") {
+    auto f = [](double x) -> double { return x * x * exp(-x); };
+    REQUIRE(exp_sinh(f, 0, 1E-10, 0) == Approx(2.0).epsilon(1E-10));
+
+    auto g = [](double x) -> double { return exp(-x); };
+    REQUIRE(exp_sinh(g, 3, 1E-10, 0) == Approx(exp(-3.)).epsilon(1E-10));
+
+    auto h = [](double x) -> double { return 1. / (x * x + 1.0); };
+    REQUIRE(exp_sinh(h, 0, 1E-10, 0) == Approx(M_PI / 2.).epsilon(1E-10));
+  }
+
+  SECTION("Evaluations are recorded in the diagnostics") {
+    auto f = [](double x) -> double { return exp(-x); };
+    IntegrationDiagnostics diagnostics;
+    double result;
+    {
+      IntegrationDiagnosticsScope scope(diagnostics);
+      result = exp_sinh(f, 0, 1E-10, 0);
+    }
+    REQUIRE(diagnostics.calls == 1);
+    REQUIRE(diagnostics.evaluations > 0);
+    REQUIRE(diagnostics.result == result);
+  }
+}
+
+TEST_CASE("Gauss-Laguerre quadrature returns right results",
+          "[Integrations]") {
+  SECTION("The rules integrate polynomials times the weight exactly") {
+    auto alpha = GENERATE(0., 0.5);
+    const LaguerreRule &rule = laguerre_rule(8, alpha);
+    REQUIRE(rule.nodes.n_elem == 8);
+    REQUIRE(std::is_sorted(rule.nodes.begin(), rule.nodes.end()));
+
+    // int t^(alpha + m) exp(-t) dt = Gamma(alpha + m + 1) for m < 16
+    for (int m : {0, 1, 7, 15}) {
+      vec f = pow(rule.nodes, alpha + m) % exp(-rule.nodes);
+      REQUIRE(dot(rule.weights, f) ==
+              Approx(std::tgamma(alpha + m + 1)).epsilon(1E-10));
+    }
+  }
+
+  SECTION("All components of a decaying function reach the accuracy") {
+    auto f = [](double x, vec &result) -> void {
+      result(0) = exp(-2 * (x - 1));
+      result(1) = x * x * exp(-2 * x);
+      result(2) = 1E-12 * cos(x) * exp(-2 * x);
+    };
+    IntegrationDiagnostics diagnostics;
+    vec test;
+    {
+      IntegrationDiagnosticsScope scope(diagnostics);
+      test = laguerre_vec(f, 3, 1, 2, 1E-10, 0);
+    }
+    REQUIRE(test(0) == Approx(0.5).epsilon(1E-10));
+    REQUIRE(test(1) == Approx(1.25 * exp(-2.)).epsilon(1E-10));
+    REQUIRE(test(2) ==
+            Approx(1E-12 * exp(-2.) * (2 * cos(1.) - sin(1.)) / 5.)
+                .epsilon(1E-10));
+    REQUIRE(diagnostics.failures == 0);
+    REQUIRE(diagnostics.evaluations <= 8 + 16 + 32 + 64 + 128);
+  }
+
+  SECTION("Polynomials times the weight converge with the first rules") {
+    auto f = [](double x) -> double { return pow(x, 5) * exp(-x); };
+    IntegrationDiagnostics diagnostics;
+    double result;
+    {
+      IntegrationDiagnosticsScope scope(diagnostics);
+      result = laguerre(f, 0, 1, 1E-12, 0);
+    }
+    REQUIRE(result == Approx(120.).epsilon(1E-12));
+    REQUIRE(diagnostics.evaluations == 8 + 16);
+  }
+
+  SECTION("Missing the accuracy with the last rule is a failure") {
+    // the pole at -1 limits the convergence of the rules
+    auto f = [](double x) -> double { return exp(-x) / (1 + x); };
+    IntegrationDiagnostics diagnostics;
+    double result;
+    {
+      IntegrationDiagnosticsScope scope(diagnostics);
+      result = laguerre(f, 0, 1, 1E-14, 0);
+    }
+    // exp(1) E_1(1)
+    REQUIRE(result == Approx(0.596347362323194).epsilon(1E-4));
+    REQUIRE(diagnostics.failures == 1);
+    REQUIRE(diagnostics.evaluations == 8 + 16 + 32 + 64 + 128);
+  }
+
+  SECTION("The batch evaluation yields the same result") {
+    auto f = [](double x, vec &result) -> void {
+      result(0) = sin(x) * exp(-3 * x);
+    };
+    auto f_batch = [](const vec &x, mat &result) -> void {
+      result.col(0) = sin(x) % exp(-3 * x);
+    };
+    vec pointwise = laguerre_vec(f, 1, 0.5, 3, 1E-10, 0);
+    vec batch = laguerre_batch(f_batch, 1, 0.5, 3, 1E-10, zeros<vec>(1));
+    REQUIRE(batch(0) == Approx(pointwise(0)).epsilon(1E-14));
+  }
+}
+
+TEST_CASE("Failed integrations are escalated", "[Integrations]") {
+  set_integration_failure_policy(ESCALATE);
+  REQUIRE(get_integration_failure_policy() == ESCALATE);
+
+  SECTION("Converged integrations are not affected") {
+    auto f = [](double x) -> double { return 1. / (x * x + 1.0); };
+    IntegrationDiagnostics diagnostics;
+    double result;
+    {
+      IntegrationDiagnosticsScope scope(diagnostics);
+      result = qags(f, 0, 1, 1E-10, 0);
+    }
+    REQUIRE(result == Approx(M_PI / 4.).epsilon(1E-10));
+    REQUIRE(diagnostics.failures == 0);
+  }
+
+  SECTION("Divergent integrals return without abort") {
+    // the integral of 1/(1+x) over [0, infinity) diverges logarithmically
+    auto f = [](double x) -> double { return 1. / (1. + x); };
+    IntegrationDiagnostics diagnostics;
+    {
+      IntegrationDiagnosticsScope scope(diagnostics);
+      qagiu(f, 0, 1E-10, 0);
+    }
+    REQUIRE(diagnostics.calls == 1);
+    REQUIRE(diagnostics.failures == 1);
+  }
+
+  SECTION("Unconverged vector-valued integrations are recorded") {
+    auto f = [](double x, vec &result) -> void {
+      result(0) = 1. / x;
+      result(1) = 1.;
+    };
+    IntegrationDiagnostics diagnostics;
+    {
+      IntegrationDiagnosticsScope scope(diagnostics);
+      qag_vec(f, 2, 0, 1, 1E-10, 0);
+    }
+    REQUIRE(diagnostics.calls == 1);
+    REQUIRE(diagnostics.failures == 1);
+  }
+
+  SECTION("Unconverged double-exponential quadratures are recorded") {
+    // the integral of 1/x over [0, 1] diverges at the end point
+    auto f = [](double x) -> double { return 1. / x; };
+    IntegrationDiagnostics diagnostics;
+    {
+      IntegrationDiagnosticsScope scope(diagnostics);
+      tanh_sinh(f, 0, 1, 1E-10, 0);
+    }
+    REQUIRE(diagnostics.calls == 1);
+    REQUIRE(diagnostics.failures == 1);
+  }
+
+  SECTION("Double-exponential quadratures are escalated with more halvings") {
+    auto f = [](double x) -> double { return cos(2000. * x); };
+    IntegrationDiagnostics escalated, aborting;
+    double result;
+    {
+      IntegrationDiagnosticsScope scope(escalated);
+      result = tanh_sinh(f, 0, 1, 1E-10, 0);
+    }
+    set_integration_failure_policy(ABORT);
+    {
+      IntegrationDiagnosticsScope scope(aborting);
+      tanh_sinh(f, 0, 1, 1E-10, 0);
+    }
+    set_integration_failure_policy(ESCALATE);
+
+    // the first attempt misses the accuracy, the escalation reaches it
+    REQUIRE(aborting.failures == 1);
+    REQUIRE(escalated.failures == 0);
+    REQUIRE(escalated.evaluations > aborting.evaluations);
+    REQUIRE(result == Approx(sin(2000.) / 2000.).epsilon(1E-9));
+  }
+
+  set_integration_failure_policy(ABORT);
+  REQUIRE(get_integration_failure_policy() == ABORT);
+}
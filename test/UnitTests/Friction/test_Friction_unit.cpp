@@ -1,5 +1,6 @@
 #include "Quaca.h"
 #include "catch.hpp"
+#include <omp.h>
 
 TEST_CASE("Friction constructors work as expected", "[Friction]") {
   SECTION("Direct constructor") {
@@ -69,4 +70,257 @@ TEST_CASE("Friction constructors work as expected", "[Friction]") {
                        ->get_alpha_zero())
                 .epsilon(1e-6) == alpha_zero);
   }
+
+  SECTION("configuration constructor") {
+    Configuration configuration("../data/test_files/FrictionVacuum.json");
+    Friction from_file("../data/test_files/FrictionVacuum.json");
+    Friction from_configuration(configuration);
+
+    REQUIRE(from_configuration.get_greens_tensor()->get_v() ==
+            from_file.get_greens_tensor()->get_v());
+    REQUIRE(from_configuration.get_polarizability()->get_omega_a() ==
+            from_file.get_polarizability()->get_omega_a());
+    REQUIRE(from_configuration.calculate(NON_LTE_ONLY) ==
+            from_file.calculate(NON_LTE_ONLY));
+
+    // a changed tree is used without writing it to a file
+    boost::property_tree::ptree root = configuration.get_root();
+    root.put("GreensTensor.v", 0.02);
+    Friction changed{Configuration(root)};
+    REQUIRE(changed.get_greens_tensor()->get_v() == 0.02);
+    REQUIRE(changed.get_powerspectrum()->get_greens_tensor()->get_v() == 0.02);
+    REQUIRE(changed.get_polarizability()->get_greens_tensor()->get_v() ==
+            0.02);
+  }
+}
+
+TEST_CASE("The quadratures of the omega tail agree", "[Friction]") {
+  // the test input with a tighter accuracy of the omega integration
+  boost::property_tree::ptree root =
+      Configuration("../data/test_files/FrictionVacuum.json").get_root();
+  root.put("Friction.relerr_omega", 1E-6);
+  Friction quant_fric{Configuration(root)};
+  double relerr_omega = quant_fric.get_relerr_omega();
+  REQUIRE(quant_fric.get_tail_quadrature() == ADAPTIVE);
+
+  // the tail from the last breakpoint to infinity
+  double omega_min = 1.001 * quant_fric.get_polarizability()->get_omega_a();
+  auto F = [&](double x) -> double {
+    return quant_fric.friction_integrand(x, NON_LTE_ONLY);
+  };
+  double adaptive = qagiu(F, omega_min, relerr_omega, 0);
+  double double_exponential = exp_sinh(F, omega_min, relerr_omega, 0);
+  REQUIRE(adaptive != 0);
+  REQUIRE(double_exponential == Approx(adaptive).epsilon(relerr_omega));
+
+  // the full friction force
+  IntegrationDiagnostics diagnostics;
+  double result_adaptive = quant_fric.calculate(NON_LTE_ONLY);
+  quant_fric.set_tail_quadrature(DOUBLE_EXPONENTIAL);
+  double result_double_exponential;
+  {
+    IntegrationDiagnosticsScope scope(diagnostics);
+    result_double_exponential = quant_fric.calculate(NON_LTE_ONLY);
+  }
+  REQUIRE(diagnostics.failures == 0);
+  REQUIRE(result_double_exponential ==
+          Approx(result_adaptive).epsilon(relerr_omega));
+}
+
+TEST_CASE("The integrand of several distances equals the single ones",
+          "[Friction]") {
+  // omega / v stays below the cut-off of all distances
+  auto omega = GENERATE(0.2, 0.3);
+  Spectrum_Options spectrum = GENERATE(FULL, NON_LTE_ONLY);
+
+  vec::fixed<2> rel_err = {1E-6, 1E-4};
+  auto perm = std::make_shared<PermittivityDrude>(3.5E-2, 9);
+  auto refl = std::make_shared<ReflectionCoefficientsLocBulk>(perm);
+  auto greens = std::make_shared<GreensTensorPlate>(1E-2, 100., 0.1, refl,
+                                                    20., rel_err);
+  // the vector integrator shares the nodes between the distances
+  greens->set_integrator(VECTOR);
+  auto alpha = std::make_shared<Polarizability>(1.3, 6e-9, greens);
+  auto powerspectrum = std::make_shared<PowerSpectrum>(greens, alpha);
+  Friction quant_fric(greens, alpha, powerspectrum, 1E-1);
+
+  std::vector<double> distances = {0.1, 0.2};
+  vec batch;
+  quant_fric.friction_integrand(omega, spectrum, distances, batch);
+  REQUIRE(batch.n_elem == distances.size());
+
+  for (size_t j = 0; j < distances.size(); j++) {
+    greens->set_za(distances[j]);
+    double single = quant_fric.friction_integrand(omega, spectrum);
+    REQUIRE(single != 0);
+    REQUIRE(batch(j) == Approx(single).epsilon(1E-3));
+  }
+}
+
+TEST_CASE("The friction of several distances equals the single ones",
+          "[Friction]") {
+  // the plate of the analytical low-velocity result
+  vec::fixed<2> rel_err = {1E-6, 1E-4};
+  auto perm = std::make_shared<PermittivityDrude>(9., 0.1);
+  auto refl = std::make_shared<ReflectionCoefficientsLocBulk>(perm);
+  auto greens = std::make_shared<GreensTensorPlate>(1E-4, 1E6, 0.01, refl,
+                                                    30., rel_err);
+  greens->set_integrator(VECTOR);
+  auto alpha = std::make_shared<Polarizability>(1.3, 6e-9, greens);
+  auto powerspectrum = std::make_shared<PowerSpectrum>(greens, alpha);
+  Friction quant_fric(greens, alpha, powerspectrum, 1E-2);
+  double relerr_omega = quant_fric.get_relerr_omega();
+
+  std::vector<double> distances = {0.01, 0.02};
+  vec batch = quant_fric.calculate(NON_LTE_ONLY, distances);
+  REQUIRE(batch.n_elem == distances.size());
+
+  for (size_t j = 0; j < distances.size(); j++) {
+    greens->set_za(distances[j]);
+    double single = quant_fric.calculate(NON_LTE_ONLY);
+    REQUIRE(single != 0);
+    REQUIRE(batch(j) == Approx(single).epsilon(relerr_omega));
+  }
+}
+
+TEST_CASE("The friction of several temperatures equals the single ones",
+          "[Friction]") {
+  Spectrum_Options spectrum = GENERATE(FULL, NON_LTE_ONLY);
+  // the test input with a tighter accuracy of the omega integration
+  boost::property_tree::ptree root =
+      Configuration("../data/test_files/FrictionVacuum.json").get_root();
+  root.put("Friction.relerr_omega", 1E-3);
+  Friction quant_fric{Configuration(root)};
+  double relerr_omega = quant_fric.get_relerr_omega();
+  auto greens = quant_fric.get_greens_tensor();
+
+  std::vector<double> betas = {1., 5., 20.};
+  vec integrand;
+  quant_fric.friction_integrand_temperatures(0.8, spectrum, betas, integrand);
+  vec batch = quant_fric.calculate_temperatures(spectrum, betas);
+  REQUIRE(batch.n_elem == betas.size());
+
+  for (size_t j = 0; j < betas.size(); j++) {
+    greens->set_beta(betas[j]);
+    REQUIRE(integrand(j) ==
+            Approx(quant_fric.friction_integrand(0.8, spectrum))
+                .epsilon(1E-8));
+    REQUIRE(batch(j) ==
+            Approx(quant_fric.calculate(spectrum)).epsilon(relerr_omega));
+  }
+}
+
+TEST_CASE("The friction at given parameters equals the one of a changed "
+          "model",
+          "[Friction]") {
+  Spectrum_Options spectrum = GENERATE(FULL, NON_LTE_ONLY);
+  auto omega_integrator = GENERATE(OMEGA_POINTWISE, OMEGA_BATCH);
+  Friction quant_fric("../data/test_files/FrictionVacuum.json");
+  Friction changed("../data/test_files/FrictionVacuum.json");
+  quant_fric.set_omega_integrator(omega_integrator);
+  changed.set_omega_integrator(omega_integrator);
+
+  EvaluationParameters parameters =
+      quant_fric.get_greens_tensor()->get_parameters();
+  parameters.v *= 2;
+  parameters.beta /= 2;
+  changed.get_greens_tensor()->set_v(parameters.v);
+  changed.get_greens_tensor()->set_beta(parameters.beta);
+
+  REQUIRE(quant_fric.friction_integrand(0.8, spectrum, parameters) ==
+          Approx(changed.friction_integrand(0.8, spectrum)).epsilon(1E-12));
+  double result = quant_fric.calculate(spectrum, parameters);
+  REQUIRE(result != 0);
+  REQUIRE(result == Approx(changed.calculate(spectrum)).epsilon(1E-12));
+
+  // the model keeps its own parameters
+  REQUIRE(quant_fric.get_greens_tensor()->get_v() == 0.01);
+  REQUIRE(quant_fric.get_greens_tensor()->get_beta() == 5.);
+}
+
+TEST_CASE("The plate friction at a given distance equals the one of a "
+          "changed model",
+          "[Friction]") {
+  Spectrum_Options spectrum = GENERATE(FULL, NON_LTE_ONLY);
+  vec::fixed<2> rel_err = {1E-6, 1E-4};
+  auto perm = std::make_shared<PermittivityDrude>(9., 0.1);
+  auto refl = std::make_shared<ReflectionCoefficientsLocBulk>(perm);
+  auto greens = std::make_shared<GreensTensorPlate>(1E-4, 1E6, 0.01, refl,
+                                                    30., rel_err);
+  auto alpha = std::make_shared<Polarizability>(1.3, 6e-9, greens);
+  Friction quant_fric(greens, alpha,
+                      std::make_shared<PowerSpectrum>(greens, alpha), 1E-2);
+
+  auto changed_greens = std::make_shared<GreensTensorPlate>(
+      1E-4, 1E6, 0.02, refl, 30., rel_err);
+  auto changed_alpha =
+      std::make_shared<Polarizability>(1.3, 6e-9, changed_greens);
+  Friction changed(changed_greens, changed_alpha,
+                   std::make_shared<PowerSpectrum>(changed_greens,
+                                                   changed_alpha),
+                   1E-2);
+
+  // the breakpoints at the plasmons are smeared according to the distance
+  EvaluationParameters parameters = greens->get_parameters();
+  parameters.za = 0.02;
+  std::vector<double> breakpoints =
+      alpha->omega_breakpoints(0, INFINITY, parameters);
+  REQUIRE(breakpoints == changed_alpha->omega_breakpoints(0, INFINITY));
+  REQUIRE(breakpoints != alpha->omega_breakpoints(0, INFINITY));
+
+  auto omega = GENERATE(0.05, 0.1);
+  double integrand = quant_fric.friction_integrand(omega, spectrum, parameters);
+  REQUIRE(integrand != 0);
+  REQUIRE(integrand ==
+          Approx(changed.friction_integrand(omega, spectrum)).epsilon(1E-12));
+  REQUIRE(greens->get_za() == 0.01);
+}
+
+TEST_CASE("The batched omega integration agrees with the pointwise one",
+          "[Friction]") {
+  Spectrum_Options spectrum = GENERATE(FULL, NON_LTE_ONLY);
+  Friction quant_fric("../data/test_files/FrictionVacuum.json");
+  REQUIRE(quant_fric.get_omega_integrator() == OMEGA_POINTWISE);
+
+  // the integrand of a block equals the one of every frequency
+  vec omegas = {0.3, 0.8, 1.3, 2.5};
+  vec block;
+  quant_fric.friction_integrand_batch(omegas, spectrum, block);
+  REQUIRE(block.n_elem == omegas.n_elem);
+  for (uword j = 0; j < omegas.n_elem; j++) {
+    REQUIRE(block(j) ==
+            Approx(quant_fric.friction_integrand(omegas(j), spectrum))
+                .epsilon(1E-12));
+  }
+
+  double pointwise = quant_fric.calculate(spectrum);
+  quant_fric.set_omega_integrator(OMEGA_BATCH);
+  double batch = quant_fric.calculate(spectrum);
+  REQUIRE(batch != 0);
+  REQUIRE(batch == Approx(pointwise).epsilon(1E-2));
+
+  // the tail is integrated with the same quadrature as the pointwise one
+  quant_fric.set_tail_quadrature(DOUBLE_EXPONENTIAL);
+  double batch_double_exponential = quant_fric.calculate(spectrum);
+  REQUIRE(batch_double_exponential != batch);
+  REQUIRE(batch_double_exponential == Approx(pointwise).epsilon(1E-2));
+}
+
+TEST_CASE("The task-parallel friction does not depend on the threads",
+          "[Friction]") {
+  Spectrum_Options spectrum = GENERATE(FULL, NON_LTE_ONLY);
+  Friction quant_fric("../data/test_files/FrictionVacuum.json");
+  REQUIRE(!quant_fric.get_task_parallel());
+  double sequential = quant_fric.calculate(spectrum);
+
+  quant_fric.set_task_parallel(true);
+  int max_threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  double single = quant_fric.calculate(spectrum);
+  omp_set_num_threads(3);
+  double team = quant_fric.calculate(spectrum);
+  omp_set_num_threads(max_threads);
+
+  REQUIRE(team == single);
+  REQUIRE(team == Approx(sequential).epsilon(1E-2));
 }
@@ -115,3 +115,72 @@ TEST_CASE("GreensTensorPlateVacuum integrate_k function returns the sum "
   REQUIRE(approx_equal(TensorPlateVacuum,TensorVacuum + TensorPlate, "reldiff", 1e-10));
 
 }
+
+TEST_CASE("GreensTensorPlateVacuum integrates a bundle of requests as the "
+          "sum of plate and vacuum Green's tensor",
+          "[GreensTensorPlateVacuum]") {
+
+  double omega_p = 9;
+  double gamma = 0.1;
+  auto perm = std::make_shared<PermittivityDrude>(omega_p, gamma);
+  auto refl = std::make_shared<ReflectionCoefficientsLocBulk>(perm);
+
+  double v = 1E-2;
+  double za = 0.1;
+  double beta = 1E2;
+  double delta_cut = 20;
+  vec::fixed<2> rel_err = {1E-8, 1E-6};
+
+  GreensTensorPlateVacuum GTPlateVacuum(v, beta, za, refl, delta_cut, rel_err);
+  GreensTensorPlate GTPlate(v, beta, za, refl, delta_cut, rel_err);
+  GreensTensorVacuum GTVacuum(v, beta, rel_err(0));
+
+  auto omega = GENERATE(-0.3, 2.1);
+
+  std::vector<GreensTensorRequest> requests = {{IM, KV}, {RE, UNIT}, {IM, UNIT}};
+  std::vector<cx_mat::fixed<3, 3>> TensorsPlateVacuum, TensorsPlate,
+      TensorsVacuum;
+  GTPlateVacuum.integrate_k(omega, requests, TensorsPlateVacuum);
+  GTPlate.integrate_k(omega, requests, TensorsPlate);
+  GTVacuum.integrate_k(omega, requests, TensorsVacuum);
+
+  for (size_t i = 0; i < requests.size(); i++) {
+    // Ensure non-trivial results
+    REQUIRE(!TensorsPlateVacuum[i].is_zero());
+
+    REQUIRE(approx_equal(TensorsPlateVacuum[i],
+                         TensorsVacuum[i] + TensorsPlate[i], "reldiff",
+                         1e-10));
+  }
+}
+
+TEST_CASE("GreensTensorPlateVacuum evaluates the plate and the vacuum at the "
+          "given parameters",
+          "[GreensTensorPlateVacuum]") {
+  auto perm = std::make_shared<PermittivityDrude>(9, 0.1);
+  auto refl = std::make_shared<ReflectionCoefficientsLocBulk>(perm);
+  vec::fixed<2> rel_err = {1E-8, 1E-6};
+  GreensTensorPlateVacuum GTPlateVacuum(1E-2, 1E2, 0.1, refl, 20, rel_err);
+
+  EvaluationParameters parameters = {2E-2, 0.05, 10.};
+  auto copy = std::dynamic_pointer_cast<GreensTensorPlateVacuum>(
+      GTPlateVacuum.with_parameters(parameters));
+  REQUIRE(copy != nullptr);
+  REQUIRE(copy->has_parameters(parameters));
+  REQUIRE(copy->get_vacuums_greens_tensor()->has_parameters(parameters));
+  REQUIRE(copy->get_reflection_coefficients() == refl);
+
+  // the original keeps its parameters
+  REQUIRE(GTPlateVacuum.get_za() == 0.1);
+  REQUIRE(GTPlateVacuum.get_vacuums_greens_tensor()->get_v() == 1E-2);
+
+  GreensTensorPlateVacuum other(2E-2, 10., 0.05, refl, 20, rel_err);
+  std::vector<GreensTensorRequest> requests = {{IM, KV}, {IM, NON_LTE}};
+  std::vector<cx_mat::fixed<3, 3>> tensors, reference;
+  GTPlateVacuum.integrate_k(2.1, parameters, requests, tensors);
+  other.integrate_k(2.1, requests, reference);
+  for (size_t i = 0; i < requests.size(); i++) {
+    REQUIRE(!tensors[i].is_zero());
+    REQUIRE(approx_equal(tensors[i], reference[i], "reldiff", 1E-12));
+  }
+}
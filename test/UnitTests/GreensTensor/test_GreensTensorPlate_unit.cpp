@@ -1,5 +1,6 @@
 #include "Quaca.h"
 #include "catch.hpp"
+#include <algorithm>
 #include <armadillo>
 #include <complex>
 
@@ -182,8 +183,190 @@ TEST_CASE("Plate Green's tensor fulfills physical relations",
   }
 }
 
+TEST_CASE("The batch and the pointwise integrand_2d_k coincide",
+          "[GreensTensorPlate]") {
+  auto omega = GENERATE(-2.3, 0.4, 21.);
+  auto phi = GENERATE(0.1, 1.2, 2.9);
+  auto fancy_complex = GENERATE(IM, RE);
+  auto weight_function =
+      GENERATE(UNIT, KV, TEMP, KV_TEMP, NON_LTE, KV_NON_LTE);
+  GreensTensorPlate Greens("../data/test_files/GreensTensorPlate.json");
+
+  // nodes on both sides of kappa = 0
+  vec kappa = {-0.9 * std::abs(omega), -0.3 * std::abs(omega), 0.2, 3.1, 45.};
+  mat batch;
+  Greens.integrand_2d_k(kappa, omega, phi, batch, fancy_complex,
+                        weight_function);
+
+  std::vector<uvec::fixed<2>> indices = {{0, 0}, {1, 1}, {2, 2}, {2, 0}};
+  for (uword i = 0; i < kappa.n_elem; i++) {
+    for (uword j = 0; j < indices.size(); j++) {
+      double pointwise = Greens.integrand_2d_k(kappa(i), omega, phi, indices[j],
+                                               fancy_complex, weight_function);
+      REQUIRE(batch(i, j) == Approx(pointwise).epsilon(1E-12).margin(1E-300));
+    }
+  }
+}
+
+// Reflection coefficients that count their evaluations
+class CountingReflectionCoefficients : public ReflectionCoefficients {
+public:
+  std::shared_ptr<ReflectionCoefficients> reflection_coefficients;
+  mutable size_t evaluations = 0;
+
+  explicit CountingReflectionCoefficients(
+      std::shared_ptr<ReflectionCoefficients> reflection_coefficients)
+      : reflection_coefficients(std::move(reflection_coefficients)) {}
+
+  void calculate(double omega, std::complex<double> kappa,
+                 std::complex<double> &r_p,
+                 std::complex<double> &r_s) const override {
+    ++evaluations;
+    reflection_coefficients->calculate(omega, kappa, r_p, r_s);
+  }
+
+  void print_info(std::ostream &stream) const override {
+    reflection_coefficients->print_info(stream);
+  }
+};
+
+TEST_CASE("The fused and the single-element integrand_2d_k coincide",
+          "[GreensTensorPlate]") {
+  auto omega = GENERATE(-2.3, 0.4, 21.);
+  auto phi = GENERATE(0.1, 1.2, 2.9);
+  auto fancy_complex = GENERATE(IM, RE);
+  auto weight_function =
+      GENERATE(UNIT, KV, TEMP, KV_TEMP, NON_LTE, KV_NON_LTE);
+  GreensTensorPlate reference("../data/test_files/GreensTensorPlate.json");
+  auto refl = std::make_shared<CountingReflectionCoefficients>(
+      ReflectionCoefficientsFactory::create(
+          "../data/test_files/GreensTensorPlate.json"));
+  GreensTensorPlate Greens(reference.get_v(), reference.get_beta(),
+                           reference.get_za(), refl,
+                           reference.get_delta_cut(),
+                           {reference.get_rel_err_0(),
+                            reference.get_rel_err_1()});
+
+  // nodes on both sides of kappa = 0
+  vec kappa = {-0.9 * std::abs(omega), -0.3 * std::abs(omega), 0.2, 3.1, 45.};
+  std::vector<uvec::fixed<2>> indices = {{0, 0}, {1, 1}, {2, 2}, {2, 0}};
+  for (uword i = 0; i < kappa.n_elem; i++) {
+    // all elements share one evaluation of the reflection coefficients
+    vec fused;
+    refl->evaluations = 0;
+    Greens.integrand_2d_k(kappa(i), omega, phi, fused, fancy_complex,
+                          weight_function);
+    REQUIRE(refl->evaluations == 1);
+
+    for (uword j = 0; j < indices.size(); j++) {
+      double single = Greens.integrand_2d_k(kappa(i), omega, phi, indices[j],
+                                            fancy_complex, weight_function);
+      REQUIRE(fused(j) == Approx(single).epsilon(1E-12).margin(1E-300));
+    }
+  }
+}
+
 TEST_CASE("Integrated Green's tensor works properly", "[GreensTensorPlate]") {
 
+  SECTION("The vector integrator yields the same tensor") {
+    auto omega = GENERATE(-0.3, 1.543, 23.54);
+    auto weight_function = GENERATE(UNIT, KV, TEMP, KV_TEMP);
+    GreensTensorPlate Greens("../data/test_files/GreensTensorPlate.json");
+    REQUIRE(Greens.get_integrator() == POINTWISE);
+
+    cx_mat::fixed<3, 3> pointwise(fill::zeros);
+    cx_mat::fixed<3, 3> vector(fill::zeros);
+
+    Greens.integrate_k(omega, pointwise, IM, weight_function);
+    Greens.set_integrator(VECTOR);
+    IntegrationDiagnostics diagnostics;
+    Greens.integrate_k(omega, vector, IM, weight_function, diagnostics);
+
+    REQUIRE(!pointwise.is_zero());
+    REQUIRE(diagnostics.failures == 0);
+    REQUIRE(approx_equal(pointwise, vector, "reldiff", 1E-5));
+  }
+
+  SECTION("The double-exponential kappa quadrature yields the same tensor") {
+    // below the plasma frequency, where the propagating waves have no kink
+    auto omega = GENERATE(-0.3, 1.543);
+    auto weight_function = GENERATE(UNIT, KV_TEMP);
+    GreensTensorPlate Greens("../data/test_files/GreensTensorPlate.json");
+    REQUIRE(Greens.get_kappa_quadrature() == ADAPTIVE);
+
+    cx_mat::fixed<3, 3> adaptive(fill::zeros);
+    cx_mat::fixed<3, 3> double_exponential(fill::zeros);
+
+    Greens.integrate_k(omega, adaptive, IM, weight_function);
+    Greens.set_kappa_quadrature(DOUBLE_EXPONENTIAL);
+    IntegrationDiagnostics diagnostics;
+    Greens.integrate_k(omega, double_exponential, IM, weight_function,
+                       diagnostics);
+
+    REQUIRE(!adaptive.is_zero());
+    REQUIRE(diagnostics.failures == 0);
+    REQUIRE(approx_equal(adaptive, double_exponential, "reldiff", 1E-5));
+  }
+
+  SECTION("The batch integrator yields the same tensor") {
+    auto omega = GENERATE(-0.3, 1.543, 23.54);
+    auto weight_function = GENERATE(UNIT, KV, TEMP, KV_TEMP);
+    GreensTensorPlate Greens("../data/test_files/GreensTensorPlate.json");
+    REQUIRE(Greens.get_integrator() == POINTWISE);
+
+    cx_mat::fixed<3, 3> pointwise(fill::zeros);
+    cx_mat::fixed<3, 3> batch(fill::zeros);
+
+    Greens.set_integrator(VECTOR);
+    Greens.integrate_k(omega, pointwise, IM, weight_function);
+    Greens.set_integrator(BATCH);
+    Greens.integrate_k(omega, batch, IM, weight_function);
+
+    // both integrate the elements jointly on the same subdivision
+    REQUIRE(!pointwise.is_zero());
+    REQUIRE(approx_equal(pointwise, batch, "reldiff", 1E-10));
+  }
+
+  SECTION("The cubature integrator yields the same tensor") {
+    auto omega = GENERATE(-0.3, 0.54, 3.0);
+    auto weight_function = GENERATE(UNIT, KV, TEMP, KV_TEMP);
+    GreensTensorPlate Greens("../data/test_files/GreensTensorPlate.json");
+
+    cx_mat::fixed<3, 3> nested(fill::zeros);
+    cx_mat::fixed<3, 3> cubature(fill::zeros);
+
+    Greens.integrate_k(omega, nested, IM, weight_function);
+    Greens.set_integrator(CUBATURE);
+    IntegrationDiagnostics diagnostics;
+    Greens.integrate_k(omega, cubature, IM, weight_function, diagnostics);
+
+    REQUIRE(!nested.is_zero());
+    REQUIRE(diagnostics.failures == 0);
+    REQUIRE(approx_equal(nested, cubature, "reldiff", 1E-5));
+  }
+
+  SECTION("A bundle of requests yields the separately integrated tensors") {
+    auto omega = GENERATE(-0.3, 0.54, 3.0);
+    auto integrator = GENERATE(POINTWISE, VECTOR, BATCH, CUBATURE);
+    GreensTensorPlate Greens("../data/test_files/GreensTensorPlate.json");
+    Greens.set_integrator(integrator);
+
+    std::vector<GreensTensorRequest> requests = {
+        {IM, KV}, {IM, KV_TEMP}, {IM, NON_LTE}, {RE, UNIT}, {IM, UNIT}};
+    std::vector<cx_mat::fixed<3, 3>> bundle;
+    Greens.integrate_k(omega, requests, bundle);
+
+    REQUIRE(bundle.size() == requests.size());
+    REQUIRE(!bundle[0].is_zero());
+    for (size_t i = 0; i < requests.size(); i++) {
+      cx_mat::fixed<3, 3> separate(fill::zeros);
+      Greens.integrate_k(omega, separate, requests[i].fancy_complex,
+                         requests[i].weight_function);
+
+      REQUIRE(approx_equal(bundle[i], separate, "reldiff", 1E-5));
+    }
+  }
+
   SECTION("Integral over Green_fancy_I obeys the crossing relation") {
     auto omega = GENERATE(1.543,23.54,76.12);
     GreensTensorPlate Greens("../data/test_files/GreensTensorPlate.json");
@@ -424,3 +607,332 @@ TEST_CASE("Integrated Green's tensor matches asymptotes",
   }
 }
 
+
+// reflection coefficients that hide the resonances of the wrapped ones
+class ReflectionCoefficientsWithoutResonances : public ReflectionCoefficients {
+  std::shared_ptr<ReflectionCoefficients> refl;
+
+public:
+  explicit ReflectionCoefficientsWithoutResonances(
+      std::shared_ptr<ReflectionCoefficients> refl)
+      : refl(std::move(refl)) {}
+  void calculate(double omega, std::complex<double> kappa,
+                 std::complex<double> &r_p,
+                 std::complex<double> &r_s) const override {
+    refl->calculate(omega, kappa, r_p, r_s);
+  }
+  void print_info(std::ostream &stream) const override {
+    refl->print_info(stream);
+  }
+};
+
+TEST_CASE("The integrations are split at the resonances",
+          "[GreensTensorPlate]") {
+  double omega_p = 9;
+  double gamma = 0.01;
+  double v = 1E-2;
+  double za = 0.1;
+  double beta = 1E4;
+  double delta_cut = 20;
+  vec::fixed<2> rel_err = {1E-8, 1E-6};
+  auto perm = std::make_shared<PermittivityDrude>(omega_p, gamma);
+  auto refl = std::make_shared<ReflectionCoefficientsLocBulk>(perm);
+  GreensTensorPlate Greens(v, beta, za, refl, delta_cut, rel_err);
+
+  // The surface plasmon is hit by Doppler-shifting the frequency towards it
+  double omega_sp = omega_p / sqrt(2);
+  auto sign = GENERATE(-1., 1.);
+  double omega = sign * (omega_sp - 0.3);
+  double phi = sign > 0 ? 0.4 : M_PI - 0.4;
+
+  SECTION("The kappa domain is split where the resonance is hit") {
+    std::vector<double> bounds = Greens.kappa_bounds(omega, phi);
+    REQUIRE(bounds.front() == 0);
+    REQUIRE(bounds.back() == delta_cut / (2 * za));
+    REQUIRE(bounds.size() == 3);
+
+    // the Doppler-shifted frequency at the breakpoint
+    double kappa = bounds[1];
+    double k = (sqrt(kappa * kappa + omega * omega -
+                     kappa * kappa * v * v * cos(phi) * cos(phi)) +
+                v * omega * cos(phi)) /
+               (1 - v * v * cos(phi) * cos(phi));
+    REQUIRE(std::abs(omega + k * v * cos(phi)) ==
+            Approx(omega_sp).epsilon(1E-10));
+  }
+
+  SECTION("The phi domain is split where the resonance enters") {
+    std::vector<double> bounds = Greens.phi_bounds(omega);
+    REQUIRE(bounds.front() == 0);
+    REQUIRE(bounds.back() == M_PI);
+    REQUIRE(bounds.size() > 2);
+    REQUIRE(std::is_sorted(bounds.begin(), bounds.end()));
+  }
+
+  SECTION("The splitting leaves the integrated tensor unchanged") {
+    GreensTensorPlate Greens_unsplit(
+        v, beta, za,
+        std::make_shared<ReflectionCoefficientsWithoutResonances>(refl),
+        delta_cut, rel_err);
+    REQUIRE(Greens_unsplit.kappa_bounds(omega, phi).size() == 2);
+
+    cx_mat::fixed<3, 3> GT_split, GT_unsplit;
+    Greens.integrate_k(omega, GT_split, IM, KV);
+    Greens_unsplit.integrate_k(omega, GT_unsplit, IM, KV);
+
+    REQUIRE(!GT_split.is_zero());
+    REQUIRE(approx_equal(GT_split, GT_unsplit, "reldiff", 1E-5));
+  }
+}
+
+TEST_CASE("The substitutions of the integration variables are consistent",
+          "[GreensTensorPlate]") {
+  auto omega = GENERATE(-0.3, 0.54, 3.0);
+  auto weight_function = GENERATE(UNIT, KV_TEMP);
+  GreensTensorPlate Greens("../data/test_files/GreensTensorPlate.json");
+  REQUIRE(Greens.get_substitution() == NO_SUBSTITUTION);
+  REQUIRE(!Greens.get_regularize_phi());
+
+  // the scheme without substitutions
+  cx_mat::fixed<3, 3> plain(fill::zeros);
+  IntegrationDiagnostics plain_diagnostics;
+  Greens.integrate_k(omega, plain, IM, weight_function, plain_diagnostics);
+  REQUIRE(!plain.is_zero());
+
+  SECTION("Substitutions of kappa") {
+    auto substitution = GENERATE(LOGARITHMIC, SIGMOIDAL);
+    Greens.set_substitution(substitution);
+
+    cx_mat::fixed<3, 3> substituted(fill::zeros);
+    IntegrationDiagnostics diagnostics;
+    Greens.integrate_k(omega, substituted, IM, weight_function, diagnostics);
+
+    REQUIRE(diagnostics.failures == 0);
+    REQUIRE(approx_equal(plain, substituted, "reldiff", 1E-5));
+
+    // clustering the nodes at the boundaries of the pieces saves evaluations
+    if (substitution == SIGMOIDAL) {
+      REQUIRE(diagnostics.evaluations < plain_diagnostics.evaluations);
+    }
+  }
+
+  SECTION("Regularization of phi") {
+    Greens.set_regularize_phi(true);
+    std::vector<double> bounds = Greens.phi_bounds(omega);
+    REQUIRE(std::find(bounds.begin(), bounds.end(), M_PI / 2) != bounds.end());
+
+    cx_mat::fixed<3, 3> regularized(fill::zeros);
+    IntegrationDiagnostics diagnostics;
+    Greens.integrate_k(omega, regularized, IM, weight_function, diagnostics);
+
+    REQUIRE(diagnostics.failures == 0);
+    REQUIRE(approx_equal(plain, regularized, "reldiff", 1E-5));
+  }
+}
+
+TEST_CASE("The Gauss-Laguerre tail replaces the cut-off",
+          "[GreensTensorPlate]") {
+  auto omega = GENERATE(-0.3, 0.54, 3.0);
+  auto weight_function = GENERATE(UNIT, KV_TEMP);
+  GreensTensorPlate Greens("../data/test_files/GreensTensorPlate.json");
+  REQUIRE(Greens.get_tail() == TRUNCATED);
+
+  // The truncation at delta_cut = 20 misses the demanded accuracy due to the
+  // powers of kappa of the integrand, twice the cut-off reaches it.
+  vec::fixed<2> rel_err = {Greens.get_rel_err_0(), Greens.get_rel_err_1()};
+  GreensTensorPlate Greens_truncated(
+      Greens.get_v(), Greens.get_beta(), Greens.get_za(),
+      Greens.get_reflection_coefficients(), 2 * Greens.get_delta_cut(),
+      rel_err);
+  cx_mat::fixed<3, 3> truncated(fill::zeros);
+  IntegrationDiagnostics truncated_diagnostics;
+  Greens_truncated.integrate_k(omega, truncated, IM, weight_function,
+                               truncated_diagnostics);
+
+  Greens.set_tail(LAGUERRE);
+  REQUIRE(Greens.kappa_bounds(omega, 0.4).back() == INFINITY);
+  cx_mat::fixed<3, 3> laguerre(fill::zeros);
+  IntegrationDiagnostics laguerre_diagnostics;
+  Greens.integrate_k(omega, laguerre, IM, weight_function,
+                     laguerre_diagnostics);
+
+  REQUIRE(!truncated.is_zero());
+  REQUIRE(laguerre_diagnostics.failures == 0);
+  REQUIRE(approx_equal(truncated, laguerre, "reldiff", 1E-6));
+  REQUIRE(laguerre_diagnostics.evaluations <
+          truncated_diagnostics.evaluations);
+}
+
+TEST_CASE("The plasmons are smeared by the Doppler shift",
+          "[GreensTensorPlate]") {
+  GreensTensorPlate Greens("../data/test_files/GreensTensorPlate.json");
+
+  // bulk and surface plasmon of the Drude permittivity, whose half-width
+  // gamma / 2 is increased by v / za
+  std::vector<CharacteristicFrequency> frequencies =
+      Greens.characteristic_frequencies();
+  REQUIRE(frequencies.size() == 2);
+  REQUIRE(frequencies[0].omega == 9);
+  REQUIRE(frequencies[1].omega == Approx(9 / std::sqrt(2)));
+  for (const CharacteristicFrequency &frequency : frequencies) {
+    REQUIRE(frequency.width == Approx(3.5E-2 / 2 + 1E-5 / 0.1).epsilon(1E-3));
+  }
+}
+
+TEST_CASE("The task-parallel pieces do not depend on the threads",
+          "[GreensTensorPlate]") {
+  auto omega = GENERATE(-0.3, 0.54, 3.0);
+  auto integrator = GENERATE(POINTWISE, VECTOR, BATCH);
+  GreensTensorPlate Greens("../data/test_files/GreensTensorPlate.json");
+  Greens.set_integrator(integrator);
+  REQUIRE(!Greens.get_task_parallel());
+
+  std::vector<GreensTensorRequest> requests = {{IM, KV_TEMP}, {RE, UNIT}};
+  std::vector<cx_mat::fixed<3, 3>> sequential;
+  Greens.integrate_k(omega, requests, sequential);
+
+  // the tasks are executed by the calling thread only and by a team
+  Greens.set_task_parallel(true);
+  std::vector<cx_mat::fixed<3, 3>> single, team;
+  IntegrationDiagnostics single_diagnostics, team_diagnostics;
+  {
+    IntegrationDiagnosticsScope scope(single_diagnostics);
+    Greens.integrate_k(omega, requests, single);
+  }
+#pragma omp parallel num_threads(3)
+#pragma omp single
+  {
+    IntegrationDiagnosticsScope scope(team_diagnostics);
+    Greens.integrate_k(omega, requests, team);
+  }
+
+  REQUIRE(team_diagnostics.evaluations == single_diagnostics.evaluations);
+  REQUIRE(team_diagnostics.calls == single_diagnostics.calls);
+  REQUIRE(team_diagnostics.result == single_diagnostics.result);
+  for (size_t i = 0; i < requests.size(); i++) {
+    REQUIRE(approx_equal(team[i], single[i], "absdiff", 0));
+    REQUIRE(approx_equal(team[i], sequential[i], "reldiff", 1E-5));
+  }
+}
+
+TEST_CASE("Several distances share the nodes of the integration",
+          "[GreensTensorPlate]") {
+  auto omega = GENERATE(-0.3, 0.54, 3.0);
+  auto integrator = GENERATE(POINTWISE, VECTOR, CUBATURE);
+  GreensTensorPlate Greens("../data/test_files/GreensTensorPlate.json");
+  Greens.set_integrator(integrator);
+
+  std::vector<GreensTensorRequest> requests = {{IM, KV_NON_LTE}, {RE, UNIT}};
+  std::vector<double> distances = {0.3, 0.1, 0.15};
+  std::vector<std::vector<cx_mat::fixed<3, 3>>> batch;
+  IntegrationDiagnostics batch_diagnostics;
+  {
+    IntegrationDiagnosticsScope scope(batch_diagnostics);
+    Greens.integrate_k(omega, requests, distances, batch);
+  }
+  REQUIRE(batch.size() == distances.size());
+
+  size_t separate_evaluations = 0;
+  for (size_t j = 0; j < distances.size(); j++) {
+    Greens.set_za(distances[j]);
+    std::vector<cx_mat::fixed<3, 3>> separate;
+    IntegrationDiagnostics diagnostics;
+    {
+      IntegrationDiagnosticsScope scope(diagnostics);
+      Greens.integrate_k(omega, requests, separate);
+    }
+    separate_evaluations += diagnostics.evaluations;
+
+    REQUIRE(batch[j].size() == requests.size());
+    for (size_t i = 0; i < requests.size(); i++) {
+      REQUIRE(!separate[i].is_zero());
+      // All distances share the cut-off of the closest one, which truncates
+      // the farther ones later than their own cut-off.
+      REQUIRE(approx_equal(batch[j][i], separate[i], "reldiff", 1E-4));
+    }
+  }
+
+  // the vector integration evaluates the kernel once for all distances
+  if (integrator == VECTOR) {
+    REQUIRE(batch_diagnostics.evaluations < separate_evaluations);
+  }
+}
+
+TEST_CASE("Requests at other temperatures yield the tensors of that "
+          "temperature",
+          "[GreensTensorPlate]") {
+  auto omega = GENERATE(-0.3, 0.54);
+  auto integrator = GENERATE(POINTWISE, VECTOR, BATCH, CUBATURE);
+  GreensTensorPlate Greens("../data/test_files/GreensTensorPlate.json");
+  Greens.set_integrator(integrator);
+
+  std::vector<double> betas = {Greens.get_beta(), 0.1 * Greens.get_beta()};
+  std::vector<GreensTensorRequest> requests = {{IM, UNIT}};
+  for (double beta : betas) {
+    requests.push_back({IM, KV_TEMP, beta});
+    requests.push_back({IM, NON_LTE, beta});
+  }
+  std::vector<cx_mat::fixed<3, 3>> bundle;
+  Greens.integrate_k(omega, requests, bundle);
+  REQUIRE(bundle.size() == requests.size());
+
+  for (size_t j = 0; j < betas.size(); j++) {
+    GreensTensorPlate other(Greens);
+    other.set_beta(betas[j]);
+    std::vector<cx_mat::fixed<3, 3>> separate;
+    other.integrate_k(omega, {{IM, UNIT}, {IM, KV_TEMP}, {IM, NON_LTE}},
+                      separate);
+
+    // the bundle splits the integration at the edge of the coldest
+    // temperature, hence the results agree within the accuracy
+    REQUIRE(approx_equal(bundle[0], separate[0], "reldiff", 1E-4));
+    REQUIRE(approx_equal(bundle[1 + 2 * j], separate[1], "reldiff", 1E-4));
+    REQUIRE(approx_equal(bundle[2 + 2 * j], separate[2], "reldiff", 1E-4));
+  }
+  REQUIRE(!approx_equal(bundle[2], bundle[4], "reldiff", 1E-2));
+}
+
+TEST_CASE("A copy with other parameters has their characteristic frequencies",
+          "[GreensTensorPlate]") {
+  auto perm = std::make_shared<PermittivityDrude>(9, 0.1);
+  auto refl = std::make_shared<ReflectionCoefficientsLocBulk>(perm);
+  vec::fixed<2> rel_err = {1E-8, 1E-6};
+  GreensTensorPlate Greens(1E-4, 1E6, 0.01, refl, 30, rel_err);
+
+  EvaluationParameters parameters = {2E-4, 0.05, 1E5};
+  REQUIRE(!Greens.has_parameters(parameters));
+  auto copy = Greens.with_parameters(parameters);
+  REQUIRE(copy->has_parameters(parameters));
+  GreensTensorPlate other(2E-4, 1E5, 0.05, refl, 30, rel_err);
+
+  // the cut-off delta_cut v / za follows the parameters, the original keeps
+  // its own
+  REQUIRE(copy->omega_ch() == other.omega_ch());
+  REQUIRE(copy->omega_ch() == Approx(30 * 2E-4 / 0.05));
+  REQUIRE(Greens.omega_ch() == Approx(30 * 1E-4 / 0.01));
+
+  // so does the smearing v / za of the plasmons
+  std::vector<CharacteristicFrequency> frequencies =
+      copy->characteristic_frequencies();
+  std::vector<CharacteristicFrequency> reference =
+      other.characteristic_frequencies();
+  std::vector<CharacteristicFrequency> own = Greens.characteristic_frequencies();
+  REQUIRE(frequencies.size() == reference.size());
+  for (size_t i = 0; i < frequencies.size(); i++) {
+    REQUIRE(frequencies[i].omega == reference[i].omega);
+    REQUIRE(frequencies[i].width == reference[i].width);
+    REQUIRE(frequencies[i].width == Approx(0.05 + 2E-4 / 0.05));
+    REQUIRE(own[i].width == Approx(0.05 + 1E-4 / 0.01));
+  }
+
+  // the tensors at the parameters are the ones of the other plate
+  std::vector<GreensTensorRequest> requests = {{IM, KV_TEMP}, {IM, NON_LTE}};
+  std::vector<cx_mat::fixed<3, 3>> tensors, separate;
+  Greens.integrate_k(0.1, parameters, requests, tensors);
+  other.integrate_k(0.1, requests, separate);
+  for (size_t i = 0; i < requests.size(); i++) {
+    REQUIRE(!tensors[i].is_zero());
+    REQUIRE(approx_equal(tensors[i], separate[i], "reldiff", 1E-12));
+  }
+  REQUIRE(Greens.get_za() == 0.01);
+}
@@ -0,0 +1,45 @@
+#include "Quaca.h"
+#include "catch.hpp"
+
+TEST_CASE("The Green's tensor record discards the least recently used "
+          "frequencies",
+          "[GreensTensorRecord]") {
+  GreensTensorRecord record(2);
+  REQUIRE(record.get_capacity() == 2);
+
+  GreensTensorIntegral integral;
+  integral.request = {IM, TEMP, 0};
+  integral.value.fill(0.);
+
+  std::vector<GreensTensorIntegral> found;
+  for (double omega : {0.1, 0.2}) {
+    integral.value(0, 0) = omega;
+    record.store(omega, {integral});
+  }
+  REQUIRE(record.get_size() == 2);
+
+  // the first frequency is used again, hence the second one is discarded
+  REQUIRE(record.find(0.1, found));
+  integral.value(0, 0) = 0.3;
+  record.store(0.3, {integral});
+  REQUIRE(record.get_size() == 2);
+  REQUIRE(!record.find(0.2, found));
+  REQUIRE(record.find(0.3, found));
+  REQUIRE(found.size() == 1);
+  REQUIRE(found[0].value(0, 0) == 0.3);
+  REQUIRE(record.find(0.1, found));
+  REQUIRE(found[0].value(0, 0) == 0.1);
+
+  // integrals of another request are added to a stored frequency
+  integral.request = {RE, NON_LTE, 0};
+  record.store(0.1, {integral});
+  REQUIRE(record.get_size() == 2);
+  REQUIRE(record.find(0.1, found));
+  REQUIRE(found.size() == 2);
+
+  REQUIRE(record.get_hits() == 4);
+  REQUIRE(record.get_misses() == 1);
+  record.clear();
+  REQUIRE(record.get_size() == 0);
+  REQUIRE(!record.find(0.1, found));
+}
@@ -113,8 +113,10 @@ TEST_CASE("Integrand 1d k is correctly implemented", "[GreensTensorVacuum]") {
   };
 
   SECTION("Option: IM, NON_LTE") {
-    double factor =
-        1. / (1. - exp(-beta * (omega_kv))) - 1. / (1. - exp(-beta * omega));
+    // the difference of the Bose-Einstein distributions written without the
+    // cancellation of the small shift v * k_v
+    double factor = -exp(-beta * omega_kv) * expm1(beta * v * k_v) /
+                    (expm1(-beta * omega_kv) * expm1(-beta * omega));
     for(size_t i = 0; i < 3; ++i) {
       for(size_t j = 0; j < 3; ++j) {
 	RHS(i,j) = Greens.integrand_k(k_v, omega, {i,j}, IM, NON_LTE);
@@ -132,6 +134,27 @@ TEST_CASE("Integrand 1d k is correctly implemented", "[GreensTensorVacuum]") {
  * Some basic relations any Green's tensor should fulfill which can
  * be found in docs under: Relations_and_num_results.pdf
  */
+TEST_CASE("The batch and the pointwise integrand_k coincide",
+          "[GreensTensorVacuum]") {
+  auto omega = GENERATE(-2.3, 0.4, 21.);
+  auto weight_function =
+      GENERATE(UNIT, KV, TEMP, KV_TEMP, NON_LTE, KV_NON_LTE);
+  GreensTensorVacuum Greens("../data/test_files/GreensTensorVacuum.json");
+
+  vec kv = {-1.7, -0.3, 0.2, 3.1, 15.};
+  mat batch;
+  Greens.integrand_k(kv, omega, batch, IM, weight_function);
+
+  for (uword i = 0; i < kv.n_elem; i++) {
+    REQUIRE(batch(i, 0) == Approx(Greens.integrand_k(kv(i), omega, {0, 0}, IM,
+                                                     weight_function))
+                               .epsilon(1E-12));
+    REQUIRE(batch(i, 1) == Approx(Greens.integrand_k(kv(i), omega, {1, 1}, IM,
+                                                     weight_function))
+                               .epsilon(1E-12));
+  }
+}
+
 TEST_CASE("Crossing relation in frequency domain see eq. [1]",
           "[GreensTensorVacuum]") {
   // Generate a Green's tensor with random attributes v and beta
@@ -331,4 +354,136 @@ TEST_CASE("Test the integration routine", "[GreensTensorVacuum]") {
 
     REQUIRE(approx_equal(num_result, ana_result, "reldiff", 10E-5));
   }
+
+  SECTION("The vector integrator yields the same tensor") {
+    auto omega = GENERATE(-1.2, 0.54);
+    auto weight_function = GENERATE(UNIT, KV, TEMP, KV_NON_LTE);
+    GreensTensorVacuum Greens("../data/test_files/GreensTensorVacuum.json");
+    REQUIRE(Greens.get_integrator() == POINTWISE);
+
+    cx_mat::fixed<3, 3> pointwise(fill::zeros);
+    cx_mat::fixed<3, 3> vector(fill::zeros);
+
+    Greens.integrate_k(omega, pointwise, IM, weight_function);
+    Greens.set_integrator(VECTOR);
+    Greens.integrate_k(omega, vector, IM, weight_function);
+
+    REQUIRE(!pointwise.is_zero());
+    REQUIRE(approx_equal(pointwise, vector, "reldiff", 1E-8));
+  }
+
+  SECTION("The batch integrator yields the same tensor") {
+    auto omega = GENERATE(-1.2, 0.54);
+    auto weight_function = GENERATE(UNIT, KV, TEMP, KV_NON_LTE);
+    GreensTensorVacuum Greens("../data/test_files/GreensTensorVacuum.json");
+
+    cx_mat::fixed<3, 3> pointwise(fill::zeros);
+    cx_mat::fixed<3, 3> batch(fill::zeros);
+
+    // both integrate the elements jointly on the same subdivision
+    Greens.set_integrator(VECTOR);
+    Greens.integrate_k(omega, pointwise, IM, weight_function);
+    Greens.set_integrator(BATCH);
+    Greens.integrate_k(omega, batch, IM, weight_function);
+
+    REQUIRE(!pointwise.is_zero());
+    REQUIRE(approx_equal(pointwise, batch, "reldiff", 1E-10));
+  }
+}
+
+TEST_CASE("A bundle of requests yields the separately integrated tensors",
+          "[GreensTensorVacuum]") {
+  auto omega = GENERATE(-1.32, 0.76);
+  auto integrator = GENERATE(POINTWISE, VECTOR, BATCH);
+  GreensTensorVacuum Greens(1e-2, 1.32, 1E-9);
+  Greens.set_integrator(integrator);
+
+  std::vector<GreensTensorRequest> requests = {
+      {IM, KV}, {IM, KV_TEMP}, {IM, NON_LTE}, {RE, UNIT}, {IM, UNIT}};
+  std::vector<cx_mat::fixed<3, 3>> bundle;
+  Greens.integrate_k(omega, requests, bundle);
+
+  REQUIRE(bundle.size() == requests.size());
+  for (size_t i = 0; i < requests.size(); i++) {
+    cx_mat::fixed<3, 3> separate(fill::zeros);
+    Greens.integrate_k(omega, separate, requests[i].fancy_complex,
+                       requests[i].weight_function);
+
+    REQUIRE(approx_equal(bundle[i], separate, "reldiff", 1E-8));
+  }
+}
+
+TEST_CASE("A block of frequencies yields the tensors of every frequency",
+          "[GreensTensorVacuum]") {
+  auto integrator = GENERATE(POINTWISE, VECTOR, BATCH);
+  GreensTensorVacuum Greens(1e-2, 1.32, 1E-9);
+  Greens.set_integrator(integrator);
+
+  std::vector<double> omegas = {-1.32, 0.2, 0.76, 3.1};
+  std::vector<GreensTensorRequest> requests = {
+      {IM, KV}, {IM, KV_TEMP}, {RE, UNIT}};
+  std::vector<std::vector<cx_mat::fixed<3, 3>>> block;
+  Greens.integrate_k_batch(omegas, requests, block);
+
+  REQUIRE(block.size() == omegas.size());
+  for (size_t j = 0; j < omegas.size(); j++) {
+    std::vector<cx_mat::fixed<3, 3>> single;
+    Greens.integrate_k(omegas[j], requests, single);
+    REQUIRE(block[j].size() == requests.size());
+    for (size_t i = 0; i < requests.size(); i++) {
+      REQUIRE(approx_equal(block[j][i], single[i], "reldiff", 1E-14));
+    }
+  }
+}
+
+TEST_CASE("A bundle of requests at other temperatures yields their tensors",
+          "[GreensTensorVacuum]") {
+  auto omega = GENERATE(-1.32, 0.76);
+  auto integrator = GENERATE(POINTWISE, VECTOR, BATCH);
+  GreensTensorVacuum Greens(1e-2, 1.32, 1E-9);
+  Greens.set_integrator(integrator);
+
+  std::vector<GreensTensorRequest> requests = {
+      {IM, KV_TEMP, 0.5}, {IM, NON_LTE, 0.5}, {IM, KV_NON_LTE, 3.}};
+  std::vector<cx_mat::fixed<3, 3>> bundle;
+  Greens.integrate_k(omega, requests, bundle);
+
+  REQUIRE(bundle.size() == requests.size());
+  for (size_t i = 0; i < requests.size(); i++) {
+    GreensTensorVacuum other(1e-2, requests[i].beta, 1E-9);
+    cx_mat::fixed<3, 3> separate(fill::zeros);
+    other.integrate_k(omega, separate, requests[i].fancy_complex,
+                      requests[i].weight_function);
+
+    REQUIRE(approx_equal(bundle[i], separate, "reldiff", 1E-8));
+  }
+}
+
+TEST_CASE("The parameters of an evaluation replace the own ones",
+          "[GreensTensorVacuum]") {
+  auto omega = GENERATE(-1.32, 0.76);
+  auto integrator = GENERATE(POINTWISE, VECTOR, BATCH);
+  GreensTensorVacuum Greens(1e-2, 1.32, 1E-9);
+  Greens.set_integrator(integrator);
+
+  EvaluationParameters parameters = {3e-2, NAN, 0.5};
+  REQUIRE(Greens.has_parameters({1e-2, NAN, 1.32}));
+  REQUIRE(!Greens.has_parameters(parameters));
+
+  std::vector<GreensTensorRequest> requests = {
+      {IM, KV}, {IM, KV_TEMP}, {IM, NON_LTE}};
+  std::vector<cx_mat::fixed<3, 3>> bundle;
+  Greens.integrate_k(omega, parameters, requests, bundle);
+
+  // the Green's tensor itself keeps its parameters
+  REQUIRE(Greens.get_v() == 1e-2);
+  REQUIRE(Greens.get_beta() == 1.32);
+
+  GreensTensorVacuum other(3e-2, 0.5, 1E-9);
+  other.set_integrator(integrator);
+  std::vector<cx_mat::fixed<3, 3>> reference;
+  other.integrate_k(omega, requests, reference);
+  for (size_t i = 0; i < requests.size(); i++) {
+    REQUIRE(approx_equal(bundle[i], reference[i], "reldiff", 1E-14));
+  }
 }
@@ -0,0 +1,49 @@
+#include "Quaca.h"
+#include "catch.hpp"
+
+TEST_CASE("LooperBeta constructors work as expected", "[LooperBeta]") {
+  SECTION("Direct constructor") {
+    LooperBeta looper(1., 100., 5, "log");
+
+    REQUIRE(looper.get_steps_total() == 5);
+    REQUIRE(looper.get_step(0) == Approx(1.));
+    REQUIRE(looper.get_step(4) == Approx(100.));
+    REQUIRE(looper.get_batch() == 1);
+  }
+
+  SECTION("Factory creates the looper of the json file") {
+    auto looper = LooperFactory::create("../data/test_files/LooperBeta.json");
+    auto looper_beta = std::dynamic_pointer_cast<LooperBeta>(looper);
+    REQUIRE(looper_beta != nullptr);
+    REQUIRE(looper_beta->get_steps_total() == 3);
+    REQUIRE(looper_beta->get_step(1) == Approx(10.));
+    REQUIRE(looper_beta->get_batch() == 3);
+  }
+}
+
+TEST_CASE("Batches of temperatures equal the single temperatures",
+          "[LooperBeta]") {
+  auto friction =
+      std::make_shared<Friction>("../data/test_files/FrictionVacuum.json");
+  LooperBeta single(1., 20., 3, "log");
+  LooperBeta batch(1., 20., 3, "log", 2);
+
+  REQUIRE(single.get_batches_total() == 3);
+  REQUIRE(batch.get_batches_total() == 2);
+  REQUIRE(batch.get_batch_first(1) == 2);
+
+  // every batch is calculated by a single call, the last one holds the
+  // remaining step
+  vec first = batch.calculate_batch(0, friction);
+  vec last = batch.calculate_batch(1, friction);
+  REQUIRE(first.n_elem == 2);
+  REQUIRE(last.n_elem == 1);
+  std::vector<double> batched = {first(0), first(1), last(0)};
+  for (size_t i = 0; i < batched.size(); i++) {
+    double reference = single.calculate_value(i, friction);
+    REQUIRE(batched[i] != 0);
+    REQUIRE(batched[i] == Approx(reference).epsilon(1E-2));
+    REQUIRE(single.calculate_batch(i, friction)(0) == reference);
+  }
+  REQUIRE(last(0) == batch.calculate_value(2, friction));
+}
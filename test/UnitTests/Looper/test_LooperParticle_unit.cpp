@@ -0,0 +1,81 @@
+#include "Quaca.h"
+#include "catch.hpp"
+
+TEST_CASE("Particle loopers are constructed as expected", "[LooperParticle]") {
+  SECTION("Direct constructors") {
+    LooperOmegaA omega_a(1., 2., 5, "linear");
+    LooperAlphaZero alpha_zero(1e-9, 1e-7, 3, "log");
+    LooperGamma gamma(0.1, 0.3, 3, "linear");
+
+    REQUIRE(omega_a.get_steps_total() == 5);
+    REQUIRE(omega_a.get_step(4) == Approx(2.));
+    REQUIRE(alpha_zero.get_step(1) == Approx(1e-8));
+    REQUIRE(gamma.get_step(1) == Approx(0.2));
+    REQUIRE(gamma.get_greens_record() != nullptr);
+    REQUIRE(gamma.get_greens_record()->get_size() == 0);
+    REQUIRE(omega_a.changes_friction());
+  }
+
+  SECTION("Factory creates the looper of the json file") {
+    auto looper =
+        LooperFactory::create("../data/test_files/LooperAlphaZero.json");
+    REQUIRE(std::dynamic_pointer_cast<LooperAlphaZero>(looper) != nullptr);
+    REQUIRE(looper->get_steps_total() == 3);
+    REQUIRE(looper->get_step(2) == Approx(1e-7));
+  }
+}
+
+TEST_CASE("Particle loopers reuse the integrals of the Green's tensor",
+          "[LooperParticle]") {
+  auto greens = std::make_shared<GreensTensorVacuum>(0.01, 5., 1E-9);
+  auto mu = std::make_shared<OhmicMemoryKernel>(0.1);
+  auto polarizability =
+      std::make_shared<Polarizability>(1.3, 6e-9, mu, greens);
+  auto powerspectrum = std::make_shared<PowerSpectrum>(greens, polarizability);
+  auto friction = std::make_shared<Friction>(greens, polarizability,
+                                             powerspectrum, 1E-1);
+
+  // the friction of the particle with the given parameters computed without
+  // a record
+  auto reference = [&](double omega_a, double alpha_zero, double gamma,
+                       std::vector<double> breakpoints = {}) -> double {
+    auto pol = std::make_shared<Polarizability>(
+        omega_a, alpha_zero, std::make_shared<OhmicMemoryKernel>(gamma),
+        greens);
+    auto ps = std::make_shared<PowerSpectrum>(greens, pol);
+    Friction fric(greens, pol, ps, 1E-1);
+    fric.set_omega_breakpoints(breakpoints);
+    return fric.calculate(NON_LTE_ONLY);
+  };
+
+  SECTION("alpha_zero") {
+    LooperAlphaZero looper(1e-9, 1e-7, 4, "log");
+    for (int i = 0; i < looper.get_steps_total(); i++) {
+      double result = looper.calculate_value(i, friction);
+      REQUIRE(result == reference(1.3, looper.get_step(i), 0.1));
+    }
+    REQUIRE(looper.get_greens_record()->get_hits() >
+            looper.get_greens_record()->get_misses());
+  }
+
+  SECTION("gamma") {
+    LooperGamma looper(0.05, 0.2, 4, "linear");
+    for (int i = 0; i < looper.get_steps_total(); i++) {
+      double result = looper.calculate_value(i, friction);
+      REQUIRE(result == reference(1.3, 6e-9, looper.get_step(i)));
+    }
+    REQUIRE(looper.get_greens_record()->get_hits() >
+            looper.get_greens_record()->get_misses());
+  }
+
+  SECTION("omega_a") {
+    LooperOmegaA looper(1.2, 1.4, 4, "linear");
+    for (int i = 0; i < looper.get_steps_total(); i++) {
+      double result = looper.calculate_value(i, friction);
+      REQUIRE(result == reference(looper.get_step(i), 6e-9, 0.1,
+                                  {0.99 * 1.2, 1.001 * 1.4}));
+    }
+    // only the subintervals away from the resonances are shared
+    REQUIRE(looper.get_greens_record()->get_hits() > 0);
+  }
+}
@@ -1,5 +1,6 @@
 #include "Quaca.h"
 #include "catch.hpp"
+#include <omp.h>
 
 TEST_CASE("LooperV constructors work as expected", "[LooperV]") {
   SECTION("Direct constructor") {
@@ -55,3 +56,44 @@ TEST_CASE("LooperV Steps are calculated correctly", "[LooperV]") {
     REQUIRE(looper.get_step(3) == Approx(end));
   }
 }
+
+TEST_CASE("LooperV leaves the friction unchanged", "[LooperV]") {
+  auto friction =
+      std::make_shared<Friction>("../data/test_files/FrictionVacuum.json");
+  LooperV looper(0.01, 0.02, 2, "linear");
+  REQUIRE(!looper.changes_friction());
+
+  double value = looper.calculate_value(1, friction);
+  REQUIRE(friction->get_greens_tensor()->get_v() == 0.01);
+
+  auto reference =
+      std::make_shared<Friction>("../data/test_files/FrictionVacuum.json");
+  reference->get_greens_tensor()->set_v(0.02);
+  REQUIRE(value != 0);
+  REQUIRE(value == Approx(reference->calculate(NON_LTE_ONLY)).epsilon(1E-12));
+}
+
+TEST_CASE("Threads share a single friction", "[LooperV]") {
+  auto friction =
+      std::make_shared<Friction>("../data/test_files/FrictionVacuum.json");
+  LooperV looper(0.01, 0.03, 3, "linear");
+  int steps = looper.get_steps_total();
+  std::vector<double> sequential(steps);
+  for (int i = 0; i < steps; i++) {
+    sequential[i] = looper.calculate_value(i, friction);
+  }
+
+  // every step is calculated twice, such that the threads evaluate the same
+  // and different steps at the same time
+  std::vector<double> parallel(2 * steps);
+#pragma omp parallel for schedule(dynamic) num_threads(3)
+  for (int i = 0; i < 2 * steps; i++) {
+    parallel[i] = looper.calculate_value(i % steps, friction);
+  }
+
+  for (int i = 0; i < 2 * steps; i++) {
+    REQUIRE(parallel[i] != 0);
+    REQUIRE(parallel[i] == sequential[i % steps]);
+  }
+  REQUIRE(friction->get_greens_tensor()->get_v() == 0.01);
+}
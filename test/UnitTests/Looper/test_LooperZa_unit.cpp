@@ -21,6 +21,12 @@ TEST_CASE("LooperZa constructors work as expected", "[LooperZa]") {
     REQUIRE(looper.get_steps_total() == 20);
     REQUIRE(looper.get_step(0) == 10.2);
     REQUIRE(looper.get_step(19) == 35.5);
+    REQUIRE(looper.get_batch() == 1);
+  }
+
+  SECTION("Batches of distances") {
+    LooperZa looper(0.1, 0.2, 5, "linear", 2);
+    REQUIRE(looper.get_batch() == 2);
   }
 }
 
@@ -53,3 +59,34 @@ TEST_CASE("LooperZa Steps are calculated correctly", "[LooperZa]") {
     REQUIRE(looper.get_step(3) == Approx(end));
   }
 }
+
+TEST_CASE("LooperZa leaves the friction unchanged", "[LooperZa]") {
+  // the plate of the analytical low-velocity result
+  vec::fixed<2> rel_err = {1E-6, 1E-4};
+  auto perm = std::make_shared<PermittivityDrude>(9., 0.1);
+  auto refl = std::make_shared<ReflectionCoefficientsLocBulk>(perm);
+  auto greens = std::make_shared<GreensTensorPlate>(1E-4, 1E6, 0.01, refl,
+                                                    30., rel_err);
+  greens->set_integrator(VECTOR);
+  auto alpha = std::make_shared<Polarizability>(1.3, 6e-9, greens);
+  auto friction = std::make_shared<Friction>(
+      greens, alpha, std::make_shared<PowerSpectrum>(greens, alpha), 1E-2);
+
+  LooperZa looper(0.01, 0.02, 2, "linear");
+  REQUIRE(looper.get_batch() == 1);
+  REQUIRE(!looper.changes_friction());
+  double value = looper.calculate_value(1, friction);
+  REQUIRE(greens->get_za() == 0.01);
+
+  // the same plate moved to the distance of the step
+  auto reference_greens = std::make_shared<GreensTensorPlate>(*greens);
+  reference_greens->set_za(0.02);
+  auto reference_alpha =
+      std::make_shared<Polarizability>(1.3, 6e-9, reference_greens);
+  Friction reference(
+      reference_greens, reference_alpha,
+      std::make_shared<PowerSpectrum>(reference_greens, reference_alpha),
+      1E-2);
+  REQUIRE(value != 0);
+  REQUIRE(value == Approx(reference.calculate(NON_LTE_ONLY)).epsilon(1E-12));
+}
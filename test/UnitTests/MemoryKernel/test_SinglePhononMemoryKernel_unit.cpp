@@ -26,3 +26,13 @@ TEST_CASE("SinglePhonon memory kernel obeys crossing relation",
   SinglePhononMemoryKernel mk("../data/test_files/SinglePhononMemoryKernel.json");
   REQUIRE(mk.calculate(1.0) == std::conj(mk.calculate(-1.0)));
 }
+
+TEST_CASE("SinglePhonon memory kernel reports the phonon resonance",
+          "[SinglePhononMemoryKernel]") {
+  SinglePhononMemoryKernel mk("../data/test_files/SinglePhononMemoryKernel.json");
+  std::vector<CharacteristicFrequency> frequencies =
+      mk.characteristic_frequencies();
+  REQUIRE(frequencies.size() == 1);
+  REQUIRE(frequencies[0].omega == 4.34);
+  REQUIRE(frequencies[0].width == 0.5E-5);
+}
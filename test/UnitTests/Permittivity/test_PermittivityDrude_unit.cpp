@@ -25,3 +25,43 @@ TEST_CASE("Drude permittivity obeys crossing relation", "[PermittivityDrude]") {
   REQUIRE(perm.calculate(omega) == std::conj(perm.calculate(-omega)));
   REQUIRE(perm.calculate_times_omega(omega) == -std::conj(perm.calculate_times_omega(-omega)));
 };
+
+TEST_CASE("Drude permittivity reports its resonances", "[PermittivityDrude]") {
+  PermittivityDrude perm(9, 0);
+
+  auto epsilon = GENERATE(-8.3, -1., -0.12, 0.5);
+  std::vector<double> resonances = perm.resonances(epsilon);
+  REQUIRE(resonances.size() == 1);
+  REQUIRE(perm.calculate(resonances[0]).real() == Approx(epsilon));
+
+  REQUIRE(perm.resonances(1.).empty());
+  REQUIRE(perm.resonances(2.3).empty());
+}
+
+TEST_CASE("Drude permittivity reports its characteristic frequencies",
+          "[PermittivityDrude]") {
+  PermittivityDrude perm(9, 0.1);
+
+  // the bulk plasmon with the half-width gamma / 2
+  std::vector<CharacteristicFrequency> frequencies =
+      perm.characteristic_frequencies();
+  REQUIRE(frequencies.size() == 1);
+  REQUIRE(frequencies[0].omega == 9);
+  REQUIRE(frequencies[0].width == 0.05);
+
+  // the surface plasmon has the same half-width
+  REQUIRE(perm.linewidth(perm.resonances(-1.)[0]) == 0.05);
+}
+
+TEST_CASE("Drude permittivity linewidth agrees with the numerical estimate",
+          "[PermittivityDrude]") {
+  auto gamma = GENERATE(1E-3, 1E-2, 0.1);
+  PermittivityDrude perm(9, gamma);
+
+  // the estimate from the slope of the real part at the resonances
+  auto epsilon = GENERATE(-8.3, -1., 0.);
+  double omega = perm.resonances(epsilon)[0];
+  REQUIRE(perm.linewidth(omega) == 0.5 * gamma);
+  REQUIRE(perm.Permittivity::linewidth(omega) ==
+          Approx(perm.linewidth(omega)).epsilon(1E-2));
+}
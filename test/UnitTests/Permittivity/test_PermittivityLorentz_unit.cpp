@@ -38,3 +38,43 @@ TEST_CASE("Lorentz permittivity obeys crossing relation",
   REQUIRE(perm.calculate(omega) == std::conj(perm.calculate(-omega)));
   REQUIRE(perm.calculate_times_omega(omega) == -std::conj(perm.calculate_times_omega(-omega)));
 }
+
+TEST_CASE("Lorentz permittivity reports its resonances",
+          "[PermittivityLorentz]") {
+  auto mu = std::make_shared<OhmicMemoryKernel>(0.);
+  PermittivityLorentz perm(2.1, 3.4, 3.7, mu);
+
+  auto epsilon = GENERATE(-5.3, -1., 0.5, 8.3);
+  std::vector<double> resonances = perm.resonances(epsilon);
+  REQUIRE(resonances.size() == 1);
+  REQUIRE(perm.calculate(resonances[0]).real() == Approx(epsilon));
+}
+
+TEST_CASE("Lorentz permittivity reports its characteristic frequencies",
+          "[PermittivityLorentz]") {
+  auto mu = std::make_shared<SinglePhononMemoryKernel>(0.2, 1E-2, 4.34, 1E-5);
+  PermittivityLorentz perm(2.1, 3.4, 3.7, mu);
+
+  // the resonance at omega_0 followed by the one of the memory kernel
+  std::vector<CharacteristicFrequency> frequencies =
+      perm.characteristic_frequencies();
+  REQUIRE(frequencies.size() == 2);
+  REQUIRE(frequencies[0].omega == 3.7);
+  REQUIRE(frequencies[0].width == Approx(0.5 * mu->calculate(3.7).real()));
+  REQUIRE(frequencies[1].omega == 4.34);
+  REQUIRE(frequencies[1].width == 0.5E-2);
+}
+
+TEST_CASE("Lorentz permittivity linewidth agrees with the numerical estimate",
+          "[PermittivityLorentz]") {
+  auto gamma = GENERATE(1E-3, 1E-2);
+  auto mu = std::make_shared<OhmicMemoryKernel>(gamma);
+  PermittivityLorentz perm(2.1, 3.4, 3.7, mu);
+
+  // the estimate from the slope of the real part at the resonances
+  auto epsilon = GENERATE(-5.3, -1., 0.5);
+  double omega = perm.resonances(epsilon)[0];
+  REQUIRE(perm.linewidth(omega) == 0.5 * gamma);
+  REQUIRE(perm.Permittivity::linewidth(omega) ==
+          Approx(perm.linewidth(omega)).epsilon(1E-2));
+}
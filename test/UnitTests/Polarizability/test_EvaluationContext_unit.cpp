@@ -0,0 +1,74 @@
+#include "Quaca.h"
+#include "catch.hpp"
+
+TEST_CASE("Announced integrals are integrated in a single pass",
+          "[EvaluationContext]") {
+  double omega = GENERATE(-0.7, 1.3);
+  GreensTensorVacuum greens(0.01, 5., 1E-9);
+
+  EvaluationContext context(omega);
+  context.request(greens, {{RE, UNIT}, {IM, KV}});
+  const cx_mat::fixed<3, 3> &greens_R = context.greens(greens, RE, UNIT);
+  const cx_mat::fixed<3, 3> &greens_I = context.greens(greens, IM, KV);
+  REQUIRE(context.get_passes() == 1);
+
+  // a request that has not been announced needs another pass, which leaves
+  // the stored integrals untouched
+  cx_mat::fixed<3, 3> direct;
+  greens.integrate_k(omega, direct, IM, UNIT);
+  REQUIRE(approx_equal(context.greens(greens, IM, UNIT), direct, "reldiff",
+                       1E-12));
+  REQUIRE(context.get_passes() == 2);
+
+  greens.integrate_k(omega, direct, RE, UNIT);
+  REQUIRE(approx_equal(greens_R, direct, "reldiff", 1E-12));
+  greens.integrate_k(omega, direct, IM, KV);
+  REQUIRE(approx_equal(greens_I, direct, "reldiff", 1E-12));
+  REQUIRE(context.get_passes() == 2);
+}
+
+TEST_CASE("All parts of the polarizability follow from one evaluation",
+          "[EvaluationContext]") {
+  double omega = GENERATE(0.5, 1.3, 2.);
+  Polarizability pol("../data/test_files/PolarizabilityBath.json");
+
+  EvaluationContext context(omega);
+  cx_mat::fixed<3, 3> alpha, alpha_R, alpha_I;
+  pol.calculate_tensor(context, alpha_I, IM);
+  pol.calculate_tensor(context, alpha_R, RE);
+  pol.calculate_tensor(context, alpha, COMPLEX);
+  REQUIRE(context.get_passes() == 1);
+  REQUIRE(context.find_alpha(pol) != nullptr);
+
+  cx_mat::fixed<3, 3> direct;
+  pol.calculate_tensor(omega, direct, COMPLEX);
+  REQUIRE(approx_equal(alpha, direct, "reldiff", 1E-12));
+  pol.calculate_tensor(omega, direct, IM);
+  REQUIRE(approx_equal(alpha_I, direct, "reldiff", 1E-12));
+  pol.calculate_tensor(omega, direct, RE);
+  REQUIRE(approx_equal(alpha_R, direct, "reldiff", 1E-12));
+
+  std::complex<double> I(0.0, 1.0);
+  REQUIRE(approx_equal(cx_mat(alpha_R + I * alpha_I), cx_mat(alpha), "reldiff",
+                       1E-12));
+}
+
+TEST_CASE("The friction integrand needs a single pass for a shared Green's "
+          "tensor",
+          "[EvaluationContext]") {
+  double omega = GENERATE(0.3, 1.3);
+  Spectrum_Options spectrum = GENERATE(FULL, NON_LTE_ONLY);
+  Friction friction("../data/test_files/FrictionVacuum.json");
+
+  EvaluationContext context(omega);
+  double result = friction.friction_integrand(context, spectrum);
+  REQUIRE(context.get_passes() == 1);
+  REQUIRE(result == friction.friction_integrand(omega, spectrum));
+
+  // the power spectrum reuses the stored integrals
+  cx_mat::fixed<3, 3> powerspectrum, direct;
+  friction.get_powerspectrum()->calculate(context, powerspectrum, spectrum);
+  friction.get_powerspectrum()->calculate(omega, direct, spectrum);
+  REQUIRE(context.get_passes() == 1);
+  REQUIRE(approx_equal(powerspectrum, direct, "reldiff", 1E-12));
+}
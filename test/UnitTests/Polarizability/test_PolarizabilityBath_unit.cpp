@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <armadillo>
 #include <complex>
 
@@ -66,3 +67,34 @@ TEST_CASE("PolarizabilityBath integrand works as expected",
 
   REQUIRE(approx_equal(alpha, alpha_int, "reldiff", 1e-6));
 }
+
+TEST_CASE("PolarizabilityBath splits omega integrations at its resonances",
+          "[PolarizabilityBath]") {
+  auto greens = std::make_shared<GreensTensorPlate>(
+      "../data/test_files/GreensTensorPlate.json");
+  auto mu = std::make_shared<SinglePhononMemoryKernel>(0.2, 1E-2, 4.34, 1E-5);
+  Polarizability pol(1.3, 6E-9, mu, greens);
+
+  // the resonance window of the particle, the phonon of the memory kernel
+  // and the surface and bulk plasmons of the plate
+  std::vector<double> breakpoints = pol.omega_breakpoints(0, INFINITY);
+  REQUIRE(std::is_sorted(breakpoints.begin(), breakpoints.end()));
+  std::vector<double> expected = {0.99 * 1.3, 1.001 * 1.3, 4.34 - 0.5E-2,
+                                  4.34 + 0.5E-2};
+  for (const CharacteristicFrequency &frequency :
+       greens->characteristic_frequencies()) {
+    expected.push_back(frequency.omega - frequency.width);
+    expected.push_back(frequency.omega + frequency.width);
+  }
+  REQUIRE(breakpoints.size() == expected.size());
+  for (double omega : expected) {
+    REQUIRE(std::find(breakpoints.begin(), breakpoints.end(), omega) !=
+            breakpoints.end());
+  }
+
+  // only the breakpoints within the integration domain are used
+  breakpoints = pol.omega_breakpoints(1.29, 4.34);
+  REQUIRE(breakpoints.size() == 2);
+  REQUIRE(breakpoints[0] == 1.001 * 1.3);
+  REQUIRE(breakpoints[1] == 4.34 - 0.5E-2);
+}
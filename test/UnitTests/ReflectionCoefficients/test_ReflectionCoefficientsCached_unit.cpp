@@ -0,0 +1,87 @@
+#include "Quaca.h"
+#include "catch.hpp"
+#include <complex>
+
+TEST_CASE("ReflectionCoefficientsCached constructors work as expected",
+          "[ReflectionCoefficientsCached]") {
+
+  SECTION("Direct constructor") {
+    auto perm = std::make_shared<PermittivityDrude>(3.5E-2, 9);
+    auto refl = std::make_shared<ReflectionCoefficientsLocBulk>(perm);
+    ReflectionCoefficientsCached RefC(refl, 100);
+
+    REQUIRE(RefC.get_reflection_coefficients() == refl);
+    REQUIRE(RefC.get_capacity() == 100);
+    REQUIRE(RefC.get_size() == 0);
+  }
+
+  SECTION("Factory wraps the coefficients of the json file") {
+    auto RefC = ReflectionCoefficientsFactory::create(
+        "../data/test_files/ReflectionCached.json");
+    auto cached =
+        std::dynamic_pointer_cast<ReflectionCoefficientsCached>(RefC);
+
+    REQUIRE(cached != nullptr);
+    REQUIRE(cached->get_capacity() == 1000);
+    REQUIRE(std::dynamic_pointer_cast<ReflectionCoefficientsLocBulk>(
+                cached->get_reflection_coefficients()) != nullptr);
+  }
+
+  SECTION("Configuration hands the same cache to all models") {
+    Configuration configuration("../data/test_files/ReflectionCached.json");
+    auto RefC = ReflectionCoefficientsFactory::create(configuration);
+    REQUIRE(ReflectionCoefficientsFactory::create(configuration) != RefC);
+
+    Configuration shared = configuration.with_reflection_coefficients(RefC);
+    REQUIRE(configuration.get_reflection_coefficients() == nullptr);
+    REQUIRE(ReflectionCoefficientsFactory::create(shared) == RefC);
+    REQUIRE(ReflectionCoefficientsFactory::create(shared) == RefC);
+  }
+}
+
+TEST_CASE("Cached coefficients equal the exact ones and are reused",
+          "[ReflectionCoefficientsCached]") {
+  auto omega = GENERATE(-2.1, 0.37, 6.36);
+  std::complex<double> kappa = GENERATE(std::complex<double>(0., -0.2),
+                                        std::complex<double>(12.5, 0.));
+
+  auto perm = std::make_shared<PermittivityDrude>(3.5E-2, 9);
+  auto refl = std::make_shared<ReflectionCoefficientsLocSlab>(perm, 0.05);
+  ReflectionCoefficientsCached RefC(refl, 100);
+
+  std::complex<double> rp_exact, rs_exact;
+  refl->calculate(omega, kappa, rp_exact, rs_exact);
+
+  for (int i = 0; i < 3; i++) {
+    std::complex<double> rp, rs;
+    RefC.calculate(omega, kappa, rp, rs);
+    REQUIRE(rp == rp_exact);
+    REQUIRE(rs == rs_exact);
+  }
+  REQUIRE(RefC.get_misses() == 1);
+  REQUIRE(RefC.get_hits() == 2);
+  REQUIRE(RefC.get_size() == 1);
+
+  RefC.clear();
+  REQUIRE(RefC.get_size() == 0);
+  REQUIRE(RefC.get_hits() == 0);
+  REQUIRE(RefC.get_misses() == 0);
+}
+
+TEST_CASE("The cache does not exceed its capacity",
+          "[ReflectionCoefficientsCached]") {
+  auto perm = std::make_shared<PermittivityDrude>(3.5E-2, 9);
+  auto refl = std::make_shared<ReflectionCoefficientsLocBulk>(perm);
+  ReflectionCoefficientsCached RefC(refl, 64);
+
+  std::complex<double> rp, rs;
+  for (int i = 0; i < 1000; i++) {
+    RefC.calculate(1. + 1E-3 * i, 2., rp, rs);
+  }
+  REQUIRE(RefC.get_size() <= 64);
+  REQUIRE(RefC.get_misses() == 1000);
+
+  // the most recent entry is still stored
+  RefC.calculate(1. + 1E-3 * 999, 2., rp, rs);
+  REQUIRE(RefC.get_hits() == 1);
+}
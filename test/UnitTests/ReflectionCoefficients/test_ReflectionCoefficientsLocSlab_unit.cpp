@@ -79,3 +79,29 @@ TEST_CASE("r_p and r_s of the slab configuration obey the crossing relation",
   REQUIRE(rp_lhs.real() == rp_rhs.real());
   REQUIRE(rs_lhs.imag() == -rs_rhs.imag());
 }
+
+TEST_CASE("The slab reports its hybridized modes as characteristic frequencies",
+          "[ReflectionCoefficientsLocSlab]") {
+  auto perm = std::make_shared<PermittivityDrude>(9, 0.1);
+  double thickness = 0.05;
+  ReflectionCoefficientsLocSlab RefC(perm, thickness);
+
+  // the bulk plasmon, the two modes at kappa = 1 / thickness and the surface
+  // plasmon, all with the width of the permittivity
+  std::vector<CharacteristicFrequency> frequencies =
+      RefC.characteristic_frequencies();
+  std::vector<double> modes = RefC.resonances(1. / thickness);
+  REQUIRE(modes.size() == 2);
+  REQUIRE(frequencies.size() == 4);
+  REQUIRE(frequencies[0].omega == 9);
+  REQUIRE(frequencies[1].omega == modes[0]);
+  REQUIRE(frequencies[2].omega == modes[1]);
+  REQUIRE(frequencies[3].omega == Approx(9 / std::sqrt(2)));
+  for (const CharacteristicFrequency &frequency : frequencies) {
+    REQUIRE(frequency.width == 0.05);
+  }
+
+  // the modes are split around the surface plasmon
+  REQUIRE(modes[0] < frequencies[3].omega);
+  REQUIRE(modes[1] > frequencies[3].omega);
+}
@@ -0,0 +1,81 @@
+#include "Quaca.h"
+#include "catch.hpp"
+#include <complex>
+
+TEST_CASE("ReflectionCoefficientsTabulated constructors work as expected",
+          "[ReflectionCoefficientsTabulated]") {
+
+  SECTION("Direct constructor") {
+    auto perm = std::make_shared<PermittivityDrude>(3.5E-2, 9);
+    auto refl = std::make_shared<ReflectionCoefficientsLocBulk>(perm);
+    ReflectionCoefficientsTabulated RefC(refl, 0, 10, 50, 1E-6);
+
+    REQUIRE(RefC.get_reflection_coefficients() == refl);
+    REQUIRE(RefC.get_omega_min() == 0);
+    REQUIRE(RefC.get_omega_max() == 10);
+    REQUIRE(RefC.get_kappa_max() == 50);
+    REQUIRE(RefC.get_accuracy() == 1E-6);
+    REQUIRE(RefC.get_leaves() > 0);
+  }
+
+  SECTION("Factory wraps the coefficients of the json file") {
+    auto RefC = ReflectionCoefficientsFactory::create(
+        "../data/test_files/ReflectionTabulated.json");
+    auto tabulated =
+        std::dynamic_pointer_cast<ReflectionCoefficientsTabulated>(RefC);
+
+    REQUIRE(tabulated != nullptr);
+    REQUIRE(tabulated->get_omega_min() == 0);
+    REQUIRE(tabulated->get_omega_max() == 20);
+    REQUIRE(tabulated->get_kappa_max() == 100);
+    REQUIRE(tabulated->get_accuracy() == 1E-8);
+    REQUIRE(std::dynamic_pointer_cast<ReflectionCoefficientsLocSlab>(
+                tabulated->get_reflection_coefficients()) != nullptr);
+  }
+}
+
+TEST_CASE("Tabulated coefficients reproduce the exact ones",
+          "[ReflectionCoefficientsTabulated]") {
+  auto omega = GENERATE(-8.73, -1.2E-3, 0.37, 6.36, 9.99);
+  auto kappa_double = GENERATE(-0.9, -0.31, 1E-4, 0.12, 2.5, 47.3);
+
+  // propagating waves are given as fraction of omega
+  std::complex<double> kappa;
+  if (kappa_double < 0.) {
+    kappa = std::complex<double>(0., kappa_double * std::abs(omega));
+  } else {
+    kappa = std::complex<double>(kappa_double, 0.);
+  }
+
+  auto perm = std::make_shared<PermittivityDrude>(3.5E-2, 9);
+  auto refl = std::make_shared<ReflectionCoefficientsLocSlab>(perm, 0.05);
+  double accuracy = 1E-6;
+  ReflectionCoefficientsTabulated RefC(refl, 0, 10, 50, accuracy);
+
+  std::complex<double> rp, rs, rp_exact, rs_exact;
+  RefC.calculate(omega, kappa, rp, rs);
+  refl->calculate(omega, kappa, rp_exact, rs_exact);
+
+  REQUIRE(std::abs(rp - rp_exact) <=
+          10 * accuracy * std::max(std::abs(rp_exact), 1.));
+  REQUIRE(std::abs(rs - rs_exact) <=
+          10 * accuracy * std::max(std::abs(rs_exact), 1.));
+}
+
+TEST_CASE("Outside of the table the exact coefficients are returned",
+          "[ReflectionCoefficientsTabulated]") {
+  auto omega = GENERATE(-12.3, 15.1);
+  std::complex<double> kappa = GENERATE(std::complex<double>(60., 0.),
+                                        std::complex<double>(0., -20.));
+
+  auto perm = std::make_shared<PermittivityDrude>(3.5E-2, 9);
+  auto refl = std::make_shared<ReflectionCoefficientsLocBulk>(perm);
+  ReflectionCoefficientsTabulated RefC(refl, 0, 10, 50, 1E-6);
+
+  std::complex<double> rp, rs, rp_exact, rs_exact;
+  RefC.calculate(omega, kappa, rp, rs);
+  refl->calculate(omega, kappa, rp_exact, rs_exact);
+
+  REQUIRE(rp == rp_exact);
+  REQUIRE(rs == rs_exact);
+}
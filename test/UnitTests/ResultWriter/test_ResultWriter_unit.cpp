@@ -0,0 +1,81 @@
+#include "ResultWriter.hpp"
+#include "catch.hpp"
+#include <cstdio>
+#include <fstream>
+#include <omp.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// reads all lines of the file
+static std::vector<std::string> read_lines(const std::string &file_name) {
+  std::ifstream file(file_name);
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(file, line)) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+TEST_CASE("The result writer produces a sorted file", "[ResultWriter]") {
+  std::string file_name = "test_ResultWriter.csv";
+  int steps = 200;
+  {
+    ResultWriter writer(file_name, steps, std::chrono::milliseconds(0));
+#pragma omp parallel for schedule(dynamic) num_threads(4)
+    for (int i = steps - 1; i >= 0; i--) {
+      writer.push(i, std::to_string(i) + "," + std::to_string(2 * i));
+    }
+    writer.close();
+  }
+
+  std::vector<std::string> lines = read_lines(file_name);
+  REQUIRE(lines.size() == size_t(steps));
+  for (int i = 0; i < steps; i++) {
+    REQUIRE(lines[i] == std::to_string(i) + "," + std::to_string(2 * i));
+  }
+  std::remove(file_name.c_str());
+}
+
+TEST_CASE("The result writer appends results before it is closed",
+          "[ResultWriter]") {
+  std::string file_name = "test_ResultWriter_stream.csv";
+  ResultWriter writer(file_name, 3, std::chrono::milliseconds(0));
+  writer.push(2, "2,4");
+  writer.push(0, "0,0");
+
+  // the lines are appended in the order in which they are pushed
+  std::vector<std::string> lines;
+  for (int wait = 0; wait < 500 && lines.size() < 2; wait++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    lines = read_lines(file_name);
+  }
+  REQUIRE(lines == std::vector<std::string>({"2,4", "0,0"}));
+
+  writer.push(1, "1,2");
+  writer.close();
+  REQUIRE(read_lines(file_name) ==
+          std::vector<std::string>({"0,0", "1,2", "2,4"}));
+  std::remove(file_name.c_str());
+}
+
+TEST_CASE("The result writer flushes a single line after the interval",
+          "[ResultWriter]") {
+  std::string file_name = "test_ResultWriter_flush.csv";
+  ResultWriter writer(file_name, 2, std::chrono::milliseconds(100));
+  writer.push(0, "0,0");
+
+  // the line is flushed without a second push once the interval has elapsed
+  std::vector<std::string> lines;
+  for (int wait = 0; wait < 500 && lines.empty(); wait++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    lines = read_lines(file_name);
+  }
+  REQUIRE(lines == std::vector<std::string>({"0,0"}));
+
+  writer.push(1, "1,2");
+  writer.close();
+  REQUIRE(read_lines(file_name) == std::vector<std::string>({"0,0", "1,2"}));
+  std::remove(file_name.c_str());
+}